@@ -0,0 +1,56 @@
+#include "bench_util.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <atomic>
+#include <new>
+
+static std::atomic<uint64_t> allocCalls{0};
+static std::atomic<uint64_t> allocBytes{0};
+
+static void *countedAlloc(size_t n) {
+    allocCalls.fetch_add(1, std::memory_order_relaxed);
+    allocBytes.fetch_add(n, std::memory_order_relaxed);
+    return malloc(n ? n : 1);
+}
+
+void *operator new(size_t n) {
+    void *p = countedAlloc(n);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+void *operator new[](size_t n) {
+    void *p = countedAlloc(n);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+void *operator new(size_t n, const std::nothrow_t &) noexcept { return countedAlloc(n); }
+void *operator new[](size_t n, const std::nothrow_t &) noexcept { return countedAlloc(n); }
+void operator delete(void *p) noexcept { free(p); }
+void operator delete[](void *p) noexcept { free(p); }
+void operator delete(void *p, size_t) noexcept { free(p); }
+void operator delete[](void *p, size_t) noexcept { free(p); }
+
+AllocCount BENCH_allocs() {
+    return {allocCalls.load(std::memory_order_relaxed), allocBytes.load(std::memory_order_relaxed)};
+}
+
+void StageTimer::header() {
+    printf("%-16s %8s %9s %8s %8s %9s %9s %10s\n",
+        "etapa", "chamadas", "média_us", "p50_us", "p99_us", "máx_us", "aloc/cham", "bytes/cham");
+}
+
+double StageTimer::meanUs() const {
+    double sum = 0;
+    for (double v : us_) sum += v;
+    return us_.empty() ? 0 : sum / us_.size();
+}
+
+void StageTimer::report() {
+    if (us_.empty()) return;
+    std::vector<double> s = us_;
+    std::sort(s.begin(), s.end());
+    const double n = (double)s.size();
+    printf("%-16s %8zu %9.2f %8.2f %8.2f %9.2f %9.2f %10.1f\n", name_, s.size(), meanUs(),
+        s[s.size() / 2], s[(s.size() * 99) / 100], s.back(), allocs_ / n, bytes_ / n);
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <chrono>
+#include <vector>
+
+/**
+ * Medição das bancadas de host: latência por chamada no relógio real do PC
+ * (não no simulado) e contagem de alocações (operator new) por etapa.
+ */
+
+/** Alocações e bytes pedidos ao operator new desde o início do processo. */
+struct AllocCount {
+    uint64_t calls;
+    uint64_t bytes;
+};
+AllocCount BENCH_allocs();
+
+/**
+ * Latências de uma etapa. Cada medida vai de begin() a end(), descontados
+ * os intervalos entre pause() e resume().
+ */
+class StageTimer {
+public:
+    explicit StageTimer(const char *name) : name_(name) {}
+
+    void begin() {
+        pendingUs_ = 0;
+        resume();
+    }
+    void end() {
+        pause();
+        us_.push_back(pendingUs_);
+    }
+
+    /** Trechos de uma mesma medida separados por espera (p.ex. consultas ao ADC). */
+    void pause() {
+        auto t1 = std::chrono::steady_clock::now();
+        AllocCount a1 = BENCH_allocs();
+        pendingUs_ += std::chrono::duration<double, std::micro>(t1 - t0_).count();
+        allocs_ += a1.calls - a0_.calls;
+        bytes_ += a1.bytes - a0_.bytes;
+    }
+    void resume() {
+        a0_ = BENCH_allocs();
+        t0_ = std::chrono::steady_clock::now();
+    }
+
+    /** Linha da tabela: chamadas, média, p50, p99, máx (µs) e alocações por chamada. */
+    void report();
+
+    /** Cabeçalho da tabela de report(). */
+    static void header();
+
+    double meanUs() const;
+
+private:
+    const char *name_;
+    std::vector<double> us_;
+    uint64_t allocs_ = 0;
+    uint64_t bytes_ = 0;
+    double pendingUs_ = 0;
+    AllocCount a0_{};
+    std::chrono::steady_clock::time_point t0_;
+};
+
+/** Impede o compilador de descartar um resultado só usado na medição. */
+template <typename T>
+inline void BENCH_keep(const T &v) {
+    asm volatile("" : : "g"(&v) : "memory");
+}
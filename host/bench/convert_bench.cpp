@@ -0,0 +1,154 @@
+// Conversão contagens -> mV e mV -> SoC: caminho inteiro atual (Q16 e tabela
+// OCV) contra o caminho antigo em float (avg * LSB * kDiv e SoC linear entre
+// 3,2 e 4,2 V), em exatidão e em custo por chamada.
+//
+//   convert_bench [-n repetições] [--quick]
+//
+// Exatidão contra a conta em double em toda a faixa do ADC; falha (saída 1)
+// se o Q16 errar mais de 0,75 mV, ou se a tabela OCV se afastar mais de 1% da
+// interpolação exata dos pontos da curva. Os tempos são do PC: o ESP32-S3 tem
+// FPU de precisão simples, então a comparação indica a ordem de grandeza.
+#include <Arduino.h>
+#include <math.h>
+#include <random>
+#include "ads_driver.h"
+#include "ocv_table.h"
+#include "bench_util.h"
+#include "../tests/check.h"
+#include "../tests/capture.h"
+
+static constexpr int32_t ADC_MAX_Q4 = 32767 * 16;
+
+// Caminho antigo (até o Q16): média em float e conversão direta.
+static uint16_t floatMv(int32_t q4, float kDiv) {
+    float avg = (float)q4 / 16.0f;
+    return (uint16_t)(avg * ADS_LSB_MV * kDiv);
+}
+
+static uint8_t linearSoc(uint16_t mv) {
+    float soc = ((float)mv - 3200.0f) * 100.0f / (4200.0f - 3200.0f);
+    return (uint8_t)fmaxf(0.0f, fminf(100.0f, soc));
+}
+
+// Interpolação exata entre os pontos da química ativa.
+static double exactSoc(double mv) {
+    const auto &p = OcvActive::points;
+    const size_t n = sizeof(p) / sizeof(p[0]);
+    if (mv <= p[0].mv) return p[0].soc;
+    if (mv >= p[n - 1].mv) return p[n - 1].soc;
+    size_t i = 0;
+    while (mv > p[i + 1].mv) i++;
+    return p[i].soc + (p[i + 1].soc - p[i].soc) * (mv - p[i].mv) / (double)(p[i + 1].mv - p[i].mv);
+}
+
+static void accuracyMv() {
+    printf("contagens -> mV, toda a faixa (Q4 0..%d), erro contra a conta em double:\n", ADC_MAX_Q4);
+    printf("%-8s %12s %12s %14s\n", "kDiv", "Q16 máx_mV", "float máx_mV", "Q16 != float");
+    const float kDivs[] = {PACK_defaultKDiv(0), PACK_defaultKDiv(1), PACK_defaultKDiv(2), PACK_defaultKDiv(3), 1.0f, 2.5f};
+    for (float k : kDivs) {
+        const int32_t q16 = ADS_scaleQ16(k);
+        double maxQ = 0, maxF = 0;
+        uint32_t differ = 0;
+        for (int32_t q4 = 0; q4 <= ADC_MAX_Q4; q4++) {
+            const double exact = q4 / 16.0 * (double)ADS_LSB_MV * (double)k;
+            if (exact >= UINT16_MAX) break;
+            const uint16_t a = ADS_q4ToMv(q4, q16), b = floatMv(q4, k);
+            maxQ = fmax(maxQ, fabs(a - exact));
+            maxF = fmax(maxF, fabs(b - exact));
+            if (a != b) differ++;
+        }
+        printf("%-8.3f %12.3f %12.3f %13.3f%%\n", k, maxQ, maxF, 100.0 * differ / (ADC_MAX_Q4 + 1));
+        // Meio mV do arredondamento + até 32767 x meio LSB de Q16 do fator.
+        CHECKF(maxQ <= 0.75, "kDiv %.3f: erro máximo %.3f mV", k, maxQ);
+    }
+}
+
+static void accuracySoc() {
+    static constexpr OcvTable<OcvActive> ocv{};
+    double maxTable = 0, maxLinear = 0, sumLinear = 0;
+    uint32_t n = 0;
+    for (uint32_t mv = 3000; mv <= 4300; mv++) {
+        const double exact = exactSoc(mv);
+        maxTable = fmax(maxTable, fabs(ocv.soc(mv) - exact));
+        maxLinear = fmax(maxLinear, fabs(linearSoc(mv) - exact));
+        sumLinear += fabs(linearSoc(mv) - exact);
+        n++;
+    }
+    printf("\nmV -> SoC, 3000..4300 mV contra a curva OCV exata: tabela máx %.2f%%, linear máx %.1f%% (média %.1f%%)\n",
+        maxTable, maxLinear, sumLinear / n);
+    CHECKF(maxTable <= 1.0, "tabela OCV: erro máximo %.2f%%", maxTable);
+
+    // Na captura real (o CSV traz o SoC linear do firmware antigo).
+    std::vector<CellSample> cap;
+    if (!CAP_load("logs_experimento2.csv", cap)) return;
+    double maxDiff = 0, sumDiff = 0;
+    uint32_t cells = 0, csvMismatch = 0;
+    for (const CellSample &s : cap) {
+        for (uint8_t i = 0; i < PACK_CELLS; i++) {
+            const double d = fabs((double)ocv.soc(s.mv[i]) - linearSoc(s.mv[i]));
+            maxDiff = fmax(maxDiff, d);
+            sumDiff += d;
+            if (abs((int)linearSoc(s.mv[i]) - (int)s.soc[i]) > 1) csvMismatch++;
+            cells++;
+        }
+    }
+    printf("experimento2: SoC OCV - SoC linear: média %.1f%%, máx %.0f%% (%u leituras; %u com o SoC do CSV diferente do linear)\n",
+        sumDiff / cells, maxDiff, cells, csvMismatch);
+}
+
+static void timing(uint32_t reps) {
+    std::mt19937 rng(5);
+    std::vector<int32_t> q4(4096);
+    std::vector<uint16_t> mv(4096);
+    for (size_t i = 0; i < q4.size(); i++) {
+        q4[i] = 16 * 19000 + (int32_t)(rng() % 4096);
+        mv[i] = (uint16_t)(3300 + rng() % 900);
+    }
+    const float k = PACK_defaultKDiv(2);
+    const int32_t q16 = ADS_scaleQ16(k);
+    static constexpr OcvTable<OcvActive> ocv{};
+
+    StageTimer tF("mv_float"), tQ("mv_q16"), tL("soc_linear"), tO("soc_ocv");
+    uint32_t acc = 0;
+    for (uint32_t r = 0; r < reps; r++) {
+        tF.begin();
+        for (int32_t v : q4) acc += floatMv(v, k);
+        tF.end();
+        tQ.begin();
+        for (int32_t v : q4) acc += ADS_q4ToMv(v, q16);
+        tQ.end();
+        tL.begin();
+        for (uint16_t v : mv) acc += linearSoc(v);
+        tL.end();
+        tO.begin();
+        for (uint16_t v : mv) acc += ocv.soc(v);
+        tO.end();
+    }
+    BENCH_keep(acc);
+    printf("\ncusto por lote de %zu conversões (µs):\n", q4.size());
+    StageTimer::header();
+    tF.report();
+    tQ.report();
+    tL.report();
+    tO.report();
+    printf("por conversão: float %.2f ns, Q16 %.2f ns, SoC linear %.2f ns, SoC OCV %.2f ns\n",
+        tF.meanUs() * 1000 / q4.size(), tQ.meanUs() * 1000 / q4.size(),
+        tL.meanUs() * 1000 / mv.size(), tO.meanUs() * 1000 / mv.size());
+}
+
+int main(int argc, char **argv) {
+    uint32_t reps = 2000;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--quick")) reps = 50;
+        else if (!strcmp(argv[i], "-n") && i + 1 < argc) reps = strtoul(argv[++i], nullptr, 10);
+        else {
+            fprintf(stderr, "uso: %s [-n repetições] [--quick]\n", argv[0]);
+            return 2;
+        }
+    }
+    FAKE_serialQuiet(true);
+    accuracyMv();
+    accuracySoc();
+    timing(reps ? reps : 1);
+    return CHECK_EXIT();
+}
@@ -0,0 +1,144 @@
+// Filtros do oversampling sobre dados reproduzidos: custo por chamada e
+// quanto cada um reduz o ruído, por número de leituras por canal.
+//
+//   filter_bench [--noise sigma] [--corrupt por_mil] [--passes N] [--quick]
+//
+// As tensões da captura logs_experimento2.csv são a verdade: cada linha vira
+// a tensão no pino de cada canal (tap / kDiv), e as leituras do ADC recebem
+// ruído gaussiano de 'sigma' contagens e, por mil, leituras saturadas em
+// 0x7FFF. O erro é a diferença entre a tensão do tap filtrada e a verdadeira,
+// então o atraso do IIR nas mudanças reais da captura também conta.
+#include <Arduino.h>
+#include <math.h>
+#include <random>
+#include <algorithm>
+#include <array>
+#include "ads_driver.h"
+#include "filter.h"
+#include "bench_util.h"
+#include "../tests/check.h"
+#include "../tests/capture.h"
+
+static constexpr uint8_t IIR_SHIFT = ADS_DEFAULT_PROFILE.iirShift;
+
+struct Options {
+    double   sigma = 3.0;
+    uint16_t corruptPermille = 5;
+    uint32_t passes = 10;
+};
+
+struct Result {
+    double rms;
+    double p99;
+    double max;
+    double nsPerCall;
+};
+
+// Tensões absolutas (taps) de cada linha.
+static std::vector<std::array<double, PACK_CELLS>> taps(const std::vector<CellSample> &cap) {
+    std::vector<std::array<double, PACK_CELLS>> out;
+    for (const CellSample &s : cap) {
+        std::array<double, PACK_CELLS> t;
+        double acc = 0;
+        for (uint8_t i = 0; i < PACK_CELLS; i++) t[i] = acc += s.mv[i];
+        out.push_back(t);
+    }
+    return out;
+}
+
+static Result run(const std::vector<std::array<double, PACK_CELLS>> &truth, FilterType type, uint8_t n,
+                  const Options &o) {
+    std::mt19937 rng(1234);   // A mesma sequência de ruído para todos os filtros
+    std::normal_distribution<double> noise(0.0, o.sigma);
+    std::uniform_int_distribution<int> permille(0, 999);
+    int32_t scale[PACK_CELLS], iir[PACK_CELLS];
+    float kDiv[PACK_CELLS];
+    for (uint8_t i = 0; i < PACK_CELLS; i++) {
+        kDiv[i] = PACK_defaultKDiv(i);
+        scale[i] = ADS_scaleQ16(kDiv[i]);
+        iir[i] = INT32_MIN;
+    }
+
+    std::vector<double> err;
+    err.reserve(truth.size() * PACK_CELLS * o.passes);
+    StageTimer t("filtro");
+    int16_t v[FILTER_MAX_SAMPLES];
+    for (uint32_t pass = 0; pass < o.passes; pass++) {
+        for (const auto &row : truth) {
+            for (uint8_t c = 0; c < PACK_CELLS; c++) {
+                const double counts = row[c] / kDiv[c] / ADS_LSB_MV;
+                for (uint8_t k = 0; k < n; k++) {
+                    long r = lround(counts + noise(rng));
+                    if (permille(rng) < o.corruptPermille) r = 0x7FFF;
+                    v[k] = (int16_t)std::min(32767L, std::max(-32768L, r));
+                }
+                t.begin();
+                int32_t q4 = FLT_apply(type, v, n);
+                if (type == FILTER_IIR) q4 = FLT_iir(iir[c], q4, IIR_SHIFT);
+                t.end();
+                err.push_back((double)ADS_q4ToMv(q4, scale[c]) - row[c]);
+            }
+        }
+    }
+    double sq = 0;
+    for (double e : err) sq += e * e;
+    std::vector<double> a(err.size());
+    std::transform(err.begin(), err.end(), a.begin(), [](double e) { return fabs(e); });
+    std::sort(a.begin(), a.end());
+    return {sqrt(sq / err.size()), a[a.size() * 99 / 100], a.back(), t.meanUs() * 1000.0};
+}
+
+int main(int argc, char **argv) {
+    Options o;
+    for (int i = 1; i < argc; i++) {
+        const bool hasValue = i + 1 < argc;
+        if (!strcmp(argv[i], "--quick")) o.passes = 1;
+        else if (!strcmp(argv[i], "--noise") && hasValue) o.sigma = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--corrupt") && hasValue) o.corruptPermille = (uint16_t)atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--passes") && hasValue) o.passes = strtoul(argv[++i], nullptr, 10);
+        else {
+            fprintf(stderr, "uso: %s [--noise sigma] [--corrupt por_mil] [--passes N] [--quick]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (!o.passes) o.passes = 1;
+    FAKE_serialQuiet(true);
+
+    std::vector<CellSample> cap;
+    if (!CAP_load("logs_experimento2.csv", cap)) {
+        fprintf(stderr, "captura não encontrada em %s\n", HOST_LOGS_DIR);
+        return 1;
+    }
+    const auto truth = taps(cap);
+    printf("%zu linhas x %u passadas, ruído σ=%.1f contagens, %u/1000 leituras saturadas; erro no tap (mV)\n",
+        truth.size(), (unsigned)o.passes, o.sigma, (unsigned)o.corruptPermille);
+    printf("%-8s %3s %9s %9s %9s %11s %10s\n", "filtro", "N", "rms", "p99", "máx", "redução", "ns/chamada");
+
+    const FilterType types[] = {FILTER_MEAN, FILTER_MEDIAN, FILTER_TRIMMED, FILTER_IIR};
+    const uint8_t sizes[] = {1, 4, 8, 16, 32};
+    // Referência da redução: uma leitura por canal, sem filtro.
+    const Result base = run(truth, FILTER_MEAN, 1, o);
+    Result mean8 = {}, median8 = {}, trimmed8 = {};
+    for (FilterType type : types) {
+        for (uint8_t n : sizes) {
+            const Result r = run(truth, type, n, o);
+            printf("%-8s %3u %9.2f %9.2f %9.1f %10.1fx %10.1f\n", FLT_name(type), (unsigned)n, r.rms, r.p99,
+                r.max, base.rms / r.rms, r.nsPerCall);
+            if (n == 8 && type == FILTER_MEAN) mean8 = r;
+            if (n == 8 && type == FILTER_MEDIAN) median8 = r;
+            if (n == 8 && type == FILTER_TRIMMED) trimmed8 = r;
+        }
+    }
+
+    // Propriedades que a escolha do perfil assume (filter.h).
+    if (o.corruptPermille == 0) {
+        // Só ruído gaussiano: a média de 8 reduz o rms em ~sqrt(8).
+        CHECKF(base.rms / mean8.rms > 2.0, "média de 8: redução %.1fx", base.rms / mean8.rms);
+    } else {
+        // Leituras saturadas isoladas: a mediana e a média aparada as rejeitam, a média não.
+        CHECKF(median8.max < mean8.max / 10, "mediana máx %.1f mV, média máx %.1f mV", median8.max, mean8.max);
+        CHECKF(trimmed8.max < mean8.max / 10, "aparada máx %.1f mV, média máx %.1f mV", trimmed8.max, mean8.max);
+        CHECKF(median8.rms < base.rms, "mediana de 8: rms %.2f mV", median8.rms);
+    }
+    return CHECK_EXIT();
+}
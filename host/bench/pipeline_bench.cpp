@@ -0,0 +1,168 @@
+// Bancada do caminho amostra -> log -> broadcast no PC, com os módulos do
+// firmware sobre o ADS1115 simulado e a SPIFFS num diretório temporário.
+//
+//   pipeline_bench [-n iterações] [--noise contagens] [--corrupt por_mil]
+//                  [--stall por_mil] [--os leituras] [--quick]
+//
+// Para cada etapa: latência por chamada (relógio real do PC) e alocações por
+// chamada. O tempo de conversão do ADC não entra em ads_sample: o relógio
+// simulado avança entre as consultas, como o vTaskDelay(1) da tarefa de
+// aquisição, e ads_sample soma só o custo de CPU do driver numa aquisição.
+#include <Arduino.h>
+#include <SPIFFS.h>
+#include "ads_driver.h"
+#include "storage.h"
+#include "recent.h"
+#include "ws_frame.h"
+#include "bench_util.h"
+#if HOST_HAVE_CONFIG
+#include "config.h"
+#endif
+
+static constexpr uint32_t POLL_STEP_US = 1000;   // vTaskDelay(1) entre consultas da tarefa
+static constexpr uint16_t WS_BATCH = 16;         // Como em net.cpp
+
+struct Options {
+    uint32_t iterations = 2000;
+    FakeAdsConfig ads = {2, 5, 0, 10, 1};
+    uint8_t oversample = ADS_DEFAULT_PROFILE.oversample;
+};
+
+static bool parseArgs(int argc, char **argv, Options &o) {
+    for (int i = 1; i < argc; i++) {
+        const char *a = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (!strcmp(a, "--quick")) o.iterations = 200;
+        else if (!strcmp(a, "-n") && hasValue) o.iterations = strtoul(argv[++i], nullptr, 10);
+        else if (!strcmp(a, "--noise") && hasValue) o.ads.noiseCounts = (uint8_t)atoi(argv[++i]);
+        else if (!strcmp(a, "--corrupt") && hasValue) o.ads.corruptPermille = (uint16_t)atoi(argv[++i]);
+        else if (!strcmp(a, "--stall") && hasValue) o.ads.stallPermille = (uint16_t)atoi(argv[++i]);
+        else if (!strcmp(a, "--os") && hasValue) o.oversample = (uint8_t)atoi(argv[++i]);
+        else {
+            fprintf(stderr, "uso: %s [-n N] [--noise C] [--corrupt P] [--stall P] [--os N] [--quick]\n", argv[0]);
+            return false;
+        }
+    }
+    if (!o.iterations) o.iterations = 1;
+    return true;
+}
+
+int main(int argc, char **argv) {
+    Options o;
+    if (!parseArgs(argc, argv, o)) return 2;
+
+    FAKE_serialQuiet(true);
+    SPIFFS.begin(true);
+    FAKE_adsConfigure(o.ads);
+    float kDiv[PACK_CELLS];
+    uint16_t cellMv[PACK_CELLS];
+    for (uint8_t i = 0; i < PACK_CELLS; i++) {
+        kDiv[i] = PACK_defaultKDiv(i);
+        cellMv[i] = 3900 + 7 * i;
+    }
+    FAKE_adsSetPack(cellMv, kDiv, PACK_CELLS);
+
+    AdsProfile profile = ADS_DEFAULT_PROFILE;
+    profile.oversample = o.oversample;
+    if (!ADS_init() || !FS_init() || !REC_init(REC_DEFAULT_DEPTH)) {
+        fprintf(stderr, "falha ao inicializar os módulos\n");
+        return 1;
+    }
+    ADS_setKDiv(kDiv);
+    ADS_setProfile(profile);
+    FS_setPolicy(LOG_DEFAULT_POLICY);
+
+    StageTimer tAds("ads_sample"), tFs("fs_append"), tRec("rec_add"), tBin("ws_encode_bin"), tJson("ws_encode_json");
+    uint32_t errors = 0, polls = 0;
+    uint64_t simUs = 0;
+    static uint8_t frame[WSF_binarySize(WS_BATCH)];
+    char json[WS_JSON_MAX];
+    CellSample batch[WS_BATCH];
+
+    for (uint32_t i = 0; i < o.iterations; i++) {
+        // Descarga lenta: 1 mV a cada 20 amostras em todas as células.
+        if (i % 20 == 0) {
+            for (uint16_t &mv : cellMv) mv--;
+            FAKE_adsSetPack(cellMv, kDiv, PACK_CELLS);
+        }
+
+        CellSample s;
+        AdsStatus st;
+        const uint64_t sim0 = FAKE_nowUs();
+        tAds.begin();
+        ADS_startSample();
+        do {
+            tAds.pause();
+            FAKE_advanceUs(POLL_STEP_US);
+            tAds.resume();
+            st = ADS_poll(s);
+            polls++;
+        } while (st == ADS_BUSY);
+        tAds.end();
+        simUs += FAKE_nowUs() - sim0;
+        if (st != ADS_READY) {
+            errors++;
+            continue;
+        }
+
+        tFs.begin();
+        FS_append(s);
+        tFs.end();
+
+        tRec.begin();
+        REC_add(s);
+        tRec.end();
+
+        // O mesmo trabalho de NET_tick() para um cliente binário e um JSON.
+        tBin.begin();
+        uint32_t seq = REC_seq();
+        uint32_t from = seq > WS_BATCH ? seq - WS_BATCH : 0;
+        size_t n = REC_read(from, batch, WS_BATCH);
+        WSF_putHeader(frame, WS_FRAME_LIVE, (uint16_t)n);
+        size_t len = sizeof(WsFrameHeader) + WSF_putSamples(frame + sizeof(WsFrameHeader), batch, n);
+        tBin.end();
+        BENCH_keep(len);
+
+        tJson.begin();
+        len = WSF_json(json, sizeof(json), s);
+        tJson.end();
+        BENCH_keep(len);
+    }
+    FS_sync();
+
+#if HOST_HAVE_CONFIG
+    StageTimer tCfg("cfg_load");
+    Calib c = CFG_defaultCalib();
+    CFG_save(c);
+    for (uint32_t i = 0; i < o.iterations && i < 200; i++) {
+        tCfg.begin();
+        CFG_load(c);
+        tCfg.end();
+    }
+#endif
+
+    FsStats fs;
+    FS_getStats(fs);
+    FakeAdsStats as;
+    FAKE_adsStats(as);
+    const uint32_t samples = o.iterations - errors;
+
+    printf("%u aquisições (%u leituras/canal, ruído ±%u, %u/1000 corrompidas, %u/1000 travadas), SPIFFS em %s\n",
+        (unsigned)o.iterations, (unsigned)o.oversample, (unsigned)o.ads.noiseCounts,
+        (unsigned)o.ads.corruptPermille, (unsigned)o.ads.stallPermille, FAKE_spiffsDir());
+    StageTimer::header();
+    tAds.report();
+    tFs.report();
+    tRec.report();
+    tBin.report();
+    tJson.report();
+#if HOST_HAVE_CONFIG
+    tCfg.report();
+#endif
+    printf("\nADC: %u erros, %.1f consultas por aquisição, %.1f ms simulados por aquisição, %u conversões travadas\n",
+        (unsigned)errors, (double)polls / o.iterations, simUs / 1000.0 / o.iterations, (unsigned)as.stalls);
+    printf("log: %u amostras -> %u bytes gravados em %u lotes (%.2f bytes/amostra)\n",
+        (unsigned)samples, (unsigned)fs.bytesWritten, (unsigned)fs.flushes,
+        samples ? (double)fs.bytesWritten / samples : 0.0);
+    return 0;
+}
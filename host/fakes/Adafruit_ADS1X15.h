@@ -0,0 +1,110 @@
+#pragma once
+#include <Arduino.h>
+#include <Wire.h>
+
+/**
+ * ADS1115 simulado para o build de host, com a mesma interface da
+ * Adafruit_ADS1X15 que o driver usa.
+ *
+ * Cada chip (endereço 0x48..0x4B) tem uma tensão por canal, definida pelo
+ * teste. Uma conversão single-shot leva 1/taxa segundos no relógio simulado
+ * (com o desvio do oscilador interno, até ±latencyJitterPct) e só então
+ * conversionComplete() fica verdadeiro, como o bit OS do chip. A leitura
+ * recebe ruído uniforme de ±noiseCounts contagens; uma fração das conversões
+ * sai corrompida (saturada em 0x7FFF) e outra nunca termina (o driver tem de
+ * detectar o timeout e reinicializar o barramento).
+ */
+
+typedef enum { GAIN_TWOTHIRDS = 0x0000, GAIN_ONE = 0x0200, GAIN_TWO = 0x0400 } adsGain_t;
+
+#define RATE_ADS1115_8SPS   (0x0000)
+#define RATE_ADS1115_16SPS  (0x0020)
+#define RATE_ADS1115_32SPS  (0x0040)
+#define RATE_ADS1115_64SPS  (0x0060)
+#define RATE_ADS1115_128SPS (0x0080)
+#define RATE_ADS1115_250SPS (0x00A0)
+#define RATE_ADS1115_475SPS (0x00C0)
+#define RATE_ADS1115_860SPS (0x00E0)
+
+#define ADS1X15_REG_CONFIG_MUX_SINGLE_0 (0x4000)
+#define ADS1X15_REG_CONFIG_MUX_SINGLE_1 (0x5000)
+#define ADS1X15_REG_CONFIG_MUX_SINGLE_2 (0x6000)
+#define ADS1X15_REG_CONFIG_MUX_SINGLE_3 (0x7000)
+
+class Adafruit_ADS1115 {
+public:
+    bool begin(uint8_t addr = 0x48, TwoWire *wire = &Wire);
+    void setGain(adsGain_t gain) { (void)gain; }
+    void setDataRate(uint16_t rate);
+    void startADCReading(uint16_t mux, bool continuous);
+    bool conversionComplete();
+    int16_t getLastConversionResults();
+    int16_t readADC_SingleEnded(uint8_t channel);
+
+private:
+    uint8_t  addr_ = 0;
+    uint16_t sps_ = 128;
+    uint8_t  ch_ = 0;
+    uint64_t doneAtUs_ = 0;
+    bool     stalled_ = false;
+    bool     converting_ = false;
+    int16_t  result_ = 0;
+};
+
+/**
+ * Comportamento do ADC simulado (vale para todos os chips).
+ */
+struct FakeAdsConfig {
+    uint8_t  noiseCounts;        // Ruído uniforme ±contagens em cada leitura
+    uint16_t corruptPermille;    // Conversões que saem saturadas (0x7FFF), por mil
+    uint16_t stallPermille;      // Conversões que nunca terminam, por mil
+    uint8_t  latencyJitterPct;   // Desvio da duração da conversão (oscilador interno: ±10% no datasheet)
+    uint32_t seed;
+};
+
+static constexpr FakeAdsConfig FAKE_ADS_DEFAULT = {0, 0, 0, 0, 1};
+
+/**
+ * Contadores do ADC simulado, para verificar o uso do barramento.
+ */
+struct FakeAdsStats {
+    uint32_t conversions;    // Conversões disparadas
+    uint32_t statusReads;    // Consultas ao bit OS (conversionComplete)
+    uint32_t earlyReads;     // Consultas feitas antes do fim da conversão
+    uint32_t resultReads;    // Leituras do registrador de conversão
+    uint32_t stalls;         // Conversões que travaram
+    uint32_t corrupted;      // Leituras corrompidas
+    uint32_t begins;         // Inicializações (begin) de algum chip
+};
+
+/** Aplica o comportamento e zera os contadores. */
+void FAKE_adsConfigure(const FakeAdsConfig &cfg);
+
+/** Zera os contadores. */
+void FAKE_adsResetStats();
+
+/** Lê os contadores. */
+void FAKE_adsStats(FakeAdsStats &st);
+
+/**
+ * Marca um chip como presente ou ausente no barramento (todos presentes por padrão).
+ */
+void FAKE_adsSetPresent(uint8_t addr, bool present);
+
+/**
+ * Tensão no pino de entrada de um canal.
+ * @param addr Endereço do chip (0x48..0x4B).
+ * @param ch Canal (0..3).
+ * @param mv Tensão em mV (escala de ±6,144 V: 0,1875 mV por contagem).
+ */
+void FAKE_adsSetPinMv(uint8_t addr, uint8_t ch, float mv);
+
+/**
+ * Monta as tensões nos pinos a partir das células do pack, como na placa:
+ * o tap da célula i (soma das células 0..i) passa pelo divisor kDiv[i] e vai
+ * ao canal i % 4 do chip 0x48 + i / 4.
+ * @param cellMv Tensão de cada célula em mV.
+ * @param kDiv Fator de divisão de cada tap.
+ * @param cells Número de células.
+ */
+void FAKE_adsSetPack(const uint16_t *cellMv, const float *kDiv, uint8_t cells);
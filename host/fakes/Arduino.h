@@ -0,0 +1,132 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <algorithm>
+#include <string>
+#include "fake_clock.h"
+
+/**
+ * Subconjunto do core Arduino-ESP32 usado pelos módulos de main/, para o
+ * build de host (host/CMakeLists.txt): tempo pelo relógio simulado
+ * (fake_clock.h), Serial no stdout, String mínima e as primitivas do FreeRTOS
+ * que os módulos usam (mutexes e atrasos). Não há tarefas: os testes que
+ * precisam de concorrência usam std::thread direto.
+ */
+
+#define IRAM_ATTR
+#define INPUT_PULLUP 0x05
+#define FALLING 0x02
+
+using std::min;
+using std::max;
+
+inline uint32_t millis() { return (uint32_t)(FAKE_nowUs() / 1000); }
+inline uint32_t micros() { return (uint32_t)FAKE_nowUs(); }
+inline void delay(uint32_t ms) { FAKE_advanceUs((uint64_t)ms * 1000); }
+inline void delayMicroseconds(uint32_t us) { FAKE_advanceUs(us); }
+void yield();
+
+inline void pinMode(uint8_t, uint8_t) {}
+inline int digitalPinToInterrupt(int pin) { return pin; }
+inline void attachInterrupt(int, void (*)(), int) {}
+
+class String {
+public:
+    String() = default;
+    String(const char *s) : s_(s ? s : "") {}
+    String(const std::string &s) : s_(s) {}
+    const char *c_str() const { return s_.c_str(); }
+    size_t length() const { return s_.size(); }
+    String &operator+=(char c) { s_ += c; return *this; }
+    String &operator+=(const char *s) { s_ += s; return *this; }
+    bool operator==(const char *s) const { return s_ == s; }
+private:
+    std::string s_;
+};
+
+class Print {
+public:
+    virtual ~Print() = default;
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t *buf, size_t len) {
+        size_t n = 0;
+        while (n < len && write(buf[n])) n++;
+        return n;
+    }
+    size_t write(const char *s) { return write((const uint8_t *)s, strlen(s)); }
+
+    size_t printf(const char *fmt, ...) __attribute__((format(printf, 2, 3))) {
+        char buf[256];
+        va_list ap;
+        va_start(ap, fmt);
+        int n = vsnprintf(buf, sizeof(buf), fmt, ap);
+        va_end(ap);
+        if (n < 0) return 0;
+        if ((size_t)n < sizeof(buf)) return write((const uint8_t *)buf, n);
+        std::string big(n + 1, '\0');
+        va_start(ap, fmt);
+        vsnprintf(&big[0], big.size(), fmt, ap);
+        va_end(ap);
+        return write((const uint8_t *)big.data(), n);
+    }
+    size_t print(const char *s) { return write(s); }
+    size_t print(const String &s) { return write(s.c_str()); }
+    size_t print(long v) { return printf("%ld", v); }
+    size_t print(unsigned long v) { return printf("%lu", v); }
+    size_t print(int v) { return printf("%d", v); }
+    size_t print(unsigned v) { return printf("%u", v); }
+    size_t print(double v) { return printf("%.2f", v); }
+    size_t println() { return write("\n"); }
+    template <typename T> size_t println(const T &v) { return print(v) + println(); }
+};
+
+/**
+ * Serial do host: escreve no stdout. Os testes e a bancada silenciam os
+ * diagnósticos dos módulos com FAKE_serialQuiet(true).
+ */
+class HardwareSerial : public Print {
+public:
+    void begin(unsigned long) {}
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t *buf, size_t len) override;
+    using Print::write;
+};
+extern HardwareSerial Serial;
+
+/** Liga/desliga a saída de Serial (ligada por padrão). */
+void FAKE_serialQuiet(bool quiet);
+
+struct EspClass {
+    [[noreturn]] void restart();
+};
+extern EspClass ESP;
+
+// --- FreeRTOS (só o que os módulos usam fora das tarefas) ---
+
+typedef int32_t  BaseType_t;
+typedef uint32_t UBaseType_t;
+typedef uint32_t TickType_t;
+struct FakeMutex;
+typedef FakeMutex *SemaphoreHandle_t;
+
+#define pdTRUE  ((BaseType_t)1)
+#define pdFALSE ((BaseType_t)0)
+#define pdPASS  pdTRUE
+#define portMAX_DELAY ((TickType_t)0xFFFFFFFFu)
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+
+SemaphoreHandle_t xSemaphoreCreateMutex();
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutex();
+BaseType_t xSemaphoreTake(SemaphoreHandle_t m, TickType_t ticks);
+BaseType_t xSemaphoreGive(SemaphoreHandle_t m);
+#define xSemaphoreTakeRecursive xSemaphoreTake
+#define xSemaphoreGiveRecursive xSemaphoreGive
+
+/** Um tick = 1 ms: avança o relógio simulado. */
+inline void vTaskDelay(TickType_t ticks) { FAKE_advanceUs((uint64_t)ticks * 1000); }
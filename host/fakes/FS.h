@@ -0,0 +1,50 @@
+#pragma once
+#include <Arduino.h>
+#include <memory>
+
+#define FILE_READ   "r"
+#define FILE_WRITE  "w"
+#define FILE_APPEND "a"
+
+/**
+ * Arquivo da SPIFFS simulada: um arquivo comum no diretório raiz escolhido
+ * com FAKE_spiffsRoot(). Cópias compartilham o mesmo arquivo aberto, como no
+ * core do ESP32.
+ */
+class File {
+public:
+    File() = default;
+    explicit File(FILE *f);
+
+    explicit operator bool() const { return (bool)f_; }
+    size_t write(uint8_t c) { return write(&c, 1); }
+    size_t write(const uint8_t *buf, size_t len);
+    size_t read(uint8_t *buf, size_t len);
+    int read();
+    int available();
+    bool seek(uint32_t pos);
+    size_t position() const;
+    size_t size() const;
+    void flush();
+    void close() { f_.reset(); }
+    String readStringUntil(char term);
+    size_t readBytesUntil(char term, char *buf, size_t len);
+
+private:
+    enum class LastOp : uint8_t { None, Read, Write };
+    void switchTo(LastOp op);
+
+    std::shared_ptr<FILE> f_;
+    std::shared_ptr<LastOp> last_;
+};
+
+class SPIFFSFS {
+public:
+    bool begin(bool formatOnFail = false);
+    File open(const char *path, const char *mode = FILE_READ);
+    File open(const String &path, const char *mode = FILE_READ) { return open(path.c_str(), mode); }
+    bool exists(const char *path);
+    bool exists(const String &path) { return exists(path.c_str()); }
+    bool remove(const char *path);
+    bool rename(const char *from, const char *to);
+};
@@ -0,0 +1,38 @@
+#pragma once
+#include <Arduino.h>
+#include <map>
+
+/**
+ * NVS do host: chaves em memória, compartilhadas por todas as instâncias
+ * (como a partição nvs), perdidas ao fim do processo.
+ */
+class Preferences {
+public:
+    bool begin(const char *ns, bool readOnly = false) {
+        (void)readOnly;
+        ns_ = ns;
+        return true;
+    }
+    void end() {}
+
+    uint32_t getUInt(const char *key, uint32_t def = 0) { return (uint32_t)get(key, def); }
+    size_t putUInt(const char *key, uint32_t v) { return put(key, v, 4); }
+    uint64_t getULong64(const char *key, uint64_t def = 0) { return get(key, def); }
+    size_t putULong64(const char *key, uint64_t v) { return put(key, v, 8); }
+
+private:
+    static std::map<std::string, uint64_t> &store() {
+        static std::map<std::string, uint64_t> s;
+        return s;
+    }
+    uint64_t get(const char *key, uint64_t def) {
+        auto it = store().find(ns_ + "/" + key);
+        return it == store().end() ? def : it->second;
+    }
+    size_t put(const char *key, uint64_t v, size_t len) {
+        store()[ns_ + "/" + key] = v;
+        return len;
+    }
+
+    std::string ns_;
+};
@@ -0,0 +1,22 @@
+#pragma once
+#include "FS.h"
+
+extern SPIFFSFS SPIFFS;
+
+/**
+ * Diretório que faz o papel da partição. Sem chamada, a primeira operação
+ * cria um diretório temporário novo (vazio) em /tmp, apagado na saída do
+ * processo.
+ * @param dir Diretório existente.
+ */
+void FAKE_spiffsRoot(const char *dir);
+
+/** Diretório atual da SPIFFS simulada. */
+const char *FAKE_spiffsDir();
+
+/**
+ * Copia um arquivo do host para a SPIFFS simulada (p.ex. uma captura CSV
+ * para a reprodução).
+ * @return false se a cópia falhou.
+ */
+bool FAKE_spiffsImport(const char *hostPath, const char *spiffsPath);
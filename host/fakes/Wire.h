@@ -0,0 +1,14 @@
+#pragma once
+#include <Arduino.h>
+
+/** Barramento I2C do host: o ADS1115 simulado não passa por ele. */
+class TwoWire {
+public:
+    bool begin(int sda = -1, int scl = -1, uint32_t freq = 0) {
+        (void)sda; (void)scl; (void)freq;
+        begins++;
+        return true;
+    }
+    uint32_t begins = 0;   // Quantas vezes o driver (re)inicializou o barramento
+};
+extern TwoWire Wire;
@@ -0,0 +1,108 @@
+#include <Adafruit_ADS1X15.h>
+
+TwoWire Wire;
+
+static constexpr float LSB_MV = 0.1875f;   // ±6,144 V
+static constexpr uint8_t CHIPS = 4;
+
+static FakeAdsConfig cfg = FAKE_ADS_DEFAULT;
+static FakeAdsStats stats = {};
+static uint32_t lcg = 1;
+static float pinMv[CHIPS][4] = {};
+static bool absent[CHIPS] = {};
+
+static uint32_t rnd() {
+    lcg = lcg * 1664525u + 1013904223u;
+    return lcg >> 8;
+}
+
+static bool chance(uint16_t permille) {
+    return permille && rnd() % 1000 < permille;
+}
+
+void FAKE_adsConfigure(const FakeAdsConfig &c) {
+    cfg = c;
+    lcg = c.seed ? c.seed : 1;
+    FAKE_adsResetStats();
+}
+
+void FAKE_adsResetStats() {
+    stats = {};
+}
+
+void FAKE_adsStats(FakeAdsStats &st) {
+    st = stats;
+}
+
+void FAKE_adsSetPresent(uint8_t addr, bool present) {
+    if (addr >= 0x48 && addr < 0x48 + CHIPS) absent[addr - 0x48] = !present;
+}
+
+void FAKE_adsSetPinMv(uint8_t addr, uint8_t ch, float mv) {
+    if (addr >= 0x48 && addr < 0x48 + CHIPS && ch < 4) pinMv[addr - 0x48][ch] = mv;
+}
+
+void FAKE_adsSetPack(const uint16_t *cellMv, const float *kDiv, uint8_t cells) {
+    uint32_t tap = 0;
+    for (uint8_t i = 0; i < cells && i < 4 * CHIPS; i++) {
+        tap += cellMv[i];
+        FAKE_adsSetPinMv(0x48 + i / 4, i % 4, tap / kDiv[i]);
+    }
+}
+
+bool Adafruit_ADS1115::begin(uint8_t addr, TwoWire *) {
+    if (addr < 0x48 || addr >= 0x48 + CHIPS || absent[addr - 0x48]) return false;
+    addr_ = addr;
+    converting_ = false;
+    stalled_ = false;
+    stats.begins++;
+    return true;
+}
+
+void Adafruit_ADS1115::setDataRate(uint16_t rate) {
+    static const uint16_t kSps[8] = {8, 16, 32, 64, 128, 250, 475, 860};
+    sps_ = kSps[(rate >> 5) & 7];
+}
+
+void Adafruit_ADS1115::startADCReading(uint16_t mux, bool) {
+    ch_ = (mux >> 12) & 3;
+    uint32_t us = 1000000UL / sps_;
+    if (cfg.latencyJitterPct) {
+        int32_t span = (int32_t)(us * cfg.latencyJitterPct / 100);
+        us += (int32_t)(rnd() % (2 * span + 1)) - span;
+    }
+    doneAtUs_ = FAKE_nowUs() + us;
+    converting_ = true;
+    stalled_ = chance(cfg.stallPermille);
+    stats.conversions++;
+    if (stalled_) stats.stalls++;
+
+    float mv = pinMv[addr_ - 0x48][ch_];
+    int32_t counts = (int32_t)lroundf(mv / LSB_MV);
+    if (cfg.noiseCounts) counts += (int32_t)(rnd() % (2 * cfg.noiseCounts + 1)) - cfg.noiseCounts;
+    if (chance(cfg.corruptPermille)) {
+        counts = INT16_MAX;
+        stats.corrupted++;
+    }
+    result_ = (int16_t)(counts > INT16_MAX ? INT16_MAX : counts < INT16_MIN ? INT16_MIN : counts);
+}
+
+bool Adafruit_ADS1115::conversionComplete() {
+    stats.statusReads++;
+    bool done = converting_ && !stalled_ && FAKE_nowUs() >= doneAtUs_;
+    if (!done) stats.earlyReads++;
+    return done;
+}
+
+int16_t Adafruit_ADS1115::getLastConversionResults() {
+    stats.resultReads++;
+    converting_ = false;
+    return result_;
+}
+
+int16_t Adafruit_ADS1115::readADC_SingleEnded(uint8_t channel) {
+    startADCReading(ADS1X15_REG_CONFIG_MUX_SINGLE_0 + ((uint16_t)channel << 12), false);
+    if (stalled_) return 0;
+    if (FAKE_nowUs() < doneAtUs_) FAKE_advanceUs(doneAtUs_ - FAKE_nowUs());
+    return getLastConversionResults();
+}
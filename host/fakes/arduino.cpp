@@ -0,0 +1,56 @@
+#include <Arduino.h>
+#include <esp_timer.h>
+#include <atomic>
+#include <mutex>
+
+// Atômico: o teste da fila SPSC lê o relógio de duas threads.
+static std::atomic<uint64_t> nowUs{0};
+static uint32_t yieldUs = 10;
+static bool quiet = false;
+
+HardwareSerial Serial;
+EspClass ESP;
+
+uint64_t FAKE_nowUs() { return nowUs.load(std::memory_order_relaxed); }
+void FAKE_advanceUs(uint64_t us) { nowUs.fetch_add(us, std::memory_order_relaxed); }
+void FAKE_resetClock() { nowUs.store(0, std::memory_order_relaxed); }
+void FAKE_setYieldUs(uint32_t us) { yieldUs = us; }
+
+void yield() { FAKE_advanceUs(yieldUs); }
+
+int64_t esp_timer_get_time() { return (int64_t)FAKE_nowUs(); }
+
+void FAKE_serialQuiet(bool q) { quiet = q; }
+
+size_t HardwareSerial::write(uint8_t c) {
+    if (!quiet) fputc(c, stdout);
+    return 1;
+}
+
+size_t HardwareSerial::write(const uint8_t *buf, size_t len) {
+    if (!quiet) fwrite(buf, 1, len, stdout);
+    return len;
+}
+
+void EspClass::restart() {
+    fflush(stdout);
+    fprintf(stderr, "ESP.restart() chamado\n");
+    abort();
+}
+
+struct FakeMutex {
+    std::recursive_mutex m;
+};
+
+SemaphoreHandle_t xSemaphoreCreateMutex() { return new FakeMutex(); }
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutex() { return new FakeMutex(); }
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t h, TickType_t) {
+    h->m.lock();
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t h) {
+    h->m.unlock();
+    return pdTRUE;
+}
@@ -0,0 +1,5 @@
+#pragma once
+#include <stdint.h>
+
+/** µs desde o boot, pelo relógio simulado (fake_clock.h). */
+int64_t esp_timer_get_time();
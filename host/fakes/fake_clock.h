@@ -0,0 +1,27 @@
+#pragma once
+#include <stdint.h>
+
+/**
+ * Relógio simulado do build de host. millis(), micros(), esp_timer_get_time()
+ * e os atrasos do FreeRTOS leem e avançam este relógio, nunca o do sistema:
+ * um teste controla exatamente quanto tempo passa entre duas chamadas.
+ *
+ * delay()/vTaskDelay() avançam o tempo pedido; yield() avança um passo
+ * pequeno (FAKE_setYieldUs), para laços de espera como o de ADS_getSample()
+ * terminarem.
+ */
+
+/** Tempo simulado desde o "boot", em µs. */
+uint64_t FAKE_nowUs();
+
+/** Avança o relógio simulado. */
+void FAKE_advanceUs(uint64_t us);
+
+/** Volta o relógio ao instante 0. */
+void FAKE_resetClock();
+
+/**
+ * Quanto cada yield() avança o relógio.
+ * @param us Passo em µs (padrão 10).
+ */
+void FAKE_setYieldUs(uint32_t us);
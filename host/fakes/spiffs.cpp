@@ -0,0 +1,150 @@
+#include <SPIFFS.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <ftw.h>
+
+SPIFFSFS SPIFFS;
+
+static std::string root;
+static std::string tempRoot;   // Criado por FAKE_spiffsDir(), apagado na saída
+
+static int removeEntry(const char *path, const struct stat *, int, struct FTW *) {
+    return ::remove(path);
+}
+
+static void removeTempRoot() {
+    if (!tempRoot.empty()) nftw(tempRoot.c_str(), removeEntry, 16, FTW_DEPTH | FTW_PHYS);
+}
+
+void FAKE_spiffsRoot(const char *dir) {
+    root = dir;
+}
+
+const char *FAKE_spiffsDir() {
+    if (root.empty()) {
+        char tmpl[] = "/tmp/spiffsXXXXXX";
+        if (!mkdtemp(tmpl)) {
+            perror("mkdtemp");
+            abort();
+        }
+        root = tempRoot = tmpl;
+        atexit(removeTempRoot);
+    }
+    return root.c_str();
+}
+
+static std::string hostPath(const char *path) {
+    std::string p = FAKE_spiffsDir();
+    if (path[0] != '/') p += '/';
+    return p + path;
+}
+
+bool FAKE_spiffsImport(const char *from, const char *to) {
+    FILE *in = fopen(from, "rb");
+    if (!in) return false;
+    FILE *out = fopen(hostPath(to).c_str(), "wb");
+    if (!out) {
+        fclose(in);
+        return false;
+    }
+    char buf[4096];
+    size_t n;
+    bool ok = true;
+    while ((n = fread(buf, 1, sizeof(buf), in)) > 0) ok = fwrite(buf, 1, n, out) == n && ok;
+    fclose(in);
+    return fclose(out) == 0 && ok;
+}
+
+// --- File ---
+
+File::File(FILE *f) : f_(f, fclose), last_(std::make_shared<LastOp>(LastOp::None)) {}
+
+// O C exige um posicionamento entre leitura e escrita no mesmo FILE ("r+").
+void File::switchTo(LastOp op) {
+    if (*last_ != LastOp::None && *last_ != op) fseek(f_.get(), 0, SEEK_CUR);
+    *last_ = op;
+}
+
+size_t File::write(const uint8_t *buf, size_t len) {
+    if (!f_) return 0;
+    switchTo(LastOp::Write);
+    return fwrite(buf, 1, len, f_.get());
+}
+
+size_t File::read(uint8_t *buf, size_t len) {
+    if (!f_) return 0;
+    switchTo(LastOp::Read);
+    return fread(buf, 1, len, f_.get());
+}
+
+int File::read() {
+    uint8_t c;
+    return read(&c, 1) == 1 ? c : -1;
+}
+
+int File::available() {
+    if (!f_) return 0;
+    return (int)(size() - position());
+}
+
+bool File::seek(uint32_t pos) {
+    if (!f_) return false;
+    *last_ = LastOp::None;
+    return fseek(f_.get(), pos, SEEK_SET) == 0;
+}
+
+size_t File::position() const {
+    return f_ ? (size_t)ftell(f_.get()) : 0;
+}
+
+size_t File::size() const {
+    if (!f_) return 0;
+    fflush(f_.get());
+    struct stat st;
+    return fstat(fileno(f_.get()), &st) == 0 ? (size_t)st.st_size : 0;
+}
+
+void File::flush() {
+    if (f_) fflush(f_.get());
+}
+
+String File::readStringUntil(char term) {
+    String s;
+    int c;
+    while ((c = read()) >= 0 && c != term) s += (char)c;
+    return s;
+}
+
+size_t File::readBytesUntil(char term, char *buf, size_t len) {
+    size_t n = 0;
+    int c;
+    while (n < len && (c = read()) >= 0 && c != term) buf[n++] = (char)c;
+    return n;
+}
+
+// --- SPIFFSFS ---
+
+bool SPIFFSFS::begin(bool) {
+    FAKE_spiffsDir();
+    return true;
+}
+
+File SPIFFSFS::open(const char *path, const char *mode) {
+    std::string m = mode;
+    const char *cmode = m == "w" ? "wb" : m == "a" ? "ab" : m == "r+" ? "r+b" : "rb";
+    FILE *f = fopen(hostPath(path).c_str(), cmode);
+    return f ? File(f) : File();
+}
+
+bool SPIFFSFS::exists(const char *path) {
+    struct stat st;
+    return stat(hostPath(path).c_str(), &st) == 0;
+}
+
+bool SPIFFSFS::remove(const char *path) {
+    return ::remove(hostPath(path).c_str()) == 0;
+}
+
+bool SPIFFSFS::rename(const char *from, const char *to) {
+    return ::rename(hostPath(from).c_str(), hostPath(to).c_str()) == 0;
+}
@@ -0,0 +1,204 @@
+// Máquina de estados do ads_driver sobre o ADS1115 simulado: valores contra
+// as tensões do pack, nenhuma consulta ao barramento antes do tempo nominal
+// de conversão, duração da aquisição, troca de perfil, timeout com
+// reinicialização do barramento e leituras corrompidas.
+#include <Arduino.h>
+#include "ads_driver.h"
+#include "check.h"
+
+static constexpr uint32_t POLL_STEP_US = 100;
+
+static float kDiv[PACK_CELLS];
+static uint16_t cellMv[PACK_CELLS];
+
+// Roda uma aquisição consultando a cada POLL_STEP_US. Devolve o status final
+// e a duração no relógio simulado.
+static AdsStatus acquire(CellSample &s, uint32_t &elapsedUs) {
+    const uint64_t t0 = FAKE_nowUs();
+    elapsedUs = 0;
+    if (!ADS_startSample()) return ADS_IDLE;
+    AdsStatus st;
+    do {
+        FAKE_advanceUs(POLL_STEP_US);
+        st = ADS_poll(s);
+    } while (st == ADS_BUSY);
+    elapsedUs = (uint32_t)(FAKE_nowUs() - t0);
+    return st;
+}
+
+static bool nearPack(const CellSample &s, int tolMv) {
+    uint32_t sum = 0;
+    for (uint8_t i = 0; i < PACK_CELLS; i++) {
+        if (abs((int)s.mv[i] - (int)cellMv[i]) > tolMv) return false;
+        sum += cellMv[i];
+    }
+    return abs((int)s.total - (int)sum) <= tolMv;
+}
+
+static void testValuesAndBusTiming() {
+    FAKE_adsConfigure(FAKE_ADS_DEFAULT);
+    ADS_setProfile(ADS_DEFAULT_PROFILE);
+    const uint32_t nominal = ADS_sampleTimeUs(ADS_DEFAULT_PROFILE);
+    const uint32_t conversions = (uint32_t)PACK_ROUND_CHANNELS * ADS_DEFAULT_PROFILE.oversample;
+
+    for (int i = 0; i < 5; i++) {
+        FAKE_adsResetStats();
+        CellSample s;
+        uint32_t us;
+        CHECK_EQ(acquire(s, us), ADS_READY);
+        CHECKF(nearPack(s, 2), "c1=%u c2=%u tot=%u", s.mv[0], s.mv[1], s.total);
+        CHECK_EQ(s.flags & ~SAMPLE_FLAG_PROVISIONAL, 0);
+        CHECK_EQ(s.soc[0], ADS_mvToSoc(s.mv[0]));
+        // Espera o tempo nominal (conversão + margem) e consulta uma vez.
+        CHECKF(us >= nominal && us <= nominal + conversions * POLL_STEP_US, "%u us (nominal %u)", us, nominal);
+
+        FakeAdsStats st;
+        FAKE_adsStats(st);
+        CHECK_EQ(st.conversions, conversions * PACK_ADCS);
+        CHECK_EQ(st.earlyReads, 0);
+        CHECK_EQ(st.statusReads, st.conversions);
+        CHECK_EQ(st.resultReads, st.conversions);
+    }
+
+    CellSample s;
+    CHECK_EQ(ADS_poll(s), ADS_IDLE);
+}
+
+static void testOscillatorJitter() {
+    // Com o oscilador até 10% lento, a margem não cobre a conversão: o driver
+    // consulta de novo até o bit OS subir, sem perder leituras.
+    FakeAdsConfig cfg = FAKE_ADS_DEFAULT;
+    cfg.latencyJitterPct = 10;
+    cfg.seed = 7;
+    FAKE_adsConfigure(cfg);
+    uint32_t partial = 0;
+    for (int i = 0; i < 20; i++) {
+        CellSample s;
+        uint32_t us;
+        CHECK_EQ(acquire(s, us), ADS_READY);
+        CHECK(nearPack(s, 2));
+        if (s.flags & SAMPLE_FLAG_PARTIAL) partial++;
+    }
+    FakeAdsStats st;
+    FAKE_adsStats(st);
+    CHECK_EQ(partial, 0);
+    CHECK(st.earlyReads > 0);
+    CHECK_EQ(st.resultReads, st.conversions);
+}
+
+static void testProfileChange() {
+    FAKE_adsConfigure(FAKE_ADS_DEFAULT);
+    AdsProfile fast = {860, 4, FILTER_MEDIAN, 2};
+    CHECK(ADS_startSample());
+    ADS_setProfile(fast);   // Com a aquisição em andamento: vale só para a próxima
+    CellSample s;
+    while (ADS_poll(s) == ADS_BUSY) FAKE_advanceUs(POLL_STEP_US);
+
+    uint32_t us;
+    CHECK_EQ(acquire(s, us), ADS_READY);
+    const uint32_t nominal = ADS_sampleTimeUs(fast);
+    CHECKF(us >= nominal && us <= nominal + PACK_ROUND_CHANNELS * fast.oversample * POLL_STEP_US,
+        "%u us (nominal %u)", us, nominal);
+    CHECK(nearPack(s, 2));
+
+    // Taxa fora da tabela: usa a suportada mais próxima acima.
+    AdsProfile p = {100, 40, (FilterType)9, 20};
+    ADS_clampProfile(p);
+    CHECK_EQ(p.dataRate, 128);
+    CHECK_EQ(p.oversample, FILTER_MAX_SAMPLES);
+    CHECK_EQ(p.filter, FILTER_MEAN);
+    CHECK_EQ(p.iirShift, 8);
+    ADS_setProfile(ADS_DEFAULT_PROFILE);
+}
+
+static void testStallTimeout() {
+    // Conversões que nunca terminam: cada uma custa 4 tempos de conversão e
+    // uma reinicialização do barramento; a amostra sai parcial ou com erro.
+    FakeAdsConfig cfg = FAKE_ADS_DEFAULT;
+    cfg.stallPermille = 100;
+    cfg.seed = 3;
+    FAKE_adsConfigure(cfg);
+    const uint32_t wireBegins = Wire.begins;
+    uint32_t ready = 0, partial = 0, errors = 0;
+    for (int i = 0; i < 30; i++) {
+        CellSample s;
+        uint32_t us;
+        AdsStatus st = acquire(s, us);
+        if (st == ADS_READY) {
+            ready++;
+            if (s.flags & SAMPLE_FLAG_PARTIAL) partial++;
+            CHECK(nearPack(s, 2));
+        } else {
+            CHECK_EQ(st, ADS_ERROR);
+            errors++;
+        }
+    }
+    FakeAdsStats st;
+    FAKE_adsStats(st);
+    CHECK(st.stalls > 0);
+    CHECK(partial > 0);
+    CHECK_EQ(ready + errors, 30);
+    // Um timeout por conversão travada, cada um reinicia o barramento e os chips.
+    CHECK_EQ(Wire.begins - wireBegins, st.stalls);
+    CHECK_EQ(st.begins, st.stalls * PACK_ADCS);
+
+    // Todas travadas: nenhuma leitura válida, a aquisição termina com erro.
+    cfg.stallPermille = 1000;
+    FAKE_adsConfigure(cfg);
+    CellSample s;
+    uint32_t us;
+    CHECK_EQ(acquire(s, us), ADS_ERROR);
+    const uint32_t conv = ADS_sampleTimeUs(ADS_DEFAULT_PROFILE) / (PACK_ROUND_CHANNELS * ADS_DEFAULT_PROFILE.oversample);
+    CHECK(us >= 4 * conv * PACK_ROUND_CHANNELS * ADS_DEFAULT_PROFILE.oversample);
+}
+
+static void testCorruptedReadings() {
+    // Leituras saturadas: a mediana descarta as isoladas.
+    FakeAdsConfig cfg = FAKE_ADS_DEFAULT;
+    cfg.noiseCounts = 3;
+    cfg.corruptPermille = 50;
+    cfg.seed = 11;
+    FAKE_adsConfigure(cfg);
+    AdsProfile p = ADS_DEFAULT_PROFILE;
+    p.filter = FILTER_MEDIAN;
+    ADS_setProfile(p);
+    uint32_t good = 0;
+    for (int i = 0; i < 40; i++) {
+        CellSample s;
+        uint32_t us;
+        CHECK_EQ(acquire(s, us), ADS_READY);
+        if (nearPack(s, 6) && !(s.flags & SAMPLE_FLAG_RANGE)) good++;
+    }
+    FakeAdsStats st;
+    FAKE_adsStats(st);
+    CHECK(st.corrupted > 0);
+    CHECKF(good >= 38, "%u de 40 amostras dentro de ±6 mV", good);
+    ADS_setProfile(ADS_DEFAULT_PROFILE);
+}
+
+static void testMissingChip() {
+    FAKE_adsSetPresent(0x48, false);
+    CHECK(!ADS_init());
+    CHECK(!ADS_startSample());
+    FAKE_adsSetPresent(0x48, true);
+    CHECK(ADS_init());
+}
+
+int main() {
+    FAKE_serialQuiet(true);
+    for (uint8_t i = 0; i < PACK_CELLS; i++) {
+        kDiv[i] = PACK_defaultKDiv(i);
+        cellMv[i] = 3650 + 40 * i;
+    }
+    FAKE_adsSetPack(cellMv, kDiv, PACK_CELLS);
+    CHECK(ADS_init());
+    ADS_setKDiv(kDiv);
+
+    testValuesAndBusTiming();
+    testOscillatorJitter();
+    testProfileChange();
+    testStallTimeout();
+    testCorruptedReadings();
+    testMissingChip();
+    return CHECK_EXIT();
+}
@@ -0,0 +1,167 @@
+// AlarmEngine sobre logs_experimento2.csv: os eventos (regra, canal, estado,
+// instante e valor) conferem com um modelo de referência escrito por trechos
+// (a condição precisa durar debounceMs seguidos; ativo só sai além de
+// 'clear'), nas regras padrão e em regras apertadas que disparam na captura.
+#include <Arduino.h>
+#include <vector>
+#include "alarm.h"
+#include "check.h"
+#include "capture.h"
+
+struct Point {
+    uint64_t t;
+    uint16_t v;
+    uint8_t  flags;
+};
+
+struct Expected {
+    uint64_t t;
+    uint16_t v;
+    bool     active;
+};
+
+// Modelo de referência de um canal: percorre trechos contínuos em que a
+// condição de mudança vale; o estado vira na primeira amostra do trecho que
+// completa debounceMs, e o trecho seguinte começa na amostra depois dela.
+static std::vector<Expected> reference(const std::vector<Point> &p, const AlarmRule &rule, bool low) {
+    std::vector<Expected> out;
+    if (!rule.enabled) return out;
+    bool active = false;
+    auto holds = [&](uint16_t v) {
+        const uint16_t lim = active ? rule.clear : rule.set;
+        return active ? (low ? v >= lim : v <= lim) : (low ? v <= lim : v >= lim);
+    };
+    size_t i = 0;
+    while (i < p.size()) {
+        if (!holds(p[i].v)) {
+            i++;
+            continue;
+        }
+        const uint64_t start = p[i].t;
+        size_t j = i;
+        while (j < p.size() && holds(p[j].v) && p[j].t - start < rule.debounceMs) j++;
+        if (j < p.size() && holds(p[j].v)) {
+            active = !active;
+            out.push_back({p[j].t, p[j].v, active});
+        }
+        i = j + 1;
+    }
+    return out;
+}
+
+// dV/dt da célula que mais variou, em janelas de pelo menos ALM_SLOPE_WINDOW_MS.
+static std::vector<Point> slope(const std::vector<LogRecord> &recs) {
+    std::vector<Point> out;
+    const LogRecord *ref = recs.empty() ? nullptr : &recs[0];
+    uint16_t dvdt = 0;
+    for (const LogRecord &r : recs) {
+        const uint64_t dt = r.epochMs - ref->epochMs;
+        if (dt >= ALM_SLOPE_WINDOW_MS) {
+            int maxDv = 0;
+            for (uint8_t i = 0; i < PACK_CELLS; i++) maxDv = std::max(maxDv, abs((int)r.mv[i] - (int)ref->mv[i]));
+            dvdt = (uint16_t)std::min<uint64_t>(UINT16_MAX, (uint64_t)maxDv * 1000 / dt);
+            ref = &r;
+        }
+        out.push_back({r.epochMs, dvdt, r.flags});
+    }
+    return out;
+}
+
+static size_t checkConfig(const char *name, const std::vector<LogRecord> &recs, const AlarmConfig &cfg) {
+    AlarmEngine eng;
+    eng.configure(cfg);
+    std::vector<AlarmEvent> got;
+    AlarmEvent ev[ALM_CHANNELS];
+    for (const LogRecord &r : recs) {
+        const uint8_t n = eng.evaluate(r, ev);
+        got.insert(got.end(), ev, ev + n);
+    }
+
+    size_t total = 0;
+    auto compare = [&](uint8_t kind, uint8_t cell, const std::vector<Point> &series) {
+        const bool low = kind == ALM_CELL_UNDER || kind == ALM_PACK_UNDER;
+        const std::vector<Expected> exp = reference(series, cfg.rule[kind], low);
+        std::vector<AlarmEvent> mine;
+        for (const AlarmEvent &e : got) {
+            if (e.kind == kind && (kind == ALM_DVDT || e.cell == cell)) mine.push_back(e);
+        }
+        CHECKF(mine.size() == exp.size(), "%s: %s/%u: %zu eventos, esperados %zu", name, ALM_kindName(kind),
+            (unsigned)cell, mine.size(), exp.size());
+        for (size_t k = 0; k < std::min(mine.size(), exp.size()); k++) {
+            const uint64_t rel = exp[k].t - recs[0].epochMs;
+            CHECKF(mine[k].epochMs == exp[k].t && mine[k].value == exp[k].v && (bool)mine[k].active == exp[k].active,
+                "%s: %s/%u evento %zu: t=+%llu v=%u %s, esperado t=+%llu v=%u %s", name, ALM_kindName(kind),
+                (unsigned)cell, k, (unsigned long long)(mine[k].epochMs - recs[0].epochMs), mine[k].value,
+                mine[k].active ? "ativo" : "normal", (unsigned long long)rel, exp[k].v,
+                exp[k].active ? "ativo" : "normal");
+            // Histerese: sai só além de 'clear', entra só além de 'set'.
+            const AlarmRule &rule = cfg.rule[kind];
+            const uint16_t lim = mine[k].active ? rule.set : rule.clear;
+            const bool ok = mine[k].active == low ? mine[k].value <= lim : mine[k].value >= lim;
+            CHECKF(ok, "%s: %s valor %u além do limiar %u", name, ALM_kindName(kind), mine[k].value, lim);
+        }
+        total += exp.size();
+    };
+
+    for (uint8_t c = 0; c < PACK_CELLS; c++) {
+        std::vector<Point> cell;
+        for (const LogRecord &r : recs) cell.push_back({r.epochMs, r.mv[c], r.flags});
+        compare(ALM_CELL_UNDER, c, cell);
+        compare(ALM_CELL_OVER, c, cell);
+    }
+    std::vector<Point> imb, pack;
+    for (const LogRecord &r : recs) {
+        uint16_t lo = r.mv[0], hi = r.mv[0];
+        for (uint8_t c = 1; c < PACK_CELLS; c++) {
+            lo = std::min(lo, r.mv[c]);
+            hi = std::max(hi, r.mv[c]);
+        }
+        imb.push_back({r.epochMs, (uint16_t)(hi - lo), r.flags});
+        pack.push_back({r.epochMs, r.total, r.flags});
+    }
+    compare(ALM_IMBALANCE, ALM_PACK, imb);
+    compare(ALM_DVDT, ALM_PACK, slope(recs));
+    compare(ALM_PACK_UNDER, ALM_PACK, pack);
+    compare(ALM_PACK_OVER, ALM_PACK, pack);
+    CHECKF(got.size() == total, "%s: %zu eventos, esperados %zu", name, got.size(), total);
+
+    printf("%-12s %zu eventos:", name, got.size());
+    for (const AlarmEvent &e : got) {
+        printf(" %s%s@+%.1fs", e.active ? "+" : "-", ALM_kindName(e.kind), (e.epochMs - recs[0].epochMs) / 1000.0);
+    }
+    printf("\n");
+    return got.size();
+}
+
+int main() {
+    FAKE_serialQuiet(true);
+    std::vector<CellSample> cap;
+    CHECK(CAP_load("logs_experimento2.csv", cap, CAP_EXPERIMENTO2_MS));
+    std::vector<LogRecord> recs;
+    for (const CellSample &s : cap) {
+        LogRecord r;
+        r.epochMs = s.epochMs;
+        memcpy(r.mv, s.mv, sizeof(r.mv));
+        r.total = s.total;
+        r.flags = s.flags;
+        recs.push_back(r);
+    }
+    if (recs.empty()) return CHECK_EXIT();
+
+    checkConfig("padrão", recs, ALM_defaultConfig());
+
+    // Limiares dentro da faixa da captura, para as duas transições acontecerem.
+    AlarmConfig tight = ALM_defaultConfig();
+    tight.rule[ALM_IMBALANCE] = {true, 110, 90, 5000};
+    tight.rule[ALM_DVDT] = {true, 20, 5, 3000};
+    tight.rule[ALM_CELL_UNDER] = {true, 3800, 3810, 2000};
+    const size_t n = checkConfig("apertada", recs, tight);
+    CHECKF(n >= 4, "só %zu eventos com as regras apertadas", n);
+
+    // Sem debounce, todo cruzamento isolado vira evento; o debounce só remove.
+    AlarmConfig raw = tight;
+    for (AlarmRule &r : raw.rule) r.debounceMs = 0;
+    const size_t nRaw = checkConfig("sem_debounce", recs, raw);
+    CHECKF(nRaw >= n, "sem debounce %zu eventos, com debounce %zu", nRaw, n);
+    return CHECK_EXIT();
+}
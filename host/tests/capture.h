@@ -0,0 +1,32 @@
+#pragma once
+#include <vector>
+#include <SPIFFS.h>
+#include "replay.h"
+
+/**
+ * Carrega uma captura de logs/ (CSV do download ou o formato antigo) pela
+ * ReplaySource do firmware, na vazão máxima. epochMs de cada amostra é o
+ * relógio da captura somado a 'baseMs'.
+ * @param name Arquivo em logs/ (p.ex. "logs_experimento2.csv").
+ * @param out Recebe as amostras.
+ * @param baseMs Timestamp da primeira linha.
+ * @return false se o arquivo não abre ou não tem linhas válidas.
+ */
+inline bool CAP_load(const char *name, std::vector<CellSample> &out, uint64_t baseMs = 0) {
+    std::string host = std::string(HOST_LOGS_DIR) + "/" + name;
+    if (!FAKE_spiffsImport(host.c_str(), "/capture.csv")) return false;
+    ReplayConfig cfg = {"/capture.csv", 0, 1};
+    ReplaySource src;
+    if (!src.open(cfg, 0)) return false;
+    CellSample s;
+    out.clear();
+    while (src.next(0, s) > 0) {
+        s.epochMs += baseMs;
+        out.push_back(s);
+    }
+    return !out.empty();
+}
+
+// Timestamp para a primeira linha de logs_experimento2.csv: a captura só tem
+// a hora (16:18:33), a data (10/06/2025, UTC) é arbitrária.
+static constexpr uint64_t CAP_EXPERIMENTO2_MS = 1749572313000ULL;
@@ -0,0 +1,33 @@
+#pragma once
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * Verificações dos testes de host. Uma falha imprime arquivo:linha e a
+ * expressão, e o teste continua; CHECK_EXIT() devolve o código de saída
+ * para o ctest (0 = tudo passou).
+ */
+
+static int checkFailures = 0;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { \
+        fprintf(stderr, "%s:%d: falhou: %s\n", __FILE__, __LINE__, #cond); \
+        checkFailures++; \
+    } \
+} while (0)
+
+// Como CHECK, com uma mensagem no formato do printf.
+#define CHECKF(cond, ...) do { \
+    if (!(cond)) { \
+        fprintf(stderr, "%s:%d: falhou: %s: ", __FILE__, __LINE__, #cond); \
+        fprintf(stderr, __VA_ARGS__); \
+        fputc('\n', stderr); \
+        checkFailures++; \
+    } \
+} while (0)
+
+// Compara inteiros e mostra os dois valores na falha.
+#define CHECK_EQ(a, b) CHECKF((a) == (b), "%lld != %lld", (long long)(a), (long long)(b))
+
+#define CHECK_EXIT() (checkFailures ? (fprintf(stderr, "%d verificações falharam\n", checkFailures), 1) : 0)
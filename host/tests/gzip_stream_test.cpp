@@ -0,0 +1,101 @@
+// Compressor gzip do /download: a saída de entradas aleatórias (pior caso,
+// sem matches) e de um CSV parecido com o do log volta idêntica pelo inflate
+// do zlib, escrita em trechos de vários tamanhos e drenada em pedaços
+// pequenos como no chunked response; o CSV encolhe de verdade.
+#include <Arduino.h>
+#include <random>
+#include <string>
+#include <vector>
+#include <zlib.h>
+#include "gzip_stream.h"
+#include "pack_config.h"
+#include "check.h"
+
+static GzipStream gz;   // ~7 KB: fora da pilha, como no firmware
+
+// Comprime em write() de até 'step' bytes, drenando com read() de 'drain' bytes.
+static std::vector<uint8_t> compress(const std::string &in, size_t step, size_t drain) {
+    std::vector<uint8_t> out;
+    uint8_t buf[256];
+    auto pull = [&]() {
+        for (size_t n; (n = gz.read(buf, drain)) > 0;) out.insert(out.end(), buf, buf + n);
+    };
+    gz.begin();
+    for (size_t pos = 0; pos < in.size(); pos += step) {
+        pull();
+        gz.write((const uint8_t *)in.data() + pos, std::min(step, in.size() - pos));
+    }
+    pull();
+    gz.finish();
+    pull();
+    CHECK(gz.finished() && gz.pending() == 0);
+    return out;
+}
+
+// Descomprime com o zlib (cabeçalho gzip, CRC32 e tamanho conferidos por ele).
+static bool inflateGzip(const std::vector<uint8_t> &in, std::string &out) {
+    z_stream z = {};
+    if (inflateInit2(&z, 16 + MAX_WBITS) != Z_OK) return false;
+    z.next_in = (Bytef *)in.data();
+    z.avail_in = (uInt)in.size();
+    uint8_t buf[4096];
+    int rc;
+    do {
+        z.next_out = buf;
+        z.avail_out = sizeof(buf);
+        rc = inflate(&z, Z_NO_FLUSH);
+        out.append((const char *)buf, sizeof(buf) - z.avail_out);
+    } while (rc == Z_OK);
+    const bool ok = rc == Z_STREAM_END && z.avail_in == 0;
+    inflateEnd(&z);
+    return ok;
+}
+
+static void roundTrip(const char *name, const std::string &in, size_t &gzBytes) {
+    const size_t steps[] = {1, 7, 100, GZ_CHUNK};
+    const size_t drains[] = {1, 13, 256};
+    for (size_t step : steps) {
+        for (size_t drain : drains) {
+            const std::vector<uint8_t> z = compress(in, step, drain);
+            std::string back;
+            CHECKF(inflateGzip(z, back), "%s: inflate falhou (write de %zu, read de %zu)", name, step, drain);
+            CHECKF(back == in, "%s: %zu bytes voltaram como %zu (write de %zu, read de %zu)", name, in.size(),
+                back.size(), step, drain);
+            gzBytes = z.size();
+        }
+    }
+    printf("%-10s %7zu -> %7zu bytes\n", name, in.size(), gzBytes);
+}
+
+int main() {
+    std::mt19937 rng(12345);
+    size_t gzBytes;
+
+    roundTrip("vazio", "", gzBytes);
+
+    std::string random(100000, '\0');
+    for (char &ch : random) ch = (char)(rng() & 0xFF);
+    roundTrip("aleatório", random, gzBytes);
+    CHECKF(gzBytes < random.size() * 9 / 8 + 64, "aleatório cresceu para %zu bytes", gzBytes);
+
+    // Linhas do download: hora, mV e SoC por célula, total; tensões com ruído.
+    std::string csv = "hora";
+    for (unsigned i = 1; i <= PACK_CELLS; i++) csv += ",c" + std::to_string(i) + "_mv,c" + std::to_string(i) + "_soc";
+    csv += ",total_mv\n";
+    char line[48 + 16 * PACK_CELLS];
+    for (unsigned k = 0; k < 3000; k++) {
+        unsigned ms = k * 500, total = 0;
+        int n = snprintf(line, sizeof(line), "2025-06-10 %02u:%02u:%02u.%03u", 10 + ms / 3600000,
+            ms / 60000 % 60, ms / 1000 % 60, ms % 1000);
+        for (unsigned i = 0; i < PACK_CELLS; i++) {
+            const unsigned mv = 3700 - k / 20 + rng() % 8;
+            total += mv;
+            n += snprintf(line + n, sizeof(line) - n, ",%u,%u", mv, 60 - k / 100);
+        }
+        snprintf(line + n, sizeof(line) - n, ",%u\n", total);
+        csv += line;
+    }
+    roundTrip("csv", csv, gzBytes);
+    CHECKF(gzBytes * 2 < csv.size(), "CSV só caiu para %zu de %zu bytes", gzBytes, csv.size());
+    return CHECK_EXIT();
+}
@@ -0,0 +1,135 @@
+// Redução do log (logcomp) sobre logs_experimento2.csv e uma série sintética
+// longa: a série reconstruída (último valor na banda morta, reta entre os
+// vértices no swinging door) fica a no máximo deviationMv da original em
+// toda amostra e série, o heartbeat vale (nenhuma amostra fica mais de
+// heartbeatMs depois do último registro gravado sem ser gravada) e toda
+// mudança de flags é gravada.
+#include <Arduino.h>
+#include <math.h>
+#include <random>
+#include "logcomp.h"
+#include "check.h"
+#include "capture.h"
+
+static int32_t value(const LogRecord &r, uint8_t k) { return k < PACK_CELLS ? r.mv[k] : r.total; }
+
+static bool same(const LogRecord &a, const LogRecord &b) {
+    return a.epochMs == b.epochMs && !memcmp(a.mv, b.mv, sizeof(a.mv)) && a.total == b.total && a.flags == b.flags;
+}
+
+static std::vector<LogRecord> compress(const std::vector<LogRecord> &in, const LogCompConfig &cfg) {
+    LogCompressor c;
+    c.configure(cfg);
+    std::vector<LogRecord> out;
+    LogRecord buf[2];
+    for (const LogRecord &r : in) {
+        uint8_t n = c.push(r, buf);
+        out.insert(out.end(), buf, buf + n);
+    }
+    if (c.flush(buf[0])) out.push_back(buf[0]);
+    CHECK_EQ(c.samplesIn(), in.size());
+    CHECK_EQ(c.recordsOut(), out.size());
+    return out;
+}
+
+static void checkMode(const char *name, const std::vector<LogRecord> &in, const LogCompConfig &cfg) {
+    const std::vector<LogRecord> out = compress(in, cfg);
+    CHECK(!out.empty() && same(out.front(), in.front()));
+
+    // Os registros gravados são amostras da entrada, em ordem.
+    size_t j = 0;
+    for (const LogRecord &r : out) {
+        while (j < in.size() && !same(in[j], r)) j++;
+        CHECKF(j < in.size(), "%s: registro t=%llu não é amostra da entrada", name, (unsigned long long)r.epochMs);
+        j++;
+    }
+
+    double maxErr = 0;
+    uint32_t heartbeatMisses = 0, flagMisses = 0;
+    size_t k = 0;   // out[k] é o último registro gravado com t <= amostra
+    for (size_t i = 0; i < in.size(); i++) {
+        const LogRecord &s = in[i];
+        while (k + 1 < out.size() && out[k + 1].epochMs <= s.epochMs) k++;
+        const LogRecord &a = out[k];
+        const bool archived = same(a, s);   // Timestamps da entrada são crescentes
+
+        if (!archived && s.epochMs - a.epochMs > cfg.heartbeatMs) heartbeatMisses++;
+        if (i > 0 && s.flags != in[i - 1].flags && !archived) flagMisses++;
+
+        for (uint8_t c = 0; c < PACK_SERIES; c++) {
+            double rec = value(a, c);
+            if (cfg.mode == LOG_MODE_SWINGDOOR && k + 1 < out.size() && s.epochMs > a.epochMs) {
+                const LogRecord &b = out[k + 1];
+                rec += (double)(value(b, c) - value(a, c)) * (double)(s.epochMs - a.epochMs) /
+                       (double)(b.epochMs - a.epochMs);
+            }
+            maxErr = fmax(maxErr, fabs(rec - value(s, c)));
+        }
+    }
+    printf("%-24s dev=%2u mV hb=%5u ms: %6zu -> %6zu registros (%5.1f%%), erro máx %.2f mV\n", name,
+        (unsigned)cfg.deviationMv, (unsigned)cfg.heartbeatMs, in.size(), out.size(),
+        100.0 * out.size() / in.size(), maxErr);
+    CHECKF(maxErr <= cfg.deviationMv + 1e-9, "%s: erro %.3f mV > %u mV", name, maxErr, (unsigned)cfg.deviationMv);
+    CHECKF(heartbeatMisses == 0, "%s: %u amostras além do heartbeat", name, heartbeatMisses);
+    CHECKF(flagMisses == 0, "%s: %u mudanças de flags não gravadas", name, flagMisses);
+}
+
+// Descarga lenta de 2 h a 2 Hz com ruído de ±1 mV, degraus de carga, um
+// trecho parado (só o heartbeat grava) e flags mudando de vez em quando.
+static std::vector<LogRecord> synthetic() {
+    std::mt19937 rng(9);
+    std::vector<LogRecord> v;
+    LogRecord r = {};
+    r.epochMs = CAP_EXPERIMENTO2_MS;
+    double base = 4050;
+    for (uint32_t i = 0; i < 14400; i++) {
+        r.epochMs += 500;
+        const bool still = i >= 6000 && i < 9000;
+        if (!still) base -= 0.02;
+        if (i % 2400 == 1200) base -= 40;    // Degrau de carga
+        if (i % 2400 == 1800) base += 35;
+        r.total = 0;
+        for (uint8_t c = 0; c < PACK_CELLS; c++) {
+            r.mv[c] = (uint16_t)lround(base - 7 * c + (still ? 0 : (int)(rng() % 3) - 1));
+            r.total += r.mv[c];
+        }
+        r.flags = (i / 1500) % 4 == 3 ? SAMPLE_FLAG_PARTIAL : 0;
+        v.push_back(r);
+    }
+    return v;
+}
+
+int main() {
+    FAKE_serialQuiet(true);
+    std::vector<CellSample> cap;
+    CHECK(CAP_load("logs_experimento2.csv", cap, CAP_EXPERIMENTO2_MS));
+    std::vector<LogRecord> exp2;
+    for (const CellSample &s : cap) {
+        LogRecord r;
+        r.epochMs = s.epochMs;
+        memcpy(r.mv, s.mv, sizeof(r.mv));
+        r.total = s.total;
+        r.flags = 0;
+        exp2.push_back(r);
+    }
+    const std::vector<LogRecord> syn = synthetic();
+
+    const LogMode modes[] = {LOG_MODE_DEADBAND, LOG_MODE_SWINGDOOR};
+    const uint16_t devs[] = {1, 2, 5, 10};
+    const uint32_t heartbeats[] = {10000, 60000};
+    for (LogMode m : modes) {
+        for (uint16_t dev : devs) {
+            for (uint32_t hb : heartbeats) {
+                const LogCompConfig cfg = {m, dev, hb};
+                const bool door = m == LOG_MODE_SWINGDOOR;
+                checkMode(door ? "experimento2/swingdoor" : "experimento2/deadband", exp2, cfg);
+                checkMode(door ? "sintética/swingdoor" : "sintética/deadband", syn, cfg);
+            }
+        }
+    }
+
+    // LOG_MODE_ALL grava tudo.
+    const LogCompConfig all = {LOG_MODE_ALL, 2, 60000};
+    CHECK_EQ(compress(exp2, all).size(), exp2.size());
+    return CHECK_EXIT();
+}
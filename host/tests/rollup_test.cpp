@@ -0,0 +1,67 @@
+// Agregador: contagem e soma de 1 h sem saturar/estourar com mais de 65535
+// amostras em fundo de escala, persistência do intervalo fechado e recriação
+// de um arquivo no formato antigo (RollBucket de 36 bytes).
+#include <Arduino.h>
+#include <SPIFFS.h>
+#include <vector>
+#include "rollup.h"
+#include "check.h"
+
+static constexpr uint32_t T0 = 1749571200;   // Múltiplo de 3600
+
+static void testWideHour() {
+    // 100 mil amostras em 1 h (36 ms cada) com tudo em 65535 mV.
+    const uint32_t samples = 100000;
+    CellSample s = {};
+    for (uint8_t i = 0; i < PACK_CELLS; i++) s.mv[i] = UINT16_MAX;
+    s.total = UINT16_MAX;
+    for (uint32_t k = 0; k < samples; k++) {
+        s.epochMs = (uint64_t)T0 * 1000 + (uint64_t)k * 3600000 / samples;
+        ROLL_add(s);
+    }
+    RollBucket b;
+    CHECK(ROLL_get(ROLL_1H, T0, b));   // Intervalo aberto
+    CHECK_EQ(b.n, samples);
+    for (uint8_t i = 0; i < ROLL_SERIES; i++) CHECK_EQ(b.avg[i], UINT16_MAX);
+
+    // Fecha a hora: o balde vai para o anel e para /roll_h.bin.
+    s.epochMs = (uint64_t)(T0 + 3600) * 1000;
+    for (uint8_t i = 0; i < PACK_CELLS; i++) s.mv[i] = 3700;
+    s.total = 3700 * PACK_CELLS;
+    ROLL_add(s);
+    CHECK(ROLL_get(ROLL_1H, T0, b));
+    CHECK_EQ(b.n, samples);
+    CHECK_EQ(b.avg[0], UINT16_MAX);
+    CHECK(ROLL_get(ROLL_1M, T0 + 60, b));
+    CHECKF(b.n == samples / 60 || b.n == samples / 60 + 1, "1 min com %u amostras", (unsigned)b.n);
+
+    // Depois de um reinício o balde fechado volta do arquivo.
+    ROLL_init();
+    CHECK(ROLL_get(ROLL_1H, T0, b));
+    CHECK_EQ(b.n, samples);
+    CHECK_EQ(b.min[PACK_SERIES - 1], UINT16_MAX);
+}
+
+static void testOldFormatRecreated() {
+    // Arquivo do formato anterior (n de 16 bits): tamanho diferente, recriado vazio.
+    const size_t oldBytes = (size_t)ROLL_capacity(ROLL_1H) * (6 + 6 * ROLL_SERIES);
+    std::vector<uint8_t> junk(oldBytes, 0x5A);
+    File f = SPIFFS.open("/roll_h.bin", FILE_WRITE);
+    f.write(junk.data(), junk.size());
+    f.close();
+    ROLL_init();
+    f = SPIFFS.open("/roll_h.bin", FILE_READ);
+    CHECK_EQ(f.size(), (size_t)ROLL_capacity(ROLL_1H) * sizeof(RollBucket));
+    f.close();
+    RollBucket b;
+    CHECK(!ROLL_get(ROLL_1H, T0, b));
+}
+
+int main() {
+    FAKE_serialQuiet(true);
+    SPIFFS.begin(true);
+    ROLL_init();
+    testWideHour();
+    testOldFormatRecreated();
+    return CHECK_EXIT();
+}
@@ -0,0 +1,243 @@
+// SampleScheduler com relógio simulado: subida imediata por dV/dt e por
+// desbalanceamento, histerese entre os limiares, descida um nível por vez
+// só após holdMs de calma, piso de nível durante a calibração, cadência de
+// due() em cada nível e reancoragem após atraso.
+#include <functional>
+#include <vector>
+#include "sched.h"
+#include "check.h"
+
+static uint32_t nowMs = 0;
+static uint32_t clockMs() { return nowMs; }
+
+struct Transition {
+    uint32_t   t;
+    SchedLevel level;
+};
+
+typedef std::function<void(uint32_t t, uint16_t mv[PACK_CELLS])> Signal;
+
+// Avança o relógio de 1 em 1 ms por 'ms', amostrando quando due() manda.
+static std::vector<Transition> run(SampleScheduler &s, uint32_t ms, const Signal &signal,
+                                   uint32_t *samples = nullptr) {
+    std::vector<Transition> tr;
+    const uint32_t end = nowMs + ms;
+    for (; nowMs < end; nowMs++) {
+        if (!s.due()) continue;
+        if (samples) (*samples)++;
+        uint16_t mv[PACK_CELLS];
+        signal(nowMs, mv);
+        SchedLevel before = s.level();
+        s.observe(mv);
+        if (s.level() != before) tr.push_back({nowMs, s.level()});
+    }
+    return tr;
+}
+
+// Pack parado em 3800 mV com ±1 mV de ruído alternado.
+static void steady(uint32_t t, uint16_t mv[PACK_CELLS]) {
+    for (uint8_t i = 0; i < PACK_CELLS; i++) mv[i] = (uint16_t)(3800 + ((t / 500 + i) & 1));
+}
+
+// Rampa em todas as células ('rate' mV/s a partir de 't0').
+static Signal ramp(uint32_t t0, double rate) {
+    return [t0, rate](uint32_t t, uint16_t mv[PACK_CELLS]) {
+        for (uint8_t i = 0; i < PACK_CELLS; i++) mv[i] = (uint16_t)(3800 - rate * (t - t0) / 1000.0);
+    };
+}
+
+// Uma célula 'delta' mV abaixo das outras.
+static Signal imbalanced(uint16_t delta) {
+    return [delta](uint32_t, uint16_t mv[PACK_CELLS]) {
+        for (uint8_t i = 0; i < PACK_CELLS; i++) mv[i] = 3800;
+        mv[PACK_CELLS - 1] = 3800 - delta;
+    };
+}
+
+static const SchedConfig &cfg = SCHED_DEFAULT_CONFIG;
+
+static void testCalmDescentAndCadence() {
+    nowMs = 1000;
+    SampleScheduler s(clockMs);
+    s.configure(cfg);
+    CHECK_EQ(s.level(), SCHED_NORMAL);
+
+    // A primeira chamada de due() já amostra; a calma conta dali e a descida
+    // vem na primeira amostra após holdMs.
+    const uint32_t tFirst = nowMs;
+    auto tr = run(s, 40000, steady);
+    CHECK_EQ(tr.size(), 1);
+    if (tr.size() == 1) {
+        CHECK_EQ(tr[0].level, SCHED_SLOW);
+        CHECK_EQ(tr[0].t, tFirst + cfg.holdMs);
+    }
+    // Nada desce abaixo de SLOW; cadência de 2 s.
+    uint32_t samples = 0;
+    tr = run(s, 20000, steady, &samples);
+    CHECK(tr.empty());
+    CHECK_EQ(samples, 20000 / cfg.periodMs[SCHED_SLOW]);
+    CHECK_EQ(s.transitions(), 1);
+}
+
+static void testSlopeUpHysteresisAndHold() {
+    nowMs = 0;
+    SampleScheduler s(clockMs);
+    s.configure(cfg);
+    run(s, 40000, steady);
+    CHECK_EQ(s.level(), SCHED_SLOW);
+
+    // dV/dt de 40 mV/s: de SLOW direto para FAST, na primeira janela de 1 s
+    // medida depois do início da rampa.
+    const uint32_t t0 = nowMs;
+    auto tr = run(s, 5000, ramp(t0, 40));
+    CHECK_EQ(tr.size(), 1);
+    if (!tr.empty()) {
+        CHECK_EQ(tr[0].level, SCHED_FAST);
+        CHECKF(tr[0].t - t0 <= cfg.periodMs[SCHED_SLOW] + SCHED_SLOPE_WINDOW_MS, "subiu %u ms após a rampa",
+            tr[0].t - t0);
+    }
+    CHECKF(s.lastDvdt() > cfg.dvdtUp, "dvdt %u", s.lastDvdt());
+
+    // Entre os limiares (12 mV/s, entre 8 e 20): fica no rápido indefinidamente.
+    uint32_t samples = 0;
+    tr = run(s, 120000, ramp(nowMs, 12), &samples);
+    CHECK(tr.empty());
+    CHECK_EQ(s.level(), SCHED_FAST);
+    CHECK_EQ(samples, 120000 / cfg.periodMs[SCHED_FAST]);
+
+    // Calma: desce um nível por holdMs (FAST -> NORMAL -> SLOW), com a
+    // calma contando da primeira janela estável.
+    const uint32_t tCalm = nowMs;
+    tr = run(s, 2 * cfg.holdMs + 5000, steady);
+    CHECK_EQ(tr.size(), 2);
+    if (tr.size() == 2) {
+        CHECK_EQ(tr[0].level, SCHED_NORMAL);
+        CHECK_EQ(tr[1].level, SCHED_SLOW);
+        CHECKF(tr[0].t - tCalm >= cfg.holdMs && tr[0].t - tCalm <= cfg.holdMs + 2 * SCHED_SLOPE_WINDOW_MS,
+            "NORMAL %u ms após a calma", tr[0].t - tCalm);
+        // O segundo degrau espera holdMs inteiro a partir do primeiro.
+        CHECKF(tr[1].t - tr[0].t >= cfg.holdMs && tr[1].t - tr[0].t < cfg.holdMs + cfg.periodMs[SCHED_NORMAL],
+            "SLOW %u ms após NORMAL", tr[1].t - tr[0].t);
+    }
+
+    // Um transitório durante a espera reinicia a contagem da calma.
+    tr = run(s, 3000, ramp(nowMs, 40));
+    CHECK_EQ(s.level(), SCHED_FAST);
+    const uint32_t tCalm2 = nowMs;
+    tr = run(s, cfg.holdMs / 2, steady);
+    CHECK(tr.empty());
+    tr = run(s, 2000, ramp(nowMs, 40));   // Volta a subir antes de completar o hold
+    tr = run(s, cfg.holdMs - 1000, steady);
+    CHECKF(tr.empty(), "desceu %u ms após a primeira calma", tr.empty() ? 0 : tr[0].t - tCalm2);
+    CHECK_EQ(s.level(), SCHED_FAST);
+}
+
+static void testImbalanceHysteresis() {
+    nowMs = 0;
+    SampleScheduler s(clockMs);
+    s.configure(cfg);
+    auto tr = run(s, 2000, imbalanced((uint16_t)(cfg.imbalanceUp + 10)));
+    CHECK_EQ(s.level(), SCHED_FAST);
+    CHECK_EQ(tr.size(), 1);
+    if (!tr.empty()) CHECK_EQ(tr[0].t, 0);   // Na primeira amostra
+
+    // Entre imbalanceDown e imbalanceUp: mantém.
+    tr = run(s, 3 * cfg.holdMs, imbalanced((cfg.imbalanceUp + cfg.imbalanceDown) / 2));
+    CHECK(tr.empty());
+    // Abaixo de imbalanceDown: desce após o hold. A mudança de 25 mV da célula
+    // conta como dV/dt na primeira janela, então a calma começa na seguinte.
+    tr = run(s, cfg.holdMs + 2 * SCHED_SLOPE_WINDOW_MS, imbalanced((uint16_t)(cfg.imbalanceDown - 10)));
+    CHECK_EQ(tr.size(), 1);
+    CHECK_EQ(s.level(), SCHED_NORMAL);
+}
+
+static void testNoiseAndMinPeriod() {
+    // Ruído de 2 mV entre amostras de 200 ms: 10 mV/s se medido amostra a
+    // amostra, mas a janela de 1 s vê só os 2 mV.
+    nowMs = 0;
+    SampleScheduler s(clockMs);
+    SchedConfig c = cfg;
+    c.periodMs[SCHED_NORMAL] = 200;
+    s.configure(c);
+    auto noisy = [](uint32_t t, uint16_t mv[PACK_CELLS]) {
+        for (uint8_t i = 0; i < PACK_CELLS; i++) mv[i] = (uint16_t)(3800 + ((t / 200) & 1) * 2);
+    };
+    auto tr = run(s, 60000, noisy);
+    CHECK(s.lastDvdt() <= 2);
+    CHECK_EQ(tr.size(), 1);
+    CHECK_EQ(s.level(), SCHED_SLOW);
+
+    // Perfil lento: o período não fica abaixo do tempo da aquisição.
+    s.setMinPeriod(700);
+    CHECK_EQ(s.periodOf(SCHED_FAST), 700);
+    CHECK_EQ(s.periodOf(SCHED_SLOW), c.periodMs[SCHED_SLOW]);
+}
+
+// Captura de calibração: o piso tira do lento na hora e segura a calma.
+static void testFloor() {
+    nowMs = 0;
+    SampleScheduler s(clockMs);
+    s.configure(cfg);
+    run(s, 40000, steady);
+    CHECK_EQ(s.level(), SCHED_SLOW);
+
+    s.setFloor(SCHED_NORMAL);
+    CHECK_EQ(s.level(), SCHED_NORMAL);
+    // A próxima aquisição já segue o período normal, não os 2 s do lento.
+    uint32_t samples = 0;
+    auto tr = run(s, 6 * cfg.periodMs[SCHED_NORMAL], steady, &samples);
+    CHECK_EQ(samples, 6);
+    tr = run(s, 3 * cfg.holdMs, steady);
+    CHECK(tr.empty());
+
+    // Transitório durante a captura ainda acelera e volta só até o piso.
+    run(s, 3000, ramp(nowMs, 40));
+    CHECK_EQ(s.level(), SCHED_FAST);
+    tr = run(s, 3 * cfg.holdMs, steady);
+    CHECK_EQ(tr.size(), 1);
+    CHECK_EQ(s.level(), SCHED_NORMAL);
+
+    // Liberado, desce após o hold.
+    s.setFloor(SCHED_SLOW);
+    tr = run(s, cfg.holdMs + cfg.periodMs[SCHED_NORMAL], steady);
+    CHECK_EQ(tr.size(), 1);
+    CHECK_EQ(s.level(), SCHED_SLOW);
+}
+
+static void testLateDoesNotBurst() {
+    nowMs = 0;
+    SampleScheduler s(clockMs);
+    s.configure(cfg);
+    CHECK(s.due());                 // Primeira chamada inicia a agenda
+    nowMs += 500;
+    CHECK(s.due());
+    nowMs += 5000;                  // loop() travado por 10 períodos
+    CHECK(s.due());
+    CHECK(!s.due());                // Sem rajada para recuperar
+    nowMs += 499;
+    CHECK(!s.due());
+    nowMs += 1;
+    CHECK(s.due());
+}
+
+static void testFixedRate() {
+    nowMs = 0;
+    SampleScheduler s(clockMs);
+    SchedConfig c = cfg;
+    c.adaptive = false;
+    s.configure(c);
+    run(s, 60000, ramp(0, 100));
+    CHECK_EQ(s.level(), SCHED_NORMAL);
+    CHECK_EQ(s.transitions(), 0);
+}
+
+int main() {
+    testCalmDescentAndCadence();
+    testSlopeUpHysteresisAndHold();
+    testImbalanceHysteresis();
+    testNoiseAndMinPeriod();
+    testFloor();
+    testLateDoesNotBurst();
+    testFixedRate();
+    return CHECK_EXIT();
+}
@@ -0,0 +1,168 @@
+// SpscRing com um produtor e um consumidor em std::thread: nenhum item
+// perdido, duplicado, fora de ordem ou lido pela metade, e os contadores de
+// overflow e marca d'água batendo com o que cada lado viu.
+//
+//   spsc_ring_test [itens]   (padrão 2.000.000 por cenário)
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include "spsc_ring.h"
+#include "check.h"
+
+// Item maior que uma palavra, para uma leitura incompleta aparecer como
+// palavras de sequências diferentes.
+struct Item {
+    uint32_t seq;
+    uint32_t words[7];
+};
+
+static Item makeItem(uint32_t seq) {
+    Item it;
+    it.seq = seq;
+    for (uint32_t i = 0; i < 7; i++) it.words[i] = seq * 2654435761u + i;
+    return it;
+}
+
+static bool intact(const Item &it) {
+    for (uint32_t i = 0; i < 7; i++) {
+        if (it.words[i] != it.seq * 2654435761u + i) return false;
+    }
+    return true;
+}
+
+static void testSingleThread() {
+    SpscRing<Item, 8> q;
+    Item it;
+    CHECK(!q.pop(it));
+    for (uint32_t i = 0; i < 8; i++) CHECK(q.push(makeItem(i)));
+    CHECK(!q.push(makeItem(8)));
+    CHECK_EQ(q.size(), 8);
+    CHECK_EQ(q.overflows(), 1);
+    CHECK_EQ(q.pushed(), 8);
+    CHECK_EQ(q.highWater(), 8);
+    for (uint32_t i = 0; i < 8; i++) {
+        CHECK(q.pop(it));
+        CHECK_EQ(it.seq, i);
+    }
+    CHECK(!q.pop(it));
+    // Índices passam da capacidade várias vezes.
+    for (uint32_t i = 0; i < 100; i++) {
+        CHECK(q.push(makeItem(i)));
+        CHECK(q.pop(it));
+        CHECK(it.seq == i && intact(it));
+    }
+    CHECK_EQ(q.highWater(), 8);
+}
+
+struct Result {
+    uint32_t attempts;
+    uint32_t accepted;     // push() == true, visto pelo produtor
+    uint32_t rejected;     // push() == false
+    uint32_t consumed;
+    uint32_t torn;
+    uint32_t outOfOrder;
+    uint32_t gaps;         // Sequências puladas pelo consumidor
+    size_t   maxSeenSize;  // Maior size() observado pelo produtor após um push
+};
+
+/**
+ * Um cenário: o produtor insere 'n' itens; com 'retry' tenta de novo cada
+ * item recusado (nada se perde), senão descarta e segue no seu ritmo, como a
+ * tarefa de aquisição. O consumidor para a cada 'consumerPauseEvery' itens (0 = nunca),
+ * para forçar a fila a encher.
+ */
+template <size_t Cap>
+static Result run(uint32_t n, bool retry, uint32_t consumerPauseEvery, SpscRing<Item, Cap> &q) {
+    Result r = {};
+    std::atomic<bool> started{false}, done{false};
+
+    std::thread consumer([&] {
+        Item it;
+        int64_t last = -1;
+        started.store(true, std::memory_order_release);
+        for (;;) {
+            if (!q.pop(it)) {
+                if (done.load(std::memory_order_acquire) && !q.pop(it)) break;
+                std::this_thread::yield();
+                continue;
+            }
+            if (!intact(it)) r.torn++;
+            if ((int64_t)it.seq <= last) r.outOfOrder++;
+            else if ((int64_t)it.seq > last + 1) r.gaps++;
+            last = it.seq;
+            r.consumed++;
+            if (consumerPauseEvery && r.consumed % consumerPauseEvery == 0) {
+                std::this_thread::sleep_for(std::chrono::microseconds(50));
+            }
+        }
+    });
+
+    while (!started.load(std::memory_order_acquire)) std::this_thread::yield();
+    for (uint32_t i = 0; i < n; i++) {
+        for (;;) {
+            r.attempts++;
+            if (q.push(makeItem(i))) {
+                r.accepted++;
+                size_t s = q.size();
+                if (s > r.maxSeenSize) r.maxSeenSize = s;
+                break;
+            }
+            r.rejected++;
+            if (!retry) break;
+            std::this_thread::yield();
+        }
+        if (!retry) {
+            // Ritmo de produção de ~1 µs por item, para o consumidor acompanhar fora das pausas.
+            auto until = std::chrono::steady_clock::now() + std::chrono::microseconds(1);
+            while (std::chrono::steady_clock::now() < until) {}
+        }
+    }
+    done.store(true, std::memory_order_release);
+    consumer.join();
+    return r;
+}
+
+template <size_t Cap>
+static void checkResult(const char *name, const Result &r, const SpscRing<Item, Cap> &q, bool expectOverflow) {
+    printf("%-12s tentativas=%u aceitos=%u recusados=%u consumidos=%u lacunas=%u marca=%zu/%zu\n",
+        name, r.attempts, r.accepted, r.rejected, r.consumed, r.gaps, q.highWater(), Cap);
+    CHECK_EQ(r.torn, 0);
+    CHECK_EQ(r.outOfOrder, 0);
+    CHECK_EQ(r.consumed, r.accepted);
+    CHECK_EQ(q.pushed(), r.accepted);
+    CHECK_EQ(q.overflows(), r.rejected);
+    CHECK_EQ(r.accepted + r.rejected, r.attempts);
+    CHECK_EQ(q.size(), 0);
+    CHECK(q.highWater() <= Cap);
+    CHECK(q.highWater() >= r.maxSeenSize);   // size() após o push é um limite inferior
+    if (expectOverflow) {
+        CHECK(r.rejected > 0);
+        // Só se descarta com a fila cheia, e o produtor vê a fila cheia antes.
+        CHECK_EQ(q.highWater(), Cap);
+    }
+}
+
+int main(int argc, char **argv) {
+    const uint32_t n = argc > 1 ? strtoul(argv[1], nullptr, 10) : 2000000;
+
+    testSingleThread();
+
+    {
+        // O produtor repete os itens recusados: todos chegam, em ordem e sem
+        // lacunas, e cada recusa conta um overflow.
+        static SpscRing<Item, 64> q;
+        Result r = run(n, true, 0, q);
+        checkResult("repetindo", r, q, false);
+        CHECK_EQ(r.accepted, n);
+        CHECK_EQ(r.gaps, 0);
+    }
+    {
+        // Consumidor com pausas, como o loop() preso numa escrita da flash:
+        // a fila enche e o produtor descarta.
+        static SpscRing<Item, 16> q;
+        Result r = run(n / 10, false, 64, q);
+        checkResult("com_pausas", r, q, true);
+        CHECK(r.gaps > 0);
+    }
+    return CHECK_EXIT();
+}
@@ -0,0 +1,383 @@
+#include "acquisition.h"
+#include "spsc_ring.h"
+#include "seqlock.h"
+#include "sched.h"
+#include "metrics.h"
+#include "replay.h"
+#include "timebase.h"
+
+static constexpr BaseType_t ACQ_CORE = 0;       // loop() e os consumidores rodam no núcleo 1
+static constexpr UBaseType_t ACQ_PRIORITY = 5;  // Acima do loopTask (1) e do AsyncTCP (3)
+static constexpr uint32_t ACQ_STACK = 4096;
+static constexpr uint16_t REPLAY_BURST = 64;     // Máximo de amostras reproduzidas por tick
+static constexpr uint32_t CAPTURE_SLACK_MS = 1000;   // Folga do prazo da captura além dos períodos
+
+// ~32 s de folga a 2Hz (~13 s no nível rápido) caso o consumidor trave (flush lento, cliente WS preso).
+static SpscRing<CellSample, 64> ring;
+static uint32_t clockMs() { return millis(); }
+static SampleScheduler sched(clockMs);   // Só a tarefa de aquisição acessa depois de ACQ_start()
+static SchedConfig schedCfg = SCHED_DEFAULT_CONFIG;
+static volatile uint8_t rateLevel = SCHED_NORMAL;
+static volatile uint32_t rateChanges = 0;
+static TaskHandle_t acqHandle = nullptr;
+static volatile uint32_t errorTotal = 0;
+
+// A tarefa é a única dona do ADS1115. As outras tarefas leem o snapshot e
+// pedem o resto (captura bruta, calibração) pela fila de pedidos.
+enum AcqReqType : uint8_t { REQ_CAPTURE, REQ_SET_KDIV, REQ_SET_PROFILE, REQ_REPLAY_START, REQ_REPLAY_STOP };
+
+struct AcqRequest {
+    AcqReqType type;
+    uint8_t    samples;   // REQ_CAPTURE
+    uint32_t   id;        // REQ_CAPTURE: casa a resposta com o pedido
+    float      k[PACK_CELLS];   // REQ_SET_KDIV
+    AdsProfile profile;   // REQ_SET_PROFILE
+    ReplayConfig replay;  // REQ_REPLAY_START
+};
+
+struct AcqCapture {
+    uint32_t        id;
+    AcqCaptureState state;
+    float           raw[PACK_CELLS];
+};
+
+static SeqLock<AcqSnapshot> snapshot;
+static SeqLock<AdsProfile> profileSnap;   // Último perfil aceito, para leitura de outras tarefas
+static QueueHandle_t reqQueue = nullptr;
+static SeqLock<AcqCapture> capSnap;   // Estado da última captura, publicado pela tarefa
+
+// Reprodução em andamento: substitui o ADC enquanto ativa (só a tarefa acessa).
+static ReplaySource replay;
+static ReplayStats replayStats = {};
+static uint32_t replayStartMs = 0;
+static SeqLock<ReplayStats> replaySnap;
+
+static void publishReplay() {
+    replayStats.rows = replay.rows();
+    replayStats.badRows = replay.badRows();
+    replayStats.recordedMs = replay.recordedMs();
+    replayStats.elapsedMs = millis() - replayStartMs;
+    replaySnap.store(replayStats);
+}
+
+static void startReplay(const ReplayConfig &cfg) {
+    replayStats = {};
+    replayStats.speed = cfg.speed;
+    replayStartMs = millis();
+    if (replay.open(cfg, replayStartMs)) {
+        replayStats.state = RPL_RUNNING;
+        Serial.printf("[RPL] Reproduzindo %s (velocidade %s%u)\n", cfg.path,
+            cfg.speed ? "x" : "máxima, contrapressão da fila", (unsigned)cfg.speed);
+    } else {
+        replayStats.state = RPL_ERROR;
+        Serial.printf("[RPL] Não foi possível abrir %s\n", cfg.path);
+    }
+    publishReplay();
+}
+
+static void endReplay(ReplayState st) {
+    replay.close();
+    replayStats.state = st;
+    publishReplay();
+    const ReplayStats &r = replayStats;
+    Serial.printf("[RPL] Fim: %lu amostras em %lu ms (%lu amostras/s), %lu descartadas, pico da fila %u/%u\n",
+        (unsigned long)r.fed, (unsigned long)r.elapsedMs,
+        (unsigned long)(r.elapsedMs ? (uint64_t)r.fed * 1000 / r.elapsedMs : 0),
+        (unsigned long)r.dropped, (unsigned)ring.highWater(), (unsigned)ring.capacity());
+}
+
+// Entrega as amostras vencidas da reprodução à fila, como o ADC faria. Em
+// velocidade máxima só produz enquanto há espaço (mede a vazão sustentada);
+// nas outras, a fila cheia descarta e conta.
+static void replayStep() {
+    const uint32_t now = millis();
+    for (uint16_t k = 0; k < REPLAY_BURST; k++) {
+        if (!replayStats.speed && ring.size() >= ring.capacity()) break;
+        CellSample s;
+        int8_t r = replay.next(now, s);
+        if (r < 0) {
+            endReplay(RPL_DONE);
+            return;
+        }
+        if (r == 0) break;
+        bool provisional;
+        s.epochMs = TIME_nowMs(&provisional);
+        s.flags = SAMPLE_FLAG_REPLAY | (provisional ? SAMPLE_FLAG_PROVISIONAL : 0);
+        if (ring.push(s)) replayStats.fed++;
+        else replayStats.dropped++;
+    }
+    static uint32_t lastPublish = 0;
+    if (now - lastPublish >= 100) {
+        publishReplay();
+        lastPublish = now;
+    }
+}
+
+// Captura em andamento (só a tarefa de aquisição acessa).
+static struct {
+    uint32_t id = 0;
+    uint8_t  want = 0;
+    uint8_t  got = 0;
+    uint32_t deadline = 0;
+    int64_t  sumQ4[PACK_CELLS] = {0};
+} capture;
+
+// Publica o estado da captura 'id' e, se ela terminou, libera o nível do escalonador.
+static void publishCapture(uint32_t id, AcqCaptureState st, const float *raw = nullptr) {
+    AcqCapture c = {};
+    c.id = id;
+    c.state = st;
+    if (raw) memcpy(c.raw, raw, sizeof(c.raw));
+    capSnap.store(c);
+    if (st != CAP_RUNNING) {
+        capture.want = 0;
+        sched.setFloor(SCHED_SLOW);
+    }
+}
+
+static void startCapture(uint32_t id, uint8_t samples) {
+    if (capture.want) publishCapture(capture.id, CAP_FAILED);   // Substituída
+    if (replay.active()) {
+        publishCapture(id, CAP_FAILED);   // Amostras reproduzidas não servem para calibrar
+        return;
+    }
+    capture.id = id;
+    capture.want = samples ? samples : 1;
+    capture.got = 0;
+    memset(capture.sumQ4, 0, sizeof(capture.sumQ4));
+    // No lento (2 s) uma captura de 6 aquisições levaria 12 s: força o normal.
+    sched.setFloor(SCHED_NORMAL);
+    capture.deadline = millis() + capture.want * sched.periodOf(SCHED_NORMAL) * 2 + CAPTURE_SLACK_MS;
+    publishCapture(id, CAP_RUNNING);
+}
+
+// Menor período que comporta uma aquisição com o perfil (10% livres para a fila e o I2C extra).
+static uint32_t minPeriodMs(const AdsProfile &p) {
+    return (ADS_sampleTimeUs(p) + 899) / 900;
+}
+
+static void serveRequests() {
+    AcqRequest req;
+    while (xQueueReceive(reqQueue, &req, 0) == pdTRUE) {
+        if (req.type == REQ_SET_KDIV) {
+            ADS_setKDiv(req.k);
+        } else if (req.type == REQ_SET_PROFILE) {
+            ADS_setProfile(req.profile);
+            sched.setMinPeriod(minPeriodMs(req.profile));
+        } else if (req.type == REQ_REPLAY_START) {
+            if (capture.want) publishCapture(capture.id, CAP_FAILED);
+            startReplay(req.replay);
+        } else if (req.type == REQ_REPLAY_STOP) {
+            if (replay.active()) endReplay(RPL_IDLE);
+        } else if (req.type == REQ_CAPTURE) {
+            startCapture(req.id, req.samples);
+        }
+    }
+    if (capture.want && (int32_t)(millis() - capture.deadline) >= 0) {
+        Serial.printf("[ACQ] Captura %lu expirou (%u de %u aquisições)\n", (unsigned long)capture.id,
+            (unsigned)capture.got, (unsigned)capture.want);
+        publishCapture(capture.id, CAP_FAILED);
+    }
+}
+
+// Publica o snapshot e alimenta a captura em andamento.
+static void publish(const CellSample &s) {
+    int32_t rawQ4[PACK_CELLS];
+    ADS_lastRaw(rawQ4);
+
+    AcqSnapshot snap;
+    snap.epochMs = s.epochMs;
+    for (uint8_t ch = 0; ch < PACK_CELLS; ch++) {
+        snap.raw[ch] = (int16_t)((rawQ4[ch] + 8) >> 4);
+        snap.mv[ch] = s.mv[ch];
+    }
+    snap.total = s.total;
+    snap.flags = s.flags;
+    snapshot.store(snap);
+
+    if (capture.want) {
+        for (uint8_t ch = 0; ch < PACK_CELLS; ch++) capture.sumQ4[ch] += rawQ4[ch];
+        if (++capture.got == capture.want) {
+            float raw[PACK_CELLS];
+            for (uint8_t ch = 0; ch < PACK_CELLS; ch++) raw[ch] = capture.sumQ4[ch] / (16.0f * capture.got);
+            publishCapture(capture.id, CAP_DONE, raw);
+        }
+    }
+}
+
+static void acqTask(void *) {
+    uint32_t errorCount = 0;
+    CellSample s;
+
+    for (;;) {
+        serveRequests();
+
+        if (replay.active()) {
+            replayStep();
+            vTaskDelay(1);
+            continue;
+        }
+
+        // Não espera o NTP: antes dele as amostras saem com timestamp provisório (timebase.h).
+        if (sched.due()) ADS_startSample();
+
+        AdsStatus st = ADS_poll(s);
+        if (st == ADS_READY) {
+            // Leitura bem-sucedida, reseta o contador de erros.
+            errorCount = 0;
+            // Marca a taxa em que a amostra foi colhida e reavalia o nível.
+            s.flags = (uint8_t)((s.flags & ~SAMPLE_FLAG_RATE_MASK) | (sched.level() << SAMPLE_FLAG_RATE_SHIFT));
+            sched.observe(s.mv);
+            if (sched.level() != rateLevel) {
+                Serial.printf("[ACQ] Taxa: %s (%u ms, dV/dt %u mV/s)\n",
+                    SCHED_name(sched.level()), (unsigned)sched.periodMs(), sched.lastDvdt());
+                rateLevel = sched.level();
+                rateChanges = sched.transitions();
+            }
+            publish(s);
+            ring.push(s);
+        } else if (st == ADS_ERROR) {
+            errorCount++;
+            errorTotal++;
+            MET_COUNT(MET_ADS_ERROR);
+            Serial.printf("[ACQ] Erro na leitura do ADC (%d erros)\n", errorCount);
+            // Se o ADC falhar muitas vezes seguidas, algo está errado. Reinicia pra tentar recuperar.
+            if (errorCount > 10) {
+                Serial.println("[ACQ] Muitos erros consecutivos, reiniciando...");
+                ESP.restart();
+            }
+        }
+
+        // Cede a CPU até o próximo tick; a conversão leva ~8 ms @ 128 SPS.
+        vTaskDelay(1);
+    }
+}
+
+void ACQ_setSchedule(const SchedConfig &cfg) {
+    if (acqHandle) return;
+    schedCfg = cfg;
+}
+
+bool ACQ_start() {
+    if (acqHandle) return true;
+    AdsProfile p;
+    ACQ_getProfile(p);
+    sched.configure(schedCfg);
+    sched.setMinPeriod(minPeriodMs(p));
+    reqQueue = xQueueCreate(4, sizeof(AcqRequest));
+    if (!reqQueue) {
+        Serial.println("[ACQ] Falha ao criar fila de pedidos");
+        return false;
+    }
+    BaseType_t ok = xTaskCreatePinnedToCore(acqTask, "acq", ACQ_STACK, nullptr,
+                                            ACQ_PRIORITY, &acqHandle, ACQ_CORE);
+    if (ok != pdPASS) {
+        Serial.println("[ACQ] Falha ao criar tarefa de aquisição");
+        acqHandle = nullptr;
+        return false;
+    }
+    return true;
+}
+
+bool ACQ_pop(CellSample &out) {
+    return ring.pop(out);
+}
+
+void ACQ_getStats(AcqStats &st) {
+    st.produced = ring.pushed();
+    st.overflows = ring.overflows();
+    st.errors = errorTotal;
+    st.depth = ring.size();
+    st.highWater = ring.highWater();
+    st.capacity = ring.capacity();
+    st.rateLevel = rateLevel;
+    st.rateChanges = rateChanges;
+}
+
+bool ACQ_snapshot(AcqSnapshot &out) {
+    return snapshot.load(out);
+}
+
+// Última captura pedida (só a tarefa AsyncTCP chama o início).
+static uint32_t lastCaptureId = 0;
+
+uint32_t ACQ_captureStart(uint8_t samples) {
+    if (!acqHandle) return 0;
+    if (lastCaptureId && ACQ_capturePoll(lastCaptureId, nullptr) == CAP_RUNNING) return 0;
+    ReplayStats rs;
+    ACQ_getReplayStats(rs);
+    if (rs.state == RPL_RUNNING) return 0;
+
+    AcqRequest req = {};
+    req.type = REQ_CAPTURE;
+    req.samples = samples;
+    req.id = lastCaptureId + 1;
+    if (xQueueSend(reqQueue, &req, 0) != pdTRUE) return 0;
+    return lastCaptureId = req.id;
+}
+
+AcqCaptureState ACQ_capturePoll(uint32_t id, float *raw) {
+    AcqCapture c;
+    if (!capSnap.load(c) || c.id < id) return CAP_RUNNING;   // A tarefa ainda não leu o pedido
+    if (c.id > id) return CAP_FAILED;
+    if (c.state == CAP_DONE && raw) memcpy(raw, c.raw, sizeof(c.raw));
+    return c.state;
+}
+
+bool ACQ_setKDiv(const float *k) {
+    if (!acqHandle) {
+        ADS_setKDiv(k);   // Tarefa ainda não existe: ninguém mais usa o ADC
+        return true;
+    }
+    AcqRequest req = {};
+    req.type = REQ_SET_KDIV;
+    memcpy(req.k, k, sizeof(req.k));
+    return xQueueSend(reqQueue, &req, pdMS_TO_TICKS(100)) == pdTRUE;
+}
+
+bool ACQ_setProfile(const AdsProfile &wanted) {
+    AdsProfile p = wanted;
+    ADS_clampProfile(p);
+    // O nível rápido pode ficar mais lento que o configurado (setMinPeriod),
+    // mas a aquisição tem que caber no período normal.
+    uint32_t normalMs = schedCfg.periodMs[SCHED_NORMAL];
+    if (minPeriodMs(p) > normalMs) {
+        Serial.printf("[ACQ] Perfil rejeitado: aquisição de %u ms não cabe no período de %u ms\n",
+            (unsigned)(ADS_sampleTimeUs(p) / 1000), (unsigned)normalMs);
+        return false;
+    }
+    if (!acqHandle) {
+        ADS_setProfile(p);
+    } else {
+        AcqRequest msg = {};
+        msg.type = REQ_SET_PROFILE;
+        msg.profile = p;
+        if (xQueueSend(reqQueue, &msg, pdMS_TO_TICKS(100)) != pdTRUE) return false;
+    }
+    profileSnap.store(p);
+    return true;
+}
+
+bool ACQ_startReplay(const ReplayConfig &cfg) {
+    if (!acqHandle) return false;
+    AcqRequest req = {};
+    req.type = REQ_REPLAY_START;
+    req.replay = cfg;
+    req.replay.path[sizeof(req.replay.path) - 1] = '\0';
+    return xQueueSend(reqQueue, &req, pdMS_TO_TICKS(100)) == pdTRUE;
+}
+
+bool ACQ_stopReplay() {
+    if (!acqHandle) return false;
+    AcqRequest req = {};
+    req.type = REQ_REPLAY_STOP;
+    return xQueueSend(reqQueue, &req, pdMS_TO_TICKS(100)) == pdTRUE;
+}
+
+void ACQ_getReplayStats(ReplayStats &st) {
+    if (!replaySnap.load(st)) st = {};
+}
+
+void ACQ_getProfile(AdsProfile &p) {
+    if (!profileSnap.load(p)) p = ADS_DEFAULT_PROFILE;
+}
@@ -0,0 +1,136 @@
+#pragma once
+#include "ads_driver.h"
+#include "sched.h"
+#include "replay.h"
+
+/**
+ * Estatísticas da fila entre a aquisição e os consumidores.
+ */
+struct AcqStats {
+    uint32_t produced;    // Amostras publicadas na fila
+    uint32_t overflows;   // Amostras descartadas por fila cheia
+    uint32_t errors;      // Aquisições com erro de ADC
+    uint16_t depth;       // Ocupação atual da fila
+    uint16_t highWater;   // Maior ocupação já observada
+    uint16_t capacity;    // Capacidade da fila
+    uint8_t  rateLevel;   // Nível atual do escalonador (SchedLevel)
+    uint32_t rateChanges; // Trocas de nível desde o boot
+};
+
+/**
+ * Define os períodos e limiares do escalonador adaptativo. Só tem efeito
+ * antes de ACQ_start().
+ * @param cfg Configuração do escalonador.
+ */
+void ACQ_setSchedule(const SchedConfig &cfg);
+
+/**
+ * Cria a tarefa de aquisição, fixada em um núcleo dedicado. A tarefa dispara
+ * ADS_startSample() no período escolhido pelo escalonador (sched.h), conduz ADS_poll() e publica as
+ * amostras completas numa fila SPSC lock-free.
+ * @return true se a tarefa foi criada, false em caso de erro.
+ */
+bool ACQ_start();
+
+/**
+ * Retira a amostra mais antiga da fila (somente o consumidor chama).
+ * @param out Estrutura que recebe a amostra.
+ * @return true se havia amostra, false se a fila estava vazia.
+ */
+bool ACQ_pop(CellSample &out);
+
+/**
+ * Lê as estatísticas da fila.
+ * @param st Estrutura a preencher.
+ */
+void ACQ_getStats(AcqStats &st);
+
+/**
+ * Última aquisição publicada pela tarefa, para leitura sem tocar no I2C.
+ */
+struct AcqSnapshot {
+    uint64_t epochMs;   // Timestamp da amostra
+    int16_t  raw[PACK_CELLS];   // Médias brutas do ADC (contagens, com oversampling)
+    uint16_t mv[PACK_CELLS];    // Tensões das células em mV
+    uint16_t total;     // Tensão total do pack em mV
+    uint8_t  flags;     // SAMPLE_FLAG_*
+};
+
+/**
+ * Lê a última aquisição (seqlock: não bloqueia nem espera o ADC).
+ * @param out Estrutura a preencher.
+ * @return true se já existe alguma aquisição.
+ */
+bool ACQ_snapshot(AcqSnapshot &out);
+
+/**
+ * Estado de uma captura bruta pedida com ACQ_captureStart().
+ */
+enum AcqCaptureState : uint8_t {
+    CAP_RUNNING,   // Pedida ou em andamento
+    CAP_DONE,      // Média pronta
+    CAP_FAILED     // Prazo esgotado, reprodução ativa ou substituída por outro pedido
+};
+
+/**
+ * Pede à tarefa de aquisição a média bruta das próximas aquisições, sem
+ * esperar. Enquanto a captura corre, o escalonador fica no mínimo no nível
+ * normal, e o prazo sai do período desse nível (samples períodos, com folga).
+ * Chame sempre da mesma tarefa (AsyncTCP); só uma captura por vez.
+ * @param samples Aquisições a promediar.
+ * @return Identificador da captura, ou 0 se já há uma em andamento, a
+ *         reprodução está ativa ou o pedido não pôde ser enfileirado.
+ */
+uint32_t ACQ_captureStart(uint8_t samples);
+
+/**
+ * Consulta uma captura iniciada com ACQ_captureStart().
+ * @param id Identificador devolvido pelo início.
+ * @param raw Recebe a média de cada canal (contagens do ADC) quando CAP_DONE.
+ * @return Estado da captura.
+ */
+AcqCaptureState ACQ_capturePoll(uint32_t id, float *raw);
+
+/**
+ * Aplica novos fatores de divisão pela tarefa de aquisição (dona do ADC).
+ * @param k Array de PACK_CELLS fatores.
+ * @return true se o pedido foi enfileirado.
+ */
+bool ACQ_setKDiv(const float *k);
+
+/**
+ * Troca o perfil de aquisição pela tarefa dona do ADC (vale a partir da
+ * próxima aquisição).
+ * @param p Novo perfil.
+ * @return false se uma aquisição com esse perfil não cabe no período de
+ *         amostragem ou se o pedido não pôde ser enfileirado.
+ */
+bool ACQ_setProfile(const AdsProfile &p);
+
+/**
+ * Lê o último perfil aceito por ACQ_setProfile().
+ * @param p Estrutura a preencher.
+ */
+void ACQ_getProfile(AdsProfile &p);
+
+/**
+ * Troca o ADC pela reprodução de uma captura em CSV até o fim do arquivo ou
+ * ACQ_stopReplay(). As amostras saem com o horário atual e a flag
+ * SAMPLE_FLAG_REPLAY pela mesma fila; o loop() as manda só ao dashboard
+ * (fora do log, dos agregados e dos alarmes).
+ * @param cfg Arquivo, velocidade e passadas.
+ * @return true se o pedido foi enfileirado.
+ */
+bool ACQ_startReplay(const ReplayConfig &cfg);
+
+/**
+ * Interrompe a reprodução e volta ao ADC.
+ * @return true se o pedido foi enfileirado.
+ */
+bool ACQ_stopReplay();
+
+/**
+ * Lê o andamento da última reprodução.
+ * @param st Estrutura a preencher.
+ */
+void ACQ_getReplayStats(ReplayStats &st);
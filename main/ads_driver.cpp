@@ -1,132 +1,317 @@
 #include "ads_driver.h"
+#include "ocv_table.h"
+#include "timebase.h"
+#include "metrics.h"
 #include <Wire.h>
-#include <math.h>
 
-static Adafruit_ADS1115 ads;
-static constexpr uint8_t N = 8;           // Oversampling count
-static constexpr float LSB = 0.1875f;     // mV/bit @ ±6.144V
-static float kDiv[4] = {1.042f, 2.109f, 3.023f, 4.033f};
+static constexpr int8_t RDY_PIN = -1;     // Pino ALERT/RDY do ADS1115 (-1 = consulta o bit OS via I2C)
+static constexpr uint32_t CONV_MARGIN_US = 100;
+static_assert(RDY_PIN < 0 || PACK_ADCS == 1, "O pino RDY só identifica o fim de conversão com um único ADC");
+
+// Taxas suportadas pelo ADS1115 e o valor do registrador de cada uma.
+static const struct { uint16_t sps; uint16_t reg; } kRates[] = {
+    {8, RATE_ADS1115_8SPS},     {16, RATE_ADS1115_16SPS},   {32, RATE_ADS1115_32SPS},
+    {64, RATE_ADS1115_64SPS},   {128, RATE_ADS1115_128SPS}, {250, RATE_ADS1115_250SPS},
+    {475, RATE_ADS1115_475SPS}, {860, RATE_ADS1115_860SPS},
+};
+
+// Perfil em uso e o pedido para a próxima aquisição (só a tarefa dona do ADC acessa).
+static AdsProfile profile = ADS_DEFAULT_PROFILE;
+static AdsProfile nextProfile = ADS_DEFAULT_PROFILE;
+static bool profileChanged = true;
+static uint32_t convUs = 1000000UL / 128 + CONV_MARGIN_US;   // Conversão + margem na taxa atual
+static int32_t iirQ4[PACK_CELLS];                             // Reiniciados em applyProfile()
+
+// Fator de conversão por canal em Q16 (ADS_scaleQ16), calculado uma vez em
+// ADS_setKDiv(); a conversão de cada amostra fica só em inteiros.
+// Os valores iniciais saem dos divisores nominais de pack_config.h.
+static struct ScaleQ16 {
+    int32_t q16[PACK_CELLS];
+    constexpr ScaleQ16() : q16{} {
+        for (uint8_t i = 0; i < PACK_CELLS; i++) q16[i] = ADS_scaleQ16(PACK_defaultKDiv(i));
+    }
+} scale;
+
+// Tabela OCV da química ativa, gerada em tempo de compilação (ocv_table.h).
+static constexpr OcvTable<OcvActive> ocv{};
 static bool isInitialized = false;
 
+static const uint16_t kMux[4] = {
+    ADS1X15_REG_CONFIG_MUX_SINGLE_0, ADS1X15_REG_CONFIG_MUX_SINGLE_1,
+    ADS1X15_REG_CONFIG_MUX_SINGLE_2, ADS1X15_REG_CONFIG_MUX_SINGLE_3
+};
+
+/**
+ * Os ADS1115 do pack e as leituras de cada célula numa aquisição.
+ *
+ * Cada passo dispara o mesmo canal em todos os chips que o usam e espera
+ * todos terminarem: as conversões correm em paralelo, então uma aquisição
+ * custa PACK_ROUND_CHANNELS conversões por rodada, qualquer que seja o
+ * número de chips. Os laços têm limites de compilação e desenrolam.
+ */
+template <uint8_t Cells, uint8_t Chips>
+struct AdsBank {
+    static_assert(Chips <= 8, "Máscara de pendências tem 8 bits");
+
+    Adafruit_ADS1115 chip[Chips];
+    int16_t  buf[Cells][FILTER_MAX_SAMPLES];   // Leituras válidas por célula
+    uint8_t  count[Cells];                     // Número de leituras válidas por célula
+    uint8_t  pending = 0;                      // Chips com a conversão do canal atual em andamento
+
+    static constexpr bool uses(uint8_t adc, uint8_t ch) { return adc * PACK_CH_PER_ADC + ch < Cells; }
+
+    bool begin(uint16_t rateReg) {
+        bool ok = true;
+        for (uint8_t a = 0; a < Chips; a++) {
+            if (!chip[a].begin(PACK_ADC_ADDR[a])) {
+                Serial.printf("[ADS] ADC 0x%02X não responde\n", PACK_ADC_ADDR[a]);
+                ok = false;
+                continue;
+            }
+            chip[a].setGain(GAIN_TWOTHIRDS);  // ±6.144V range
+            chip[a].setDataRate(rateReg);
+        }
+        return ok;
+    }
+
+    void setDataRate(uint16_t rateReg) {
+        for (uint8_t a = 0; a < Chips; a++) chip[a].setDataRate(rateReg);
+    }
+
+    // Dispara a conversão single-shot do canal 'ch' em todos os chips que o usam.
+    void start(uint8_t ch) {
+        pending = 0;
+        for (uint8_t a = 0; a < Chips; a++) {
+            if (!uses(a, ch)) continue;
+            chip[a].startADCReading(kMux[ch], /*continuous=*/false);
+            pending |= 1 << a;
+        }
+    }
+
+    // Recolhe as conversões prontas do canal 'ch'. 'assumeDone' dispensa a
+    // consulta ao bit OS (fim sinalizado pelo pino RDY).
+    void collect(uint8_t ch, bool assumeDone) {
+        for (uint8_t a = 0; a < Chips; a++) {
+            if (!(pending & (1 << a))) continue;
+            if (!assumeDone && !chip[a].conversionComplete()) continue;
+            const uint8_t cell = a * PACK_CH_PER_ADC + ch;
+            buf[cell][count[cell]++] = chip[a].getLastConversionResults();
+            pending &= ~(1 << a);
+        }
+    }
+};
+
+// Estado da aquisição não bloqueante: um canal em conversão por vez em cada
+// chip, guardando as leituras de cada rodada para o filtro do perfil.
+enum class AcqState : uint8_t { Idle, Converting };
+static AdsBank<PACK_CELLS, PACK_ADCS> bank;
+static struct {
+    AcqState state = AcqState::Idle;
+    uint8_t  ch = 0;           // Canal em conversão
+    uint8_t  round = 0;        // Rodada de oversampling atual
+    uint32_t tStartUs = 0;     // Início da conversão em andamento
+    uint32_t tSampleUs = 0;    // Início da aquisição (métricas)
+} acq;
+
+static int32_t lastRawQ4[PACK_CELLS] = {0};   // Valores filtrados da última aquisição (contagens x 16)
+static volatile bool rdyFlag = false;
+
+static void IRAM_ATTR onAdsReady() {
+    rdyFlag = true;
+}
+
 void ADS_setKDiv(const float *k) {
     if (k != nullptr) {
-        memcpy(kDiv, k, 4 * sizeof(float));
+        for (uint8_t ch = 0; ch < PACK_CELLS; ch++) scale.q16[ch] = ADS_scaleQ16(k[ch]);
     }
 }
 
-static bool readSafe(uint8_t ch, int16_t &val) {
-    if (!isInitialized) {
-        Serial.println("[ADS] ADC não inicializado");
+// Taxa suportada mais próxima acima da pedida.
+static uint8_t rateIndex(uint16_t sps) {
+    uint8_t i = 0;
+    while (i + 1u < sizeof(kRates) / sizeof(kRates[0]) && kRates[i].sps < sps) i++;
+    return i;
+}
+
+void ADS_clampProfile(AdsProfile &p) {
+    p.dataRate = kRates[rateIndex(p.dataRate)].sps;
+    if (p.oversample < 1) p.oversample = 1;
+    if (p.oversample > FILTER_MAX_SAMPLES) p.oversample = FILTER_MAX_SAMPLES;
+    if (p.filter > FILTER_IIR) p.filter = FILTER_MEAN;
+    if (p.iirShift > 8) p.iirShift = 8;
+}
+
+void ADS_setProfile(const AdsProfile &p) {
+    nextProfile = p;
+    ADS_clampProfile(nextProfile);
+    profileChanged = true;
+}
+
+uint32_t ADS_sampleTimeUs(const AdsProfile &p) {
+    uint32_t conv = 1000000UL / kRates[rateIndex(p.dataRate)].sps + CONV_MARGIN_US;
+    return (uint32_t)PACK_ROUND_CHANNELS * p.oversample * conv;
+}
+
+// Aplica o perfil pendente (só com o ADC ocioso).
+static void applyProfile() {
+    profile = nextProfile;
+    profileChanged = false;
+    bank.setDataRate(kRates[rateIndex(profile.dataRate)].reg);
+    convUs = 1000000UL / profile.dataRate + CONV_MARGIN_US;
+    for (int32_t &s : iirQ4) s = INT32_MIN;
+    Serial.printf("[ADS] Perfil: %u SPS, %u leituras/canal, filtro %s (%u ms por aquisição)\n",
+        (unsigned)profile.dataRate, (unsigned)profile.oversample, FLT_name(profile.filter),
+        (unsigned)(ADS_sampleTimeUs(profile) / 1000));
+}
+
+// Reinicializa o barramento I2C e os ADS após uma falha de comunicação.
+static bool reinitBus() {
+    Wire.begin(42, 41, 50000);
+    if (!bank.begin(kRates[rateIndex(profile.dataRate)].reg)) {
+        Serial.println("[ADS] Falha ao reinicializar ADC");
         return false;
     }
-    
-    for (uint8_t t = 0; t < 3; ++t) {
-        val = ads.readADC_SingleEnded(ch);
-        if (val != 0xFFFF) return true;
-        delay(2);
-        
-        // Tenta reinicializar o ADS em caso de erro
-        Wire.begin(42, 41, 50000);
-        if (!ads.begin(0x48)) {
-            Serial.println("[ADS] Falha ao reinicializar ADC");
-            continue;
-        }
-        ads.setGain(GAIN_TWOTHIRDS);
-    }
-    Serial.printf("[ADS] Falha na leitura do canal %d\n", ch);
-    return false;
+    return true;
 }
 
 bool ADS_init() {
     Wire.begin(42, 41, 50000);    // 50 kHz I2C
     
-    if (!ads.begin(0x48)) {
+    if (!bank.begin(kRates[rateIndex(profile.dataRate)].reg)) {
         Serial.println("[ADS] Falha ao inicializar ADC");
         isInitialized = false;
         return false;
     }
-    
-    ads.setGain(GAIN_TWOTHIRDS);  // ±6.144V range
+    Serial.printf("[ADS] %u células em %u ADC(s)\n", (unsigned)PACK_CELLS, (unsigned)PACK_ADCS);
+
+    // Com o pino ALERT/RDY ligado, o fim de conversão chega por interrupção
+    // e ADS_poll() não precisa consultar o barramento.
+    if (RDY_PIN >= 0) {
+        pinMode(RDY_PIN, INPUT_PULLUP);
+        attachInterrupt(digitalPinToInterrupt(RDY_PIN), onAdsReady, FALLING);
+    }
     isInitialized = true;
     return true;
 }
 
-// Função para converter tensão (mV) em SoC (%)
-// Baseado na fórmula: SoC(%) = (V_medida - 3.2) * 100 / (4.2 - 3.2)
-static uint8_t voltageToSoc(uint16_t mv) {
-    const float V_MAX = 4200.0f;
-    const float V_MIN = 3200.0f;
-    float voltage = (float)mv;
-    float soc_f = ((voltage - V_MIN) * 100.0f) / (V_MAX - V_MIN);
-    soc_f = fmaxf(0.0f, fminf(100.0f, soc_f));
-    return (uint8_t)soc_f;
+// SoC pela curva OCV da química: índice direto na grade uniforme + interpolação.
+uint8_t ADS_mvToSoc(uint16_t mv) {
+    return ocv.soc(mv);
 }
 
-bool ADS_getSample(CellSample &out) {
-    if (!isInitialized) {
-        Serial.println("[ADS] ADC não inicializado");
-        return false;
-    }
+// Dispara o canal atual em todos os chips e registra o instante.
+static void startConversion() {
+    if (RDY_PIN >= 0) rdyFlag = false;
+    bank.start(acq.ch);
+    acq.tStartUs = micros();
+}
 
-    int32_t acc[4] = {0};
-    int16_t raw;
-    uint8_t validSamples = 0;
+// Conclui a aquisição: converte os acumuladores em tensões e publica a amostra.
+static AdsStatus finishSample(CellSample &out) {
+    acq.state = AcqState::Idle;
 
-    // Accumulate samples for oversampling
-    for (uint8_t i = 0; i < N; i++) {
-        bool sampleValid = true;
-        for (uint8_t ch = 0; ch < 4; ch++) {
-            if (!readSafe(ch, raw)) {
-                sampleValid = false;
-                break;
-            }
-            acc[ch] += raw;
+    out.flags = 0;
+    for (uint8_t ch = 0; ch < PACK_CELLS; ch++) {
+        if (bank.count[ch] == 0 || bank.count[ch] < profile.oversample / 2) {
+            Serial.printf("[ADS] Muitas amostras inválidas no canal %d: %d/%d\n", ch+1, bank.count[ch], profile.oversample);
+            return ADS_ERROR;
         }
-        if (sampleValid) validSamples++;
-        delayMicroseconds(125);
+        if (bank.count[ch] < profile.oversample) out.flags |= SAMPLE_FLAG_PARTIAL;
     }
 
-    if (validSamples < N/2) {
-        Serial.printf("[ADS] Muitas amostras inválidas: %d/%d\n", validSamples, N);
-        return false;
-    }
+    bool provisional;
+    out.epochMs = TIME_nowMs(&provisional);
+    if (provisional) out.flags |= SAMPLE_FLAG_PROVISIONAL;
 
-    out.epochMs = millis();
-    
     // Calculate absolute voltages
-    uint16_t vAbs[4];
-    const uint16_t minV[4] = {3400, 6800,  10200, 13600};
-    const uint16_t maxV[4] = {4200, 8400, 12600, 16800};
-    for (uint8_t ch = 0; ch < 4; ch++) {
-        float avg = (float)acc[ch] / validSamples;
-        vAbs[ch] = (uint16_t)(avg * LSB * kDiv[ch]);
-        
+    uint16_t vAbs[PACK_CELLS];
+    for (uint8_t ch = 0; ch < PACK_CELLS; ch++) {
+        int32_t q4 = FLT_apply(profile.filter, bank.buf[ch], bank.count[ch]);
+        if (profile.filter == FILTER_IIR) q4 = FLT_iir(iirQ4[ch], q4, profile.iirShift);
+        lastRawQ4[ch] = q4;
+        vAbs[ch] = ADS_q4ToMv(q4, scale.q16[ch]);
+
         // Validação básica das tensões absolutas por canal
-        if (vAbs[ch] < minV[ch] || vAbs[ch] > maxV[ch]) {
+        if (vAbs[ch] < PACK_tapMinMv(ch) || vAbs[ch] > PACK_tapMaxMv(ch)) {
             Serial.printf("[ADS] Tensão absoluta suspeita no canal %d: %dmV\n", ch+1, vAbs[ch]);
+            out.flags |= SAMPLE_FLAG_RANGE;
         }
     }
 
     // Calculate differential voltages
     out.mv[0] = vAbs[0];
-    out.mv[1] = vAbs[1] - vAbs[0];
-    out.mv[2] = vAbs[2] - vAbs[1];
-    out.mv[3] = vAbs[3] - vAbs[2];
-    out.total = vAbs[3];
+    for (uint8_t i = 1; i < PACK_CELLS; i++) out.mv[i] = vAbs[i] - vAbs[i - 1];
+    out.total = vAbs[PACK_CELLS - 1];
     // Calcula o SoC para cada célula
-    for (int i = 0; i < 4; i++) {
-        out.soc[i] = voltageToSoc(out.mv[i]);
+    for (uint8_t i = 0; i < PACK_CELLS; i++) {
+        out.soc[i] = ADS_mvToSoc(out.mv[i]);
+    }
+    return ADS_READY;
+}
+
+bool ADS_startSample() {
+    if (!isInitialized) {
+        Serial.println("[ADS] ADC não inicializado");
+        return false;
     }
+    if (acq.state != AcqState::Idle) return false;
+
+    if (profileChanged) applyProfile();
+    memset(bank.count, 0, sizeof(bank.count));
+    acq.ch = 0;
+    acq.round = 0;
+    acq.state = AcqState::Converting;
+    acq.tSampleUs = micros();
+    startConversion();
     return true;
 }
 
-bool ADS_raw(int16_t *arr) {
-    if (!arr) return false;
-    
-    for (uint8_t i = 0; i < 4; i++) {
-        if (!readSafe(i, arr[i])) {
-            return false;
+AdsStatus ADS_poll(CellSample &out) {
+    if (acq.state == AcqState::Idle) return ADS_IDLE;
+
+    uint32_t elapsed = micros() - acq.tStartUs;
+    // Não ocupa o barramento antes do tempo nominal de conversão.
+    if (RDY_PIN >= 0) {
+        if (rdyFlag) bank.collect(acq.ch, true);
+    } else if (elapsed >= convUs) {
+        bank.collect(acq.ch, false);
+    }
+
+    if (bank.pending == 0) {
+        MET_RECORD(MET_ADS_CONV, micros() - acq.tStartUs);
+    } else if (elapsed < 4 * convUs) {
+        return ADS_BUSY;
+    } else {
+        // Conversão perdida: descarta só este canal dos chips atrasados nesta rodada
+        // e tenta recuperar o barramento.
+        for (uint8_t a = 0; a < PACK_ADCS; a++) {
+            if (bank.pending & (1 << a)) {
+                Serial.printf("[ADS] Timeout na conversão do canal %d\n", a * PACK_CH_PER_ADC + acq.ch + 1);
+                MET_COUNT(MET_ADS_TIMEOUT);
+            }
         }
+        reinitBus();
     }
-    return true;
-}
\ No newline at end of file
+
+    // Avança para o próximo canal / rodada
+    if (++acq.ch == PACK_ROUND_CHANNELS) {
+        acq.ch = 0;
+        if (++acq.round == profile.oversample) {
+            MET_RECORD(MET_ADS_SAMPLE, micros() - acq.tSampleUs);
+            return finishSample(out);
+        }
+    }
+    startConversion();
+    return ADS_BUSY;
+}
+
+bool ADS_getSample(CellSample &out) {
+    if (!ADS_startSample()) return false;
+    AdsStatus st;
+    while ((st = ADS_poll(out)) == ADS_BUSY) yield();
+    return st == ADS_READY;
+}
+
+void ADS_lastRaw(int32_t *rawQ4) {
+    memcpy(rawQ4, lastRawQ4, sizeof(lastRawQ4));
+}
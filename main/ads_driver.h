@@ -1,39 +1,143 @@
 #pragma once
 #include <Arduino.h>
 #include <Adafruit_ADS1X15.h>
+#include "filter.h"
+#include "pack_config.h"
 
 /**
  * Estrutura para armazenar uma amostra das células.
  */
 struct CellSample {
-    uint32_t epochMs;    // Timestamp em milissegundos
-    uint16_t mv[4];      // Tensões das células em mV
-    uint8_t  soc[4];     // SoC de cada célula em %
+    uint64_t epochMs;    // Timestamp Unix em milissegundos
+    uint16_t mv[PACK_CELLS];    // Tensões das células em mV
+    uint8_t  soc[PACK_CELLS];   // SoC de cada célula em %
     uint16_t total;      // Tensão total do pack
+    uint8_t  flags;      // Indicadores de qualidade (SAMPLE_FLAG_*)
 };
 
 /**
- * Inicializa o ADC.
- * @return true se bem sucedido, false em caso de erro.
+ * Perfil de aquisição: troca latência por ruído conforme o uso (p.ex. um
+ * perfil rápido durante ensaios de carga/descarga).
+ */
+struct AdsProfile {
+    uint16_t   dataRate;     // Taxa do ADS1115 em SPS (8..860; usa a taxa suportada mais próxima acima)
+    uint8_t    oversample;   // Leituras por canal em cada aquisição (1..FILTER_MAX_SAMPLES)
+    FilterType filter;       // Como combinar as leituras
+    uint8_t    iirShift;     // FILTER_IIR: constante de tempo em aquisições (2^shift)
+};
+
+static constexpr AdsProfile ADS_DEFAULT_PROFILE = {128, 8, FILTER_MEAN, 2};
+
+static constexpr float ADS_LSB_MV = 0.1875f;   // mV por contagem no ganho 2/3 (±6,144 V)
+
+/**
+ * Fator de conversão de um canal em Q16 (mV por contagem = LSB x kDiv),
+ * calculado uma vez por fator de calibração.
+ * @param kDiv Fator de divisão do canal.
+ */
+constexpr int32_t ADS_scaleQ16(float kDiv) { return (int32_t)(kDiv * ADS_LSB_MV * 65536.0f + 0.5f); }
+
+/**
+ * Converte uma leitura filtrada em mV só com inteiros: Q4 x Q16 = Q20, em 64 bits.
+ * Arredonda para o mV mais próximo: com o arredondamento do fator, o erro
+ * fica abaixo de 0,75 mV em toda a faixa (truncando passaria de 1 mV).
+ * @param q4 Contagens x 16 (como ADS_lastRaw()).
+ * @param scaleQ16 ADS_scaleQ16() do canal.
+ * @return Tensão em mV (0 para leituras negativas, saturada em 65535).
+ */
+inline uint16_t ADS_q4ToMv(int32_t q4, int32_t scaleQ16) {
+    int64_t mv = q4 > 0 ? ((int64_t)q4 * scaleQ16 + (1 << 19)) >> 20 : 0;
+    return mv > UINT16_MAX ? UINT16_MAX : (uint16_t)mv;
+}
+
+/**
+ * Resultado de uma chamada a ADS_poll().
+ */
+enum AdsStatus : uint8_t {
+    ADS_IDLE,     // Nenhuma aquisição em andamento
+    ADS_BUSY,     // Conversões em andamento, chame ADS_poll() novamente
+    ADS_READY,    // Amostra completa publicada em 'out'
+    ADS_ERROR     // Aquisição concluída, mas com muitas leituras inválidas
+};
+
+// O barramento I2C tem um único dono: a tarefa de aquisição (acquisition.h).
+// Depois de ACQ_start(), as funções abaixo só podem ser chamadas por ela;
+// as demais tarefas usam o snapshot e a fila de pedidos do ACQ_*.
+
+/**
+ * Inicializa os PACK_ADCS conversores do pack (pack_config.h).
+ * @return true se todos responderam, false em caso de erro.
  */
 bool ADS_init();
 
 /**
- * Obtém uma amostra das tensões das células.
+ * Troca o perfil de aquisição. Vale a partir da próxima ADS_startSample();
+ * uma aquisição em andamento termina com o perfil anterior.
+ * @param p Novo perfil (valores fora da faixa são limitados).
+ */
+void ADS_setProfile(const AdsProfile &p);
+
+/**
+ * Limita um perfil ao que o ADC suporta (taxa válida mais próxima acima,
+ * oversample em 1..FILTER_MAX_SAMPLES).
+ * @param p Perfil a ajustar.
+ */
+void ADS_clampProfile(AdsProfile &p);
+
+/**
+ * Duração nominal de uma aquisição completa com um perfil.
+ * @param p Perfil.
+ * @return Tempo em µs (PACK_ROUND_CHANNELS x oversample x conversão; os chips
+ *         convertem em paralelo, então não cresce com o número de ADCs).
+ */
+uint32_t ADS_sampleTimeUs(const AdsProfile &p);
+
+/**
+ * Inicia uma nova aquisição (oversample rodadas x PACK_ROUND_CHANNELS canais
+ * em cada ADC) sem bloquear.
+ * Apenas dispara o primeiro canal em todos os ADCs; o restante é conduzido
+ * por ADS_poll().
+ * @return true se a aquisição foi iniciada, false se o ADC não está pronto
+ *         ou se já existe uma aquisição em andamento.
+ */
+bool ADS_startSample();
+
+/**
+ * Avança a máquina de estados da aquisição. Nunca bloqueia esperando o ADC:
+ * se alguma conversão do canal atual ainda não terminou (pino ALERT/RDY ou
+ * bit OS do registrador de configuração), retorna ADS_BUSY imediatamente.
+ * @param out Estrutura que recebe a amostra quando o retorno é ADS_READY.
+ * @return Estado da aquisição após o passo.
+ */
+AdsStatus ADS_poll(CellSample &out);
+
+/**
+ * Obtém uma amostra das tensões das células (versão bloqueante).
+ * Equivale a ADS_startSample() seguido de ADS_poll() até o fim da aquisição.
  * @param out Estrutura para armazenar a amostra.
  * @return true se bem sucedido, false em caso de erro.
  */
 bool ADS_getSample(CellSample &out);
 
 /**
- * Obtém valores brutos do ADC.
- * @param arr Array para armazenar os valores brutos.
- * @return true se bem sucedido, false em caso de erro.
+ * Valores brutos filtrados (contagens do ADC, com oversampling) da última
+ * aquisição concluída por ADS_poll(), em Q4 (contagens x 16) para não perder
+ * a resolução extra do filtro.
+ * @param rawQ4 Array de PACK_CELLS posições.
+ */
+void ADS_lastRaw(int32_t *rawQ4);
+
+/**
+ * Converte a tensão de uma célula em estado de carga pela curva OCV da
+ * química configurada (ocv_table.h).
+ * @param mv Tensão da célula em mV.
+ * @return SoC em % (0–100).
  */
-bool ADS_raw(int16_t *arr);
+uint8_t ADS_mvToSoc(uint16_t mv);
 
 /**
- * Define os fatores de divisão de tensão para cada canal.
- * @param k Array de fatores de divisão.
+ * Define os fatores de divisão de tensão para cada canal. Os fatores são
+ * convertidos aqui para a escala inteira (Q16) usada na conversão.
+ * @param k Array de PACK_CELLS fatores de divisão.
  */
 void ADS_setKDiv(const float *k);
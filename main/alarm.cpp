@@ -0,0 +1,113 @@
+#include "alarm.h"
+#include <string.h>
+
+static uint16_t clampMv(uint32_t mv) {
+    return mv > UINT16_MAX ? UINT16_MAX : (uint16_t)mv;
+}
+
+AlarmConfig ALM_defaultConfig() {
+    const uint32_t lo = OcvTable<OcvActive>::MIN_MV, hi = PACK_CELL_MAX_MV;
+    AlarmConfig c{};
+    c.rule[ALM_CELL_UNDER] = {true, (uint16_t)lo, (uint16_t)(lo + 100), 2000};
+    c.rule[ALM_CELL_OVER]  = {true, (uint16_t)(hi + 30), (uint16_t)(hi - 20), 2000};
+    c.rule[ALM_IMBALANCE]  = {PACK_CELLS > 1, 150, 100, 5000};
+    c.rule[ALM_DVDT]       = {true, 50, 20, 3000};
+    c.rule[ALM_PACK_UNDER] = {true, clampMv(PACK_CELLS * lo), clampMv(PACK_CELLS * (lo + 100)), 2000};
+    c.rule[ALM_PACK_OVER]  = {true, clampMv(PACK_CELLS * (hi + 30)), clampMv(PACK_CELLS * (hi - 20)), 2000};
+    return c;
+}
+
+const char *ALM_kindName(uint8_t kind) {
+    switch (kind) {
+        case ALM_CELL_UNDER: return "cell_under";
+        case ALM_CELL_OVER:  return "cell_over";
+        case ALM_IMBALANCE:  return "imbalance";
+        case ALM_DVDT:       return "dvdt";
+        case ALM_PACK_UNDER: return "pack_under";
+        case ALM_PACK_OVER:  return "pack_over";
+        default:             return "?";
+    }
+}
+
+void AlarmEngine::configure(const AlarmConfig &cfg) {
+    cfg_ = cfg;
+    memset(st_, 0, sizeof(st_));
+    haveRef_ = false;
+    dvdt_ = 0;
+}
+
+// Avança o estado de um canal. Retorna true (e preenche 'ev') se o estado mudou.
+bool AlarmEngine::step(uint8_t ch, uint8_t kind, uint8_t cell, uint16_t v, const LogRecord &r, AlarmEvent &ev) {
+    const AlarmRule &rule = cfg_.rule[kind];
+    if (!rule.enabled) return false;
+    State &s = st_[ch];
+    const bool low = kind == ALM_CELL_UNDER || kind == ALM_PACK_UNDER;
+
+    // Inativo: procura o limiar de disparo. Ativo: o de normalização.
+    bool change = s.active ? (low ? v >= rule.clear : v <= rule.clear)
+                           : (low ? v <= rule.set : v >= rule.set);
+    if (!change) {
+        s.pending = false;
+        return false;
+    }
+    if (!s.pending || r.epochMs < s.since) {
+        s.pending = true;
+        s.since = r.epochMs;
+    }
+    if (r.epochMs - s.since < rule.debounceMs) return false;
+
+    s.active = !s.active;
+    s.pending = false;
+    ev = AlarmEvent{r.epochMs, v, kind, cell, (uint8_t)s.active, r.flags, {0, 0}};
+    if (s.active) s.raised = ev;
+    return true;
+}
+
+uint8_t AlarmEngine::evaluate(const LogRecord &r, AlarmEvent *out) {
+    uint16_t lo = r.mv[0], hi = r.mv[0];
+    for (uint8_t i = 1; i < PACK_CELLS; i++) {
+        if (r.mv[i] < lo) lo = r.mv[i];
+        if (r.mv[i] > hi) hi = r.mv[i];
+    }
+
+    // dV/dt da célula que mais variou desde a referência (janela mínima de 1 s).
+    if (!haveRef_ || r.epochMs < refMs_) {
+        memcpy(ref_, r.mv, sizeof(ref_));
+        refMs_ = r.epochMs;
+        haveRef_ = true;
+    }
+    uint64_t dt = r.epochMs - refMs_;
+    if (dt >= ALM_SLOPE_WINDOW_MS) {
+        uint32_t maxDv = 0;
+        for (uint8_t i = 0; i < PACK_CELLS; i++) {
+            uint32_t dv = r.mv[i] > ref_[i] ? r.mv[i] - ref_[i] : ref_[i] - r.mv[i];
+            if (dv > maxDv) {
+                maxDv = dv;
+                dvdtCell_ = i;
+            }
+        }
+        memcpy(ref_, r.mv, sizeof(ref_));
+        refMs_ = r.epochMs;
+        uint64_t rate = (uint64_t)maxDv * 1000 / dt;
+        dvdt_ = rate > UINT16_MAX ? UINT16_MAX : (uint16_t)rate;
+    }
+
+    uint8_t n = 0;
+    for (uint8_t i = 0; i < PACK_CELLS; i++) {
+        n += step(i, ALM_CELL_UNDER, i, r.mv[i], r, out[n]);
+        n += step(PACK_CELLS + i, ALM_CELL_OVER, i, r.mv[i], r, out[n]);
+    }
+    n += step(2 * PACK_CELLS, ALM_IMBALANCE, ALM_PACK, hi - lo, r, out[n]);
+    n += step(2 * PACK_CELLS + 1, ALM_DVDT, dvdtCell_, dvdt_, r, out[n]);
+    n += step(2 * PACK_CELLS + 2, ALM_PACK_UNDER, ALM_PACK, r.total, r, out[n]);
+    n += step(2 * PACK_CELLS + 3, ALM_PACK_OVER, ALM_PACK, r.total, r, out[n]);
+    return n;
+}
+
+uint8_t AlarmEngine::active(AlarmEvent *out) const {
+    uint8_t n = 0;
+    for (const State &s : st_) {
+        if (s.active) out[n++] = s.raised;
+    }
+    return n;
+}
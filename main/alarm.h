@@ -0,0 +1,113 @@
+#pragma once
+#include <stdint.h>
+#include "logfmt.h"
+
+/**
+ * Motor de alarmes: avalia regras de limiar a cada amostra, em O(células).
+ *
+ * Cada regra tem um limiar de disparo e um de normalização (histerese) e um
+ * tempo de confirmação (debounce): a condição precisa se manter por
+ * debounceMs seguidos, medidos pelos timestamps das amostras, antes de o
+ * alarme entrar ou sair. Só as mudanças de estado geram eventos.
+ *
+ * Regras por célula (sub/sobretensão) têm um estado por célula; as demais
+ * (desbalanceamento, dV/dt, tensão do pack) têm um estado só. O dV/dt é o da
+ * célula que mais variou, medido em janelas de ALM_SLOPE_WINDOW_MS como no
+ * escalonador (sched.h).
+ *
+ * Não depende do Arduino: roda em host sobre registros lidos do log.
+ */
+
+enum AlarmKind : uint8_t {
+    ALM_CELL_UNDER,   // Célula abaixo do limiar (mV)
+    ALM_CELL_OVER,    // Célula acima do limiar (mV)
+    ALM_IMBALANCE,    // Maior - menor célula (mV)
+    ALM_DVDT,         // Variação da célula mais rápida (mV/s)
+    ALM_PACK_UNDER,   // Tensão total abaixo do limiar (mV)
+    ALM_PACK_OVER,    // Tensão total acima do limiar (mV)
+    ALM_KINDS
+};
+
+static constexpr uint8_t ALM_PACK = 0xFF;   // AlarmEvent::cell das regras que não são de uma célula
+static constexpr uint32_t ALM_SLOPE_WINDOW_MS = 1000;
+
+struct AlarmRule {
+    bool     enabled;
+    uint16_t set;          // Limiar de disparo
+    uint16_t clear;        // Limiar de normalização (abaixo de 'set' nas regras de máximo, acima nas de mínimo)
+    uint32_t debounceMs;   // Tempo que a condição precisa durar para mudar o estado
+};
+
+struct AlarmConfig {
+    AlarmRule rule[ALM_KINDS];
+};
+
+/**
+ * Regras padrão, derivadas da curva da química ativa (ocv_table.h): subtensão
+ * no 0% de SoC, sobretensão 30 mV acima da carga completa, e as do pack
+ * multiplicadas pelo número de células.
+ */
+AlarmConfig ALM_defaultConfig();
+
+/**
+ * Mudança de estado de um alarme (16 bytes, também é o registro do log de eventos).
+ */
+struct AlarmEvent {
+    uint64_t epochMs;   // Timestamp da amostra que confirmou a mudança (como gravado no log)
+    uint16_t value;     // Valor medido nessa amostra (mV ou mV/s)
+    uint8_t  kind;      // AlarmKind
+    uint8_t  cell;      // Célula (0..PACK_CELLS-1) ou ALM_PACK
+    uint8_t  active;    // 1 = alarme entrou, 0 = normalizou
+    uint8_t  flags;     // Flags da amostra (SAMPLE_FLAG_*), para corrigir timestamps provisórios
+    uint8_t  reserved[2];
+};
+static_assert(sizeof(AlarmEvent) == 16, "AlarmEvent deve ter 16 bytes");
+
+// Estados independentes: um por célula nas regras de célula, um nas demais.
+static constexpr uint8_t ALM_CHANNELS = 2 * PACK_CELLS + (ALM_KINDS - 2);
+
+/**
+ * Nome da regra ("cell_under", "dvdt", ...), para JSON e configuração.
+ */
+const char *ALM_kindName(uint8_t kind);
+
+class AlarmEngine {
+public:
+    /** Aplica a configuração e zera os estados (nenhum alarme ativo). */
+    void configure(const AlarmConfig &cfg);
+
+    /**
+     * Avalia uma amostra.
+     * @param r Amostra (timestamps não decrescentes).
+     * @param out Recebe as mudanças de estado (até ALM_CHANNELS).
+     * @return Quantos eventos foram colocados em 'out'.
+     */
+    uint8_t evaluate(const LogRecord &r, AlarmEvent *out);
+
+    /**
+     * Alarmes ativos no momento.
+     * @param out Recebe um evento (o de disparo) por alarme ativo (até ALM_CHANNELS).
+     * @return Quantos alarmes estão ativos.
+     */
+    uint8_t active(AlarmEvent *out) const;
+
+    const AlarmConfig &config() const { return cfg_; }
+
+private:
+    struct State {
+        bool       active;
+        bool       pending;   // Condição de mudança presente desde 'since'
+        uint64_t   since;
+        AlarmEvent raised;    // Evento que ativou o alarme
+    };
+
+    bool step(uint8_t ch, uint8_t kind, uint8_t cell, uint16_t v, const LogRecord &r, AlarmEvent &ev);
+
+    AlarmConfig cfg_{};
+    State       st_[ALM_CHANNELS]{};
+    bool        haveRef_ = false;
+    uint16_t    ref_[PACK_CELLS] = {0};
+    uint64_t    refMs_ = 0;
+    uint16_t    dvdt_ = 0;
+    uint8_t     dvdtCell_ = 0;
+};
@@ -2,12 +2,14 @@
 #include <SPIFFS.h>
 #include <ArduinoJson.h>
 
+// Espaço para o /config.json completo (kDiv + seções dos outros módulos, inclusive as 6 regras de alarme e o coletor).
+static constexpr size_t DOC_SIZE = 2304 + JSON_ARRAY_SIZE(PACK_CELLS);
+
 /**
- * Tenta carregar os fatores de calibração kDiv a partir do /config.json.
- * Se o arquivo não existir ou estiver corrompido, a função retorna false
- * e o sistema deve usar os valores de calibração padrão.
+ * Lê e faz o parse do /config.json em 'doc'. Retorna false se o arquivo não
+ * existir, estiver vazio ou corrompido.
  */
-bool CFG_load(Calib &c) {
+static bool loadDoc(JsonDocument &doc) {
     File f = SPIFFS.open("/config.json");
     // Arquivo de config não encontrado, usa os valores default. Normal na primeira execução.
     if (!f) {
@@ -21,9 +23,6 @@ bool CFG_load(Calib &c) {
         return false;
     }
     
-    // Usar 256 bytes para o doc JSON, pra ter uma folga. 128 pode ser pouco no futuro.
-    StaticJsonDocument<256> doc;
-    
     // Tenta fazer o parse do JSON.
     DeserializationError error = deserializeJson(doc, f);
     f.close(); // Boa prática: fecha o arquivo assim que terminar a leitura.
@@ -33,6 +32,32 @@ bool CFG_load(Calib &c) {
         Serial.println(error.c_str());
         return false;
     }
+    return true;
+}
+
+/**
+ * Grava 'doc' no /config.json (substitui o arquivo inteiro).
+ */
+static void saveDoc(const JsonDocument &doc) {
+    File f = SPIFFS.open("/config.json", "w");
+    if (!f) {
+        Serial.println(F("[CFG] Erro ao abrir config.json para escrita"));
+        return;
+    }
+
+    // Escreve o JSON formatado no arquivo.
+    serializeJson(doc, f);
+    f.close();
+}
+
+/**
+ * Tenta carregar os fatores de calibração kDiv a partir do /config.json.
+ * Se o arquivo não existir ou estiver corrompido, a função retorna false
+ * e o sistema deve usar os valores de calibração padrão.
+ */
+bool CFG_load(Calib &c) {
+    DynamicJsonDocument doc(DOC_SIZE);
+    if (!loadDoc(doc)) return false;
 
     // O JSON deve ter um array chamado "k".
     JsonArray k_array = doc["k"];
@@ -41,8 +66,13 @@ bool CFG_load(Calib &c) {
         return false;
     }
 
-    // Lê os 4 valores do array e preenche a struct Calib.
-    for (int i = 0; i < 4; i++) {
+    // Lê um valor por célula e preenche a struct Calib. Um array de outro
+    // tamanho (config de outro pack) só sobrescreve as células que existem.
+    if (k_array.size() != PACK_CELLS) {
+        Serial.printf("[CFG] \"k\" tem %u fatores, o pack tem %u células\n",
+            (unsigned)k_array.size(), (unsigned)PACK_CELLS);
+    }
+    for (int i = 0; i < PACK_CELLS; i++) {
         JsonVariant k_val = k_array[i];
         
         // Se um dos valores no array for nulo, não sobrescreve o default.
@@ -55,25 +85,156 @@ bool CFG_load(Calib &c) {
     return true;
 }
 
+/**
+ * Lê a seção "log" do /config.json: {"maxLossMs": 30000, "batchBlocks": 8}.
+ * Campos ausentes mantêm o valor que já está em 'p'.
+ */
+bool CFG_loadLogPolicy(LogPolicy &p) {
+    DynamicJsonDocument doc(DOC_SIZE);
+    if (!loadDoc(doc)) return false;
+
+    JsonObject log = doc["log"];
+    if (log.isNull()) return false;
+    p.maxLossMs = log["maxLossMs"] | p.maxLossMs;
+    p.batchBlocks = log["batchBlocks"] | p.batchBlocks;
+    p.deviationMv = log["deviationMv"] | p.deviationMv;
+    p.heartbeatMs = log["heartbeatMs"] | p.heartbeatMs;
+    const char *mode = log["mode"];
+    if (mode) {
+        if (strcmp(mode, "all") == 0) p.mode = LOG_MODE_ALL;
+        else if (strcmp(mode, "deadband") == 0) p.mode = LOG_MODE_DEADBAND;
+        else if (strcmp(mode, "swingdoor") == 0) p.mode = LOG_MODE_SWINGDOOR;
+        else Serial.printf("[CFG] Modo de log desconhecido '%s'\n", mode);
+    }
+    return true;
+}
+
+bool CFG_loadRecentDepth(uint16_t &depth) {
+    DynamicJsonDocument doc(DOC_SIZE);
+    if (!loadDoc(doc)) return false;
+
+    JsonObject rec = doc["recent"];
+    if (rec.isNull()) return false;
+    depth = rec["depth"] | depth;
+    return true;
+}
+
 /**
  * Salva a estrutura de calibração 'c' no arquivo /config.json na SPIFFS.
- * O arquivo existente será sobrescrito.
+ * Só a chave "k" é substituída; as demais seções do arquivo são preservadas.
  */
 void CFG_save(const Calib &c) {
-    StaticJsonDocument<128> d;
+    DynamicJsonDocument d(DOC_SIZE);
+    loadDoc(d);   // Se não existir, começa de um documento vazio.
+
     // Cria o array "k" no objeto JSON.
     JsonArray k_array = d.createNestedArray("k");
-    for (int i = 0; i < 4; i++) {
+    for (int i = 0; i < PACK_CELLS; i++) {
         k_array.add(c.kDiv[i]);
     }
-    
-    File f = SPIFFS.open("/config.json", "w");
-    if (!f) {
-        Serial.println(F("[CFG] Erro ao abrir config.json para escrita"));
-        return;
+    saveDoc(d);
+}
+
+bool CFG_loadAcqProfile(AdsProfile &p) {
+    DynamicJsonDocument doc(DOC_SIZE);
+    if (!loadDoc(doc)) return false;
+
+    JsonObject acq = doc["acq"];
+    if (acq.isNull()) return false;
+    p.dataRate = acq["rate"] | p.dataRate;
+    p.oversample = acq["oversample"] | p.oversample;
+    p.iirShift = acq["iirShift"] | p.iirShift;
+    const char *filter = acq["filter"];
+    if (filter && !FLT_parse(filter, p.filter)) {
+        Serial.printf("[CFG] Filtro desconhecido '%s', mantendo %s\n", filter, FLT_name(p.filter));
     }
+    return true;
+}
 
-    // Escreve o JSON formatado no arquivo.
-    serializeJson(d, f);
-    f.close();
-}
\ No newline at end of file
+bool CFG_loadSchedConfig(SchedConfig &c) {
+    DynamicJsonDocument doc(DOC_SIZE);
+    if (!loadDoc(doc)) return false;
+
+    JsonObject sc = doc["sched"];
+    if (sc.isNull()) return false;
+    c.adaptive = sc["adaptive"] | c.adaptive;
+    c.periodMs[SCHED_SLOW] = sc["slowMs"] | c.periodMs[SCHED_SLOW];
+    c.periodMs[SCHED_NORMAL] = sc["normalMs"] | c.periodMs[SCHED_NORMAL];
+    c.periodMs[SCHED_FAST] = sc["fastMs"] | c.periodMs[SCHED_FAST];
+    c.dvdtUp = sc["dvdtUp"] | c.dvdtUp;
+    c.dvdtDown = sc["dvdtDown"] | c.dvdtDown;
+    c.imbalanceUp = sc["imbalanceUp"] | c.imbalanceUp;
+    c.imbalanceDown = sc["imbalanceDown"] | c.imbalanceDown;
+    c.holdMs = sc["holdMs"] | c.holdMs;
+    // Histerese exige limiar de descida abaixo do de subida.
+    if (c.dvdtDown > c.dvdtUp) c.dvdtDown = c.dvdtUp;
+    if (c.imbalanceDown > c.imbalanceUp) c.imbalanceDown = c.imbalanceUp;
+    return true;
+}
+
+bool CFG_loadAlarmConfig(AlarmConfig &c) {
+    DynamicJsonDocument doc(DOC_SIZE);
+    if (!loadDoc(doc)) return false;
+
+    JsonObject al = doc["alarms"];
+    if (al.isNull()) return false;
+    for (uint8_t k = 0; k < ALM_KINDS; k++) {
+        JsonObject o = al[ALM_kindName(k)];
+        if (o.isNull()) continue;
+        AlarmRule &r = c.rule[k];
+        r.enabled = o["enabled"] | r.enabled;
+        r.set = o["set"] | r.set;
+        r.clear = o["clear"] | r.clear;
+        r.debounceMs = o["debounceMs"] | r.debounceMs;
+        // Histerese exige normalizar do lado seguro do limiar de disparo.
+        bool low = k == ALM_CELL_UNDER || k == ALM_PACK_UNDER;
+        if (low ? r.clear < r.set : r.clear > r.set) r.clear = r.set;
+    }
+    return true;
+}
+
+bool CFG_loadUplinkConfig(UplinkConfig &c) {
+    DynamicJsonDocument doc(DOC_SIZE);
+    if (!loadDoc(doc)) return false;
+
+    JsonObject up = doc["uplink"];
+    if (up.isNull()) return false;
+    c.enabled = up["enabled"] | c.enabled;
+    c.port = up["port"] | c.port;
+    c.batchBlocks = up["batchBlocks"] | c.batchBlocks;
+    c.flushMs = up["flushMs"] | c.flushMs;
+    c.timeoutMs = up["timeoutMs"] | c.timeoutMs;
+    const char *host = up["host"];
+    if (host) strlcpy(c.host, host, sizeof(c.host));
+    const char *path = up["path"];
+    if (path) strlcpy(c.path, path, sizeof(c.path));
+    const char *mode = up["mode"];
+    if (mode) {
+        if (strcmp(mode, "http") == 0) c.mode = UPL_HTTP;
+        else if (strcmp(mode, "udp") == 0) c.mode = UPL_UDP;
+        else Serial.printf("[CFG] Modo de envio desconhecido '%s'\n", mode);
+    }
+    return true;
+}
+
+bool CFG_loadMetricsDump(uint32_t &sec) {
+    DynamicJsonDocument doc(DOC_SIZE);
+    if (!loadDoc(doc)) return false;
+
+    JsonObject met = doc["metrics"];
+    if (met.isNull()) return false;
+    sec = met["dumpSec"] | sec;
+    return true;
+}
+
+void CFG_saveAcqProfile(const AdsProfile &p) {
+    DynamicJsonDocument d(DOC_SIZE);
+    loadDoc(d);
+
+    JsonObject acq = d.createNestedObject("acq");
+    acq["rate"] = p.dataRate;
+    acq["oversample"] = p.oversample;
+    acq["filter"] = FLT_name(p.filter);
+    acq["iirShift"] = p.iirShift;
+    saveDoc(d);
+}
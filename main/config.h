@@ -1,12 +1,26 @@
 #pragma once
+#include "storage.h"
+#include "ads_driver.h"
+#include "sched.h"
+#include "alarm.h"
+#include "uplink.h"
 
 /**
  * Estrutura de calibração dos divisores de tensão.
  */
 struct Calib {
-    float kDiv[4];
+    float kDiv[PACK_CELLS];
 };
 
+/**
+ * Calibração nominal do pack (divisores de pack_config.h).
+ */
+inline Calib CFG_defaultCalib() {
+    Calib c{};
+    for (uint8_t i = 0; i < PACK_CELLS; i++) c.kDiv[i] = PACK_defaultKDiv(i);
+    return c;
+}
+
 /**
  * Carrega os fatores de calibração do arquivo de configuração.
  * @param c Estrutura para armazenar os fatores.
@@ -15,7 +29,66 @@ struct Calib {
 bool CFG_load(Calib &c);
 
 /**
- * Salva os fatores de calibração no arquivo de configuração.
+ * Carrega a política de gravação do log (seção "log" do arquivo de configuração).
+ * @param p Estrutura com os defaults; recebe os valores configurados.
+ * @return true se a seção existe, false caso contrário.
+ */
+bool CFG_loadLogPolicy(LogPolicy &p);
+
+/**
+ * Carrega a profundidade do anel de amostras recentes (seção "recent").
+ * @param depth Valor padrão; recebe o valor configurado.
+ * @return true se a seção existe, false caso contrário.
+ */
+bool CFG_loadRecentDepth(uint16_t &depth);
+
+/**
+ * Carrega o perfil de aquisição (seção "acq": rate, oversample, filter, iirShift).
+ * @param p Estrutura com os defaults; recebe os valores configurados.
+ * @return true se a seção existe, false caso contrário.
+ */
+bool CFG_loadAcqProfile(AdsProfile &p);
+
+/**
+ * Carrega o escalonador adaptativo (seção "sched": adaptive, slowMs, normalMs,
+ * fastMs, dvdtUp, dvdtDown, imbalanceUp, imbalanceDown, holdMs).
+ * @param c Estrutura com os defaults; recebe os valores configurados.
+ * @return true se a seção existe, false caso contrário.
+ */
+bool CFG_loadSchedConfig(SchedConfig &c);
+
+/**
+ * Carrega as regras de alarme (seção "alarms": um objeto por regra, com o
+ * nome de ALM_kindName() e os campos enabled, set, clear e debounceMs).
+ * @param c Estrutura com os defaults; recebe os valores configurados.
+ * @return true se a seção existe, false caso contrário.
+ */
+bool CFG_loadAlarmConfig(AlarmConfig &c);
+
+/**
+ * Carrega o envio ao coletor (seção "uplink": enabled, mode "http"|"udp",
+ * host, port, path, batchBlocks, flushMs, timeoutMs).
+ * @param c Estrutura com os defaults; recebe os valores configurados.
+ * @return true se a seção existe, false caso contrário.
+ */
+bool CFG_loadUplinkConfig(UplinkConfig &c);
+
+/**
+ * Carrega o intervalo do resumo de métricas no serial (seção "metrics": dumpSec).
+ * @param sec Valor padrão; recebe o valor configurado (0 = desligado).
+ * @return true se a seção existe, false caso contrário.
+ */
+bool CFG_loadMetricsDump(uint32_t &sec);
+
+/**
+ * Salva o perfil de aquisição, preservando as demais seções.
+ * @param p Perfil a salvar.
+ */
+void CFG_saveAcqProfile(const AdsProfile &p);
+
+/**
+ * Salva os fatores de calibração no arquivo de configuração,
+ * preservando as demais seções.
  * @param c Estrutura com os fatores a salvar.
  */
 void CFG_save(const Calib &c);
@@ -0,0 +1,116 @@
+#include "events.h"
+#include <SPIFFS.h>
+#include "seqlock.h"
+#include "timebase.h"
+#include "net.h"
+
+static constexpr const char *EVT_PATH = "/events.bin";
+static constexpr const char *EVT_OLD_PATH = "/events.old";
+static constexpr uint32_t EVT_FILE_MAX = 512;   // Eventos por arquivo (8 KB)
+
+// Alarmes ativos publicados pelo loop() para as consultas da API.
+struct AlarmStatus {
+    uint8_t    count;
+    AlarmEvent ev[ALM_CHANNELS];
+};
+
+static AlarmEngine engine;
+static SeqLock<AlarmStatus> status;
+static SemaphoreHandle_t fileMutex = nullptr;   // Append (loop) x leitura (AsyncTCP) e rotação
+
+struct EvtLock {
+    EvtLock()  { xSemaphoreTake(fileMutex, portMAX_DELAY); }
+    ~EvtLock() { xSemaphoreGive(fileMutex); }
+};
+
+void EVT_init(const AlarmConfig &cfg) {
+    if (!fileMutex) fileMutex = xSemaphoreCreateMutex();
+    engine.configure(cfg);
+    status.store(AlarmStatus{});
+    uint8_t on = 0;
+    for (const AlarmRule &r : cfg.rule) on += r.enabled;
+    Serial.printf("[ALM] %u regras ativas\n", (unsigned)on);
+}
+
+static void append(const AlarmEvent &e) {
+    EvtLock lock;
+    File f = SPIFFS.open(EVT_PATH, FILE_APPEND);
+    if (!f) {
+        Serial.println("[ALM] Erro ao abrir o log de eventos");
+        return;
+    }
+    f.write((const uint8_t *)&e, sizeof(e));
+    bool full = f.size() >= EVT_FILE_MAX * sizeof(AlarmEvent);
+    f.close();
+    if (full) {
+        // Guarda só o arquivo anterior: o log ocupa no máximo 2 x EVT_FILE_MAX eventos.
+        SPIFFS.remove(EVT_OLD_PATH);
+        SPIFFS.rename(EVT_PATH, EVT_OLD_PATH);
+    }
+}
+
+void EVT_process(const CellSample &s) {
+    // Amostras reproduzidas não são o pack: não disparam alarmes nem vão ao log de eventos.
+    if (s.flags & SAMPLE_FLAG_REPLAY) return;
+    LogRecord r;
+    r.epochMs = s.epochMs;
+    memcpy(r.mv, s.mv, sizeof(r.mv));
+    r.total = s.total;
+    r.flags = s.flags;
+
+    AlarmEvent ev[ALM_CHANNELS];
+    uint8_t n = engine.evaluate(r, ev);
+    if (!n) return;
+
+    for (uint8_t i = 0; i < n; i++) {
+        const AlarmEvent &e = ev[i];
+        if (e.cell == ALM_PACK) {
+            Serial.printf("[ALM] %s %s: %u\n", ALM_kindName(e.kind), e.active ? "ATIVO" : "normalizado", e.value);
+        } else {
+            Serial.printf("[ALM] %s %s na célula %u: %u\n", ALM_kindName(e.kind),
+                e.active ? "ATIVO" : "normalizado", (unsigned)e.cell + 1, e.value);
+        }
+        append(e);
+        NET_sendAlarm(e);
+    }
+    AlarmStatus st;
+    st.count = engine.active(st.ev);
+    status.store(st);
+}
+
+static void writeEvent(Print &out, const AlarmEvent &e, bool first) {
+    out.printf("%s{\"t\":%llu,\"kind\":\"%s\",", first ? "" : ",",
+        (unsigned long long)TIME_toWall(e.epochMs, e.flags), ALM_kindName(e.kind));
+    if (e.cell != ALM_PACK) out.printf("\"cell\":%u,", (unsigned)e.cell);
+    out.printf("\"active\":%s,\"value\":%u}", e.active ? "true" : "false", e.value);
+}
+
+void EVT_writeJson(Print &out, uint16_t maxEvents) {
+    AlarmStatus st;
+    status.load(st);
+    out.print("{\"active\":[");
+    for (uint8_t i = 0; i < st.count; i++) writeEvent(out, st.ev[i], i == 0);
+    out.print("],\"events\":[");
+
+    // Os mais novos estão no fim de /events.bin; o início pode estar em /events.old.
+    EvtLock lock;
+    File files[2] = {SPIFFS.open(EVT_OLD_PATH, FILE_READ), SPIFFS.open(EVT_PATH, FILE_READ)};
+    uint32_t total = 0;
+    for (File &f : files) if (f) total += f.size() / sizeof(AlarmEvent);
+    uint32_t skip = total > maxEvents ? total - maxEvents : 0;
+    bool first = true;
+    for (File &f : files) {
+        if (!f) continue;
+        uint32_t count = f.size() / sizeof(AlarmEvent);
+        uint32_t from = skip < count ? skip : count;
+        skip -= from;
+        f.seek(from * sizeof(AlarmEvent));
+        AlarmEvent e;
+        for (uint32_t i = from; i < count && f.read((uint8_t *)&e, sizeof(e)) == sizeof(e); i++) {
+            writeEvent(out, e, first);
+            first = false;
+        }
+        f.close();
+    }
+    out.print("]}");
+}
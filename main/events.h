@@ -0,0 +1,33 @@
+#pragma once
+#include <Arduino.h>
+#include "ads_driver.h"
+#include "alarm.h"
+
+/**
+ * Alarmes do pack: roda o motor de regras (alarm.h) sobre cada amostra,
+ * grava as mudanças de estado no log de eventos (/events.bin, registros de
+ * 16 bytes; ao encher, vira /events.old) e as envia aos clientes do
+ * WebSocket como mensagens próprias.
+ */
+
+/**
+ * Aplica as regras e prepara o log de eventos.
+ * @param cfg Regras (ALM_defaultConfig() + seção "alarms" do /config.json).
+ */
+void EVT_init(const AlarmConfig &cfg);
+
+/**
+ * Avalia uma amostra; cada mudança de estado vai para o log e o WebSocket.
+ * Chamar do loop() para todas as amostras, na ordem; as reproduzidas
+ * (SAMPLE_FLAG_REPLAY) são ignoradas.
+ * @param s Amostra com o timestamp como gravado no log.
+ */
+void EVT_process(const CellSample &s);
+
+/**
+ * Escreve em JSON os alarmes ativos e os eventos mais recentes do log,
+ * com os timestamps já corrigidos (timebase.h). Pode ser chamada de qualquer tarefa.
+ * @param out Destino.
+ * @param maxEvents Quantos eventos do log incluir (os mais novos).
+ */
+void EVT_writeJson(Print &out, uint16_t maxEvents);
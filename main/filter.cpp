@@ -0,0 +1,71 @@
+#include "filter.h"
+#include <string.h>
+
+static const char *const NAMES[] = {"mean", "median", "trimmed", "iir"};
+
+// Ordenação por inserção: n <= 32, sem alocação e rápida para poucos itens.
+static void sortSmall(int16_t *v, uint8_t n) {
+    for (uint8_t i = 1; i < n; i++) {
+        int16_t x = v[i];
+        int8_t j = i - 1;
+        while (j >= 0 && v[j] > x) {
+            v[j + 1] = v[j];
+            j--;
+        }
+        v[j + 1] = x;
+    }
+}
+
+// Média de v[from..to) em Q4, arredondada.
+static int32_t meanQ4(const int16_t *v, uint8_t from, uint8_t to) {
+    int32_t sum = 0;
+    for (uint8_t i = from; i < to; i++) sum += v[i];
+    int32_t n = to - from;
+    int32_t q = sum * 16;
+    return (q >= 0 ? q + n / 2 : q - n / 2) / n;
+}
+
+int32_t FLT_apply(FilterType type, int16_t *v, uint8_t n) {
+    if (n == 0) return 0;
+    switch (type) {
+    case FILTER_MEDIAN:
+        sortSmall(v, n);
+        return n & 1 ? (int32_t)v[n / 2] * 16 : ((int32_t)v[n / 2 - 1] + v[n / 2]) * 8;
+    case FILTER_TRIMMED: {
+        sortSmall(v, n);
+        uint8_t cut = n / 4;
+        return meanQ4(v, cut, n - cut);
+    }
+    case FILTER_MEAN:
+    case FILTER_IIR:
+    default:
+        return meanQ4(v, 0, n);
+    }
+}
+
+int32_t FLT_iir(int32_t &state, int32_t inQ4, uint8_t shift) {
+    if (state == INT32_MIN || shift == 0) {
+        state = inQ4;
+    } else {
+        // Arredonda em direção à entrada para o estado não parar a 1 LSB dela.
+        int32_t d = inQ4 - state;
+        int32_t step = d >= 0 ? (d + (1 << shift) - 1) >> shift : -((-d + (1 << shift) - 1) >> shift);
+        state += step;
+    }
+    return state;
+}
+
+const char *FLT_name(FilterType type) {
+    return type <= FILTER_IIR ? NAMES[type] : "?";
+}
+
+bool FLT_parse(const char *name, FilterType &out) {
+    if (!name) return false;
+    for (uint8_t i = 0; i <= FILTER_IIR; i++) {
+        if (strcmp(name, NAMES[i]) == 0) {
+            out = (FilterType)i;
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Filtros do oversampling, em aritmética inteira. Recebem as leituras brutas
+ * de um canal numa rodada e devolvem o valor em Q4 (contagens x 16), para
+ * não descartar a resolução extra da média.
+ *
+ * Este módulo não depende do Arduino: pode ser medido em host com dados reais.
+ */
+
+enum FilterType : uint8_t {
+    FILTER_MEAN,      // Média simples
+    FILTER_MEDIAN,    // Mediana (rejeita leituras corrompidas isoladas)
+    FILTER_TRIMMED,   // Média sem os 25% menores e os 25% maiores
+    FILTER_IIR,       // Média da rodada suavizada entre aquisições (passa-baixa de 1ª ordem)
+};
+
+static constexpr uint8_t FILTER_MAX_SAMPLES = 32;
+
+/**
+ * Combina as leituras de uma rodada.
+ * @param type Filtro (FILTER_IIR usa a média; a suavização é FLT_iir()).
+ * @param v Leituras (podem ser reordenadas).
+ * @param n Quantidade (1..FILTER_MAX_SAMPLES).
+ * @return Valor filtrado em Q4.
+ */
+int32_t FLT_apply(FilterType type, int16_t *v, uint8_t n);
+
+/**
+ * Um passo do filtro IIR: state += (in - state) / 2^shift.
+ * @param state Estado em Q4 (INT32_MIN = vazio, inicializa com 'in').
+ * @param inQ4 Nova entrada em Q4.
+ * @param shift Constante de tempo (0 = sem suavização).
+ * @return Novo estado.
+ */
+int32_t FLT_iir(int32_t &state, int32_t inQ4, uint8_t shift);
+
+/**
+ * Nome do filtro (config/JSON).
+ */
+const char *FLT_name(FilterType type);
+
+/**
+ * Converte um nome em filtro.
+ * @param name "mean", "median", "trimmed" ou "iir".
+ * @param out Recebe o filtro.
+ * @return true se o nome é conhecido.
+ */
+bool FLT_parse(const char *name, FilterType &out);
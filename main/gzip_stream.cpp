@@ -0,0 +1,153 @@
+#include "gzip_stream.h"
+#include "logfmt.h"
+#include <string.h>
+
+static const uint16_t LEN_BASE[29] = {3,4,5,6,7,8,9,10,11,13,15,17,19,23,27,31,35,43,51,59,67,83,99,115,131,163,195,227,258};
+static const uint8_t  LEN_EXTRA[29] = {0,0,0,0,0,0,0,0,1,1,1,1,2,2,2,2,3,3,3,3,4,4,4,4,5,5,5,5,0};
+static const uint16_t DIST_BASE[30] = {1,2,3,4,5,7,9,13,17,25,33,49,65,97,129,193,257,385,513,769,
+                                       1025,1537,2049,3073,4097,6145,8193,12289,16385,24577};
+static const uint8_t  DIST_EXTRA[30] = {0,0,0,0,1,1,2,2,3,3,4,4,5,5,6,6,7,7,8,8,9,9,10,10,11,11,12,12,13,13};
+
+static constexpr uint16_t MIN_MATCH = 3;
+static constexpr uint16_t MAX_MATCH = 258;
+
+// Os códigos Huffman são definidos a partir do bit mais significativo, mas o
+// deflate empacota bits a partir do menos significativo: inverte antes de gravar.
+static uint32_t reverseBits(uint32_t v, uint8_t n) {
+    uint32_t r = 0;
+    for (uint8_t i = 0; i < n; i++) {
+        r = (r << 1) | (v & 1);
+        v >>= 1;
+    }
+    return r;
+}
+
+static uint16_t hash3(const uint8_t *p) {
+    uint32_t v = ((uint32_t)p[0] << 16) | ((uint32_t)p[1] << 8) | p[2];
+    return (uint16_t)((v * 2654435761u) >> (32 - 10));
+}
+
+void GzipStream::putBits(uint32_t v, uint8_t n) {
+    bitBuf_ |= v << bitCnt_;
+    bitCnt_ += n;
+    while (bitCnt_ >= 8) {
+        out_[outLen_++] = (uint8_t)bitBuf_;
+        bitBuf_ >>= 8;
+        bitCnt_ -= 8;
+    }
+}
+
+// Símbolo literal/comprimento com o código fixo (RFC 1951, 3.2.6).
+void GzipStream::putSymbol(uint16_t sym) {
+    if (sym < 144)      putBits(reverseBits(0x30 + sym, 8), 8);
+    else if (sym < 256) putBits(reverseBits(0x190 + sym - 144, 9), 9);
+    else if (sym < 280) putBits(reverseBits(sym - 256, 7), 7);
+    else                putBits(reverseBits(0xC0 + sym - 280, 8), 8);
+}
+
+void GzipStream::putMatch(uint16_t len, uint16_t dist) {
+    uint8_t l = 28;
+    while (LEN_BASE[l] > len) l--;
+    putSymbol(257 + l);
+    if (LEN_EXTRA[l]) putBits(len - LEN_BASE[l], LEN_EXTRA[l]);
+
+    uint8_t d = 29;
+    while (DIST_BASE[d] > dist) d--;
+    putBits(reverseBits(d, 5), 5);
+    if (DIST_EXTRA[d]) putBits(dist - DIST_BASE[d], DIST_EXTRA[d]);
+}
+
+void GzipStream::begin() {
+    static const uint8_t header[10] = {0x1F, 0x8B, 8, 0, 0, 0, 0, 0, 0, 0xFF};
+    memcpy(out_, header, sizeof(header));
+    outLen_ = sizeof(header);
+    outPos_ = 0;
+    memset(head_, 0, sizeof(head_));
+    winLen_ = 0;
+    bitBuf_ = 0;
+    bitCnt_ = 0;
+    crc_ = 0;
+    size_ = 0;
+    finished_ = false;
+}
+
+void GzipStream::write(const uint8_t *data, size_t len) {
+    if (finished_ || len == 0) return;
+    if (len > GZ_CHUNK) len = GZ_CHUNK;
+
+    // Só bytes inteiros ficam em out_; os bits restantes continuam em bitBuf_.
+    memmove(out_, out_ + outPos_, outLen_ - outPos_);
+    outLen_ -= outPos_;
+    outPos_ = 0;
+
+    crc_ = LOG_crc32(crc_, data, len);
+    size_ += len;
+
+    // Desliza a janela: mantém os últimos GZ_WINDOW bytes e reajusta o hash.
+    if (winLen_ + len > sizeof(win_)) {
+        size_t shift = winLen_ - GZ_WINDOW;
+        memmove(win_, win_ + shift, GZ_WINDOW);
+        winLen_ = GZ_WINDOW;
+        for (uint16_t &h : head_) h = h > shift ? (uint16_t)(h - shift) : 0;
+    }
+    memcpy(win_ + winLen_, data, len);
+    size_t pos = winLen_;
+    const size_t end = winLen_ + len;
+    winLen_ = end;
+
+    // Um bloco de códigos fixos por trecho (BFINAL = 0, BTYPE = 01).
+    putBits(0, 1);
+    putBits(1, 2);
+    while (pos < end) {
+        uint16_t best = 0;
+        size_t dist = 0;
+        if (end - pos >= MIN_MATCH) {
+            uint16_t h = hash3(win_ + pos);
+            if (head_[h]) {
+                size_t cand = head_[h] - 1;
+                dist = pos - cand;
+                if (dist <= GZ_WINDOW) {
+                    size_t maxLen = end - pos < MAX_MATCH ? end - pos : MAX_MATCH;
+                    while (best < maxLen && win_[cand + best] == win_[pos + best]) best++;
+                }
+            }
+            head_[h] = (uint16_t)(pos + 1);
+        }
+        if (best >= MIN_MATCH) {
+            putMatch(best, (uint16_t)dist);
+            // Indexa as posições cobertas pelo match para os próximos.
+            for (size_t p = pos + 1; p < pos + best && p + MIN_MATCH <= end; p++) {
+                head_[hash3(win_ + p)] = (uint16_t)(p + 1);
+            }
+            pos += best;
+        } else {
+            putSymbol(win_[pos]);
+            pos++;
+        }
+    }
+    putSymbol(256);   // Fim de bloco
+}
+
+void GzipStream::finish() {
+    if (finished_) return;
+    memmove(out_, out_ + outPos_, outLen_ - outPos_);
+    outLen_ -= outPos_;
+    outPos_ = 0;
+
+    // Bloco final vazio (BFINAL = 1, BTYPE = 01) e alinhamento em byte.
+    putBits(1, 1);
+    putBits(1, 2);
+    putSymbol(256);
+    if (bitCnt_) putBits(0, 8 - bitCnt_);
+
+    for (uint8_t i = 0; i < 4; i++) out_[outLen_++] = (uint8_t)(crc_ >> (8 * i));
+    for (uint8_t i = 0; i < 4; i++) out_[outLen_++] = (uint8_t)(size_ >> (8 * i));
+    finished_ = true;
+}
+
+size_t GzipStream::read(uint8_t *out, size_t maxLen) {
+    size_t n = pending() < maxLen ? pending() : maxLen;
+    memcpy(out, out_ + outPos_, n);
+    outPos_ += n;
+    return n;
+}
@@ -0,0 +1,68 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Compressor gzip (RFC 1951/1952) em streaming com memória fixa e pequena
+ * (~7 KB por instância): LZ77 com janela de GZ_WINDOW bytes e um único
+ * candidato por hash, codificado com os códigos Huffman fixos do deflate.
+ * Comprime bem texto repetitivo como o CSV do log sem precisar dos ~200 KB
+ * de um zlib completo.
+ *
+ * Uso: begin(); enquanto houver dados { write(até GZ_CHUNK bytes); drenar
+ * com read() até pending() == 0 }; finish(); drenar com read().
+ *
+ * Não depende do Arduino: pode ser testado em host contra o zlib.
+ */
+
+static constexpr size_t GZ_WINDOW = 2048;   // Distância máxima de um match
+static constexpr size_t GZ_CHUNK = 512;     // Máximo de entrada por write()
+
+class GzipStream {
+public:
+    /** Reinicia o compressor e enfileira o cabeçalho gzip. */
+    void begin();
+
+    /**
+     * Comprime um trecho (só chame com pending() == 0).
+     * @param data Dados de entrada.
+     * @param len Tamanho (no máximo GZ_CHUNK).
+     */
+    void write(const uint8_t *data, size_t len);
+
+    /** Fecha o stream: bloco final, CRC32 e tamanho original. */
+    void finish();
+
+    /**
+     * Retira bytes comprimidos já prontos.
+     * @param out Buffer de saída.
+     * @param maxLen Tamanho do buffer.
+     * @return Bytes copiados.
+     */
+    size_t read(uint8_t *out, size_t maxLen);
+
+    /** Bytes comprimidos aguardando read(). */
+    size_t pending() const { return outLen_ - outPos_; }
+
+    /** true após finish(). */
+    bool finished() const { return finished_; }
+
+private:
+    void putBits(uint32_t v, uint8_t n);
+    void putSymbol(uint16_t sym);
+    void putMatch(uint16_t len, uint16_t dist);
+
+    static constexpr uint8_t HASH_BITS = 10;
+
+    uint8_t  win_[2 * GZ_WINDOW];
+    uint16_t head_[1 << HASH_BITS];   // Última posição (+1) de cada hash, 0 = vazio
+    size_t   winLen_ = 0;
+    uint8_t  out_[1024];              // Pior caso de um write(): 3 + 9*GZ_CHUNK + 7 bits
+    size_t   outLen_ = 0;
+    size_t   outPos_ = 0;
+    uint32_t bitBuf_ = 0;
+    uint8_t  bitCnt_ = 0;
+    uint32_t crc_ = 0;
+    uint32_t size_ = 0;
+    bool     finished_ = false;
+};
@@ -0,0 +1,98 @@
+#include "logcomp.h"
+
+void LogCompressor::configure(const LogCompConfig &cfg) {
+    cfg_ = cfg;
+    havePivot_ = false;
+    havePrev_ = false;
+    doorOpen_ = false;
+}
+
+void LogCompressor::archive(const LogRecord &r, LogRecord *out, uint8_t &n) {
+    out[n++] = r;
+    out_++;
+    pivot_ = r;
+    havePivot_ = true;
+    havePrev_ = false;
+    doorOpen_ = false;
+}
+
+// A reta pivot -> r passa a no máximo deviationMv de todas as amostras
+// intermediárias se a inclinação dela está dentro da porta de cada série.
+bool LogCompressor::fitsDoor(const LogRecord &r) const {
+    if (!doorOpen_) return true;
+    int64_t dt = (int64_t)(r.epochMs - pivot_.epochMs);
+    for (uint8_t k = 0; k < SERIES; k++) {
+        int64_t dv = value(r, k) - value(pivot_, k);
+        // dv/dt >= low  e  dv/dt <= high  (denominadores positivos)
+        if (dv * lowD_[k] < lowN_[k] * dt) return false;
+        if (dv * highD_[k] > highN_[k] * dt) return false;
+    }
+    return true;
+}
+
+// Inclui r como amostra intermediária: a porta fica mais estreita.
+void LogCompressor::narrowDoor(const LogRecord &r) {
+    int64_t dt = (int64_t)(r.epochMs - pivot_.epochMs);
+    for (uint8_t k = 0; k < SERIES; k++) {
+        int64_t dv = value(r, k) - value(pivot_, k);
+        int64_t lo = dv - cfg_.deviationMv, hi = dv + cfg_.deviationMv;
+        if (!doorOpen_ || lo * lowD_[k] > lowN_[k] * dt) { lowN_[k] = lo; lowD_[k] = dt; }
+        if (!doorOpen_ || hi * highD_[k] < highN_[k] * dt) { highN_[k] = hi; highD_[k] = dt; }
+    }
+    doorOpen_ = true;
+}
+
+uint8_t LogCompressor::push(const LogRecord &in, LogRecord out[2]) {
+    uint8_t n = 0;
+    in_++;
+    if (cfg_.mode == LOG_MODE_ALL || !havePivot_ || in.epochMs <= pivot_.epochMs) {
+        if (havePrev_) archive(prev_, out, n);
+        archive(in, out, n);
+        return n;
+    }
+
+    const LogRecord &last = havePrev_ ? prev_ : pivot_;
+    if (in.flags != last.flags) {
+        if (havePrev_) archive(prev_, out, n);
+        archive(in, out, n);
+        return n;
+    }
+
+    if (cfg_.mode == LOG_MODE_DEADBAND) {
+        bool outside = in.epochMs - pivot_.epochMs >= cfg_.heartbeatMs;
+        for (uint8_t k = 0; k < SERIES && !outside; k++) {
+            int32_t d = value(in, k) - value(pivot_, k);
+            outside = d > cfg_.deviationMv || d < -(int32_t)cfg_.deviationMv;
+        }
+        if (outside) archive(in, out, n);
+        return n;
+    }
+
+    // Swinging door: 'prev' é o candidato a vértice; 'in' o substitui se a
+    // reta até ele ainda cobre as intermediárias e o heartbeat não venceu.
+    // O candidato anterior passa a ser intermediário (se 'in' for rejeitada,
+    // archive() descarta a porta de qualquer forma).
+    bool late = in.epochMs - pivot_.epochMs > cfg_.heartbeatMs;
+    if (havePrev_) narrowDoor(prev_);
+    if (!late && fitsDoor(in)) {
+        prev_ = in;
+        havePrev_ = true;
+        return n;
+    }
+    if (!havePrev_) {
+        archive(in, out, n);   // Heartbeat sem candidato: grava a própria amostra
+        return n;
+    }
+    archive(prev_, out, n);
+    prev_ = in;
+    havePrev_ = true;
+    if (in.epochMs - pivot_.epochMs > cfg_.heartbeatMs) archive(prev_, out, n);
+    return n;
+}
+
+bool LogCompressor::flush(LogRecord &out) {
+    if (!havePrev_) return false;
+    uint8_t n = 0;
+    archive(prev_, &out, n);
+    return true;
+}
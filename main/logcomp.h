@@ -0,0 +1,73 @@
+#pragma once
+#include "logfmt.h"
+
+/**
+ * Redução do volume do log antes do codificador de blocos.
+ *
+ * LOG_MODE_DEADBAND grava uma amostra só quando alguma série (células ou
+ * total) sai da banda morta em torno do último valor gravado; a série
+ * reconstruída mantendo o último valor ("sample-and-hold") fica a no máximo
+ * deviationMv da original.
+ *
+ * LOG_MODE_SWINGDOOR grava só os vértices de uma reta por partes: cada
+ * amostra descartada fica a no máximo deviationMv da reta entre os registros
+ * gravados vizinhos (interpolação linear). A verificação é O(1) por amostra
+ * (porta de inclinações mín./máx. sobre as amostras intermediárias).
+ *
+ * Nos dois modos, uma mudança de flags e o intervalo máximo (heartbeat)
+ * sempre geram registro. Não depende do Arduino.
+ */
+
+enum LogMode : uint8_t {
+    LOG_MODE_ALL,         // Grava todas as amostras
+    LOG_MODE_DEADBAND,    // Banda morta + heartbeat
+    LOG_MODE_SWINGDOOR,   // Swinging door + heartbeat
+};
+
+struct LogCompConfig {
+    LogMode  mode;
+    uint16_t deviationMv;   // Erro máximo da série reconstruída (mV)
+    uint32_t heartbeatMs;   // Intervalo máximo entre registros gravados
+};
+
+class LogCompressor {
+public:
+    /** Aplica a configuração e descarta o estado (o próximo registro é gravado). */
+    void configure(const LogCompConfig &cfg);
+
+    /**
+     * Processa uma amostra.
+     * @param in Amostra (timestamps não decrescentes).
+     * @param out Recebe até 2 registros a gravar, em ordem.
+     * @return Quantos registros foram colocados em 'out'.
+     */
+    uint8_t push(const LogRecord &in, LogRecord out[2]);
+
+    /**
+     * Libera a amostra retida pelo swinging door (fim de série, sync).
+     * @param out Recebe o registro.
+     * @return true se havia registro retido.
+     */
+    bool flush(LogRecord &out);
+
+    uint32_t samplesIn() const { return in_; }
+    uint32_t recordsOut() const { return out_; }
+
+private:
+    static constexpr uint8_t SERIES = PACK_SERIES;   // Células + total
+
+    static int32_t value(const LogRecord &r, uint8_t k) { return k < PACK_CELLS ? r.mv[k] : r.total; }
+    void archive(const LogRecord &r, LogRecord *out, uint8_t &n);
+    bool fitsDoor(const LogRecord &r) const;
+    void narrowDoor(const LogRecord &r);
+
+    LogCompConfig cfg_{LOG_MODE_ALL, 2, 60000};
+    bool      havePivot_ = false;
+    bool      havePrev_ = false;   // Amostra aceita mas ainda não gravada (swinging door)
+    LogRecord pivot_{};            // Último registro gravado
+    LogRecord prev_{};
+    // Porta por série: inclinações (mV/ms) como frações num/den, den > 0.
+    bool      doorOpen_ = false;   // Há amostras intermediárias restringindo a porta
+    int64_t   lowN_[SERIES], lowD_[SERIES], highN_[SERIES], highD_[SERIES];
+    uint32_t  in_ = 0, out_ = 0;
+};
@@ -0,0 +1,266 @@
+#include "logfmt.h"
+#include <string.h>
+
+uint32_t LOG_crc32(uint32_t crc, const uint8_t *data, size_t len) {
+    // Tabela de 16 entradas (meio byte por vez): 64 bytes de flash.
+    static const uint32_t tbl[16] = {
+        0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+        0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+    };
+    crc = ~crc;
+    for (size_t i = 0; i < len; i++) {
+        crc = tbl[(crc ^ data[i]) & 0x0F] ^ (crc >> 4);
+        crc = tbl[(crc ^ (data[i] >> 4)) & 0x0F] ^ (crc >> 4);
+    }
+    return ~crc;
+}
+
+// --- Escrita/leitura de bits (MSB primeiro) ---
+
+static bool putBits(uint8_t *buf, size_t cap, size_t &pos, uint32_t v, uint8_t n) {
+    if (pos + n > cap * 8) return false;
+    for (int8_t b = n - 1; b >= 0; b--) {
+        uint8_t &byte = buf[pos >> 3];
+        uint8_t mask = 0x80 >> (pos & 7);
+        if ((v >> b) & 1) byte |= mask; else byte &= ~mask;
+        pos++;
+    }
+    return true;
+}
+
+static bool getBits(const uint8_t *buf, size_t cap, size_t &pos, uint8_t n, uint32_t &v) {
+    if (pos + n > cap * 8) return false;
+    v = 0;
+    for (uint8_t b = 0; b < n; b++) {
+        v = (v << 1) | ((buf[pos >> 3] >> (7 - (pos & 7))) & 1);
+        pos++;
+    }
+    return true;
+}
+
+// Os deltas são codificados em Golomb-Rice com parâmetro 'k' adaptativo
+// (estilo LOCO-I): cada série mantém uma média móvel do valor codificado e o
+// codificador e o decodificador derivam o mesmo 'k' dela. Assim uma célula
+// estável custa ~1 bit e uma célula ruidosa se ajusta sozinha.
+static constexpr uint8_t RICE_MAX_Q = 12;   // Acima disso grava o valor cru (escape)
+
+static uint32_t zigzag(int32_t d) { return ((uint32_t)d << 1) ^ (uint32_t)(d >> 31); }
+static int32_t unzigzag(uint32_t z) { return (int32_t)(z >> 1) ^ -(int32_t)(z & 1); }
+
+static uint8_t riceK(uint16_t avgQ4) {
+    uint8_t k = 0;
+    while (k < 15 && ((uint32_t)1 << (k + 4)) <= avgQ4) k++;
+    return k;
+}
+
+static void riceAdapt(uint16_t &avgQ4, uint32_t z) {
+    uint32_t zq = z > 0x0FFF ? 0xFFFF : z << 4;
+    avgQ4 = (uint16_t)(avgQ4 + (((int32_t)zq - (int32_t)avgQ4) >> 2));
+}
+
+// Grava 'z' em Rice(k); no escape grava 'rawBits' bits de 'raw'.
+static bool putRice(uint8_t *buf, size_t cap, size_t &pos, uint16_t &avgQ4, uint32_t z,
+                    uint32_t raw, uint8_t rawBits) {
+    uint8_t k = riceK(avgQ4);
+    uint32_t q = z >> k;
+    bool ok;
+    if (q < RICE_MAX_Q) {
+        ok = putBits(buf, cap, pos, ((1UL << q) - 1) << 1, q + 1)
+          && putBits(buf, cap, pos, z & ((1UL << k) - 1), k);
+    } else {
+        ok = putBits(buf, cap, pos, (1UL << RICE_MAX_Q) - 1, RICE_MAX_Q)
+          && putBits(buf, cap, pos, raw, rawBits);
+    }
+    riceAdapt(avgQ4, z);
+    return ok;
+}
+
+// Lê um valor Rice(k). 'escaped' indica que 'v' é o valor cru de 'rawBits' bits.
+static bool getRice(const uint8_t *buf, size_t cap, size_t &pos, uint16_t &avgQ4, uint8_t rawBits,
+                    uint32_t &v, bool &escaped) {
+    uint8_t k = riceK(avgQ4);
+    uint32_t q = 0, bit;
+    do {
+        if (!getBits(buf, cap, pos, 1, bit)) return false;
+        if (bit) q++;
+    } while (bit && q < RICE_MAX_Q);
+    escaped = q == RICE_MAX_Q;
+    if (escaped) {
+        if (!getBits(buf, cap, pos, rawBits, v)) return false;
+    } else {
+        uint32_t low;
+        if (!getBits(buf, cap, pos, k, low)) return false;
+        v = (q << k) | low;
+    }
+    return true;
+}
+
+static bool putTime(uint8_t *buf, size_t cap, size_t &pos, uint16_t &avgQ4, int64_t dod) {
+    if (dod < INT32_MIN || dod > INT32_MAX) return false;   // Salto maior que ~24 dias: bloco novo
+    uint32_t z = zigzag((int32_t)dod);
+    return putRice(buf, cap, pos, avgQ4, z, z, 32);
+}
+
+static bool getTime(const uint8_t *buf, size_t cap, size_t &pos, uint16_t &avgQ4, int64_t &dod) {
+    uint32_t z;
+    bool escaped;
+    if (!getRice(buf, cap, pos, avgQ4, 32, z, escaped)) return false;
+    riceAdapt(avgQ4, z);
+    dod = unzigzag(z);
+    return true;
+}
+
+static bool putMv(uint8_t *buf, size_t cap, size_t &pos, uint16_t &avgQ4, uint16_t prev, uint16_t cur) {
+    uint32_t z = zigzag((int32_t)cur - (int32_t)prev);
+    return putRice(buf, cap, pos, avgQ4, z, cur, 16);
+}
+
+static bool getMv(const uint8_t *buf, size_t cap, size_t &pos, uint16_t &avgQ4, uint16_t prev, uint16_t &cur) {
+    uint32_t v;
+    bool escaped;
+    if (!getRice(buf, cap, pos, avgQ4, 16, v, escaped)) return false;
+    cur = escaped ? (uint16_t)v : (uint16_t)(prev + unzigzag(v));
+    riceAdapt(avgQ4, zigzag((int32_t)cur - (int32_t)prev));
+    return true;
+}
+
+static uint16_t sumMv(const uint16_t *mv) {
+    uint16_t sum = 0;
+    for (uint8_t i = 0; i < PACK_CELLS; i++) sum += mv[i];
+    return sum;
+}
+
+// Total: '0' se igual à soma das células, senão '1'+16. Flags: '0' se iguais ao anterior, senão '1'+8.
+static bool putTail(uint8_t *buf, size_t cap, size_t &pos, const LogRecord &r, uint8_t prevFlags, bool first) {
+    bool ok = r.total == sumMv(r.mv)
+        ? putBits(buf, cap, pos, 0, 1)
+        : putBits(buf, cap, pos, 1, 1) && putBits(buf, cap, pos, r.total, 16);
+    if (!ok) return false;
+    if (!first && r.flags == prevFlags) return putBits(buf, cap, pos, 0, 1);
+    return putBits(buf, cap, pos, 1, 1) && putBits(buf, cap, pos, r.flags, 8);
+}
+
+static bool getTail(const uint8_t *buf, size_t cap, size_t &pos, LogRecord &r, uint8_t prevFlags) {
+    uint32_t v;
+    if (!getBits(buf, cap, pos, 1, v)) return false;
+    if (v) { if (!getBits(buf, cap, pos, 16, v)) return false; r.total = (uint16_t)v; }
+    else   r.total = sumMv(r.mv);
+    if (!getBits(buf, cap, pos, 1, v)) return false;
+    if (v) { if (!getBits(buf, cap, pos, 8, v)) return false; r.flags = (uint8_t)v; }
+    else   r.flags = prevFlags;
+    return true;
+}
+
+// --- LogBlockWriter ---
+
+void LogBlockWriter::reset() {
+    bitPos_ = 0;
+    count_ = 0;
+    t0_ = 0;
+    prevDt_ = 0;
+    prev_ = LogRecord{};
+    memset(adapt_, 0, sizeof(adapt_));
+}
+
+bool LogBlockWriter::append(const LogRecord &r) {
+    size_t pos = bitPos_;
+    bool ok;
+    int64_t dt = 0;
+
+    if (count_ == 0) {
+        // Primeiro registro: tensões absolutas, o tempo vai no cabeçalho.
+        ok = true;
+        for (uint8_t i = 0; i < PACK_CELLS && ok; i++) ok = putBits(buf_, sizeof(buf_), pos, r.mv[i], 16);
+        ok = ok && putTail(buf_, sizeof(buf_), pos, r, 0, true);
+    } else {
+        if (r.epochMs < prev_.epochMs) return false;
+        dt = (int64_t)(r.epochMs - prev_.epochMs);
+        if (r.epochMs - t0_ > UINT32_MAX) return false;   // 'span' do cabeçalho tem 32 bits
+        // Trabalha numa cópia do estado adaptativo: se não couber, nada muda.
+        uint16_t adapt[PACK_SERIES];
+        memcpy(adapt, adapt_, sizeof(adapt));
+        ok = putTime(buf_, sizeof(buf_), pos, adapt[0], dt - prevDt_);
+        for (uint8_t i = 0; i < PACK_CELLS && ok; i++) ok = putMv(buf_, sizeof(buf_), pos, adapt[i + 1], prev_.mv[i], r.mv[i]);
+        ok = ok && putTail(buf_, sizeof(buf_), pos, r, prev_.flags, false);
+        if (ok) memcpy(adapt_, adapt, sizeof(adapt));
+    }
+    if (!ok) return false;   // Não coube: bitPos_ intacto, o conteúdo além dele é ignorado
+
+    if (count_ == 0) t0_ = r.epochMs;
+    bitPos_ = pos;
+    prevDt_ = dt;
+    prev_ = r;
+    count_++;
+    return true;
+}
+
+void LogBlockWriter::finish(uint8_t *out) const {
+    LogBlockHeader h{};
+    h.magic = LOG_BLOCK_MAGIC;
+    h.version = LOG_VERSION;
+    h.cells = PACK_CELLS;
+    h.count = count_;
+    h.payloadLen = (uint16_t)((bitPos_ + 7) / 8);
+    h.t0 = t0_;
+    h.span = count_ ? (uint32_t)(prev_.epochMs - t0_) : 0;
+
+    uint8_t *payload = out + sizeof(LogBlockHeader);
+    memcpy(payload, buf_, h.payloadLen);
+    // Zera os bits não usados do último byte e o restante do bloco.
+    if (bitPos_ & 7) payload[h.payloadLen - 1] &= (uint8_t)(0xFF << (8 - (bitPos_ & 7)));
+    memset(payload + h.payloadLen, 0, LOG_PAYLOAD_SIZE - h.payloadLen);
+    h.crc = LOG_crc32(0, payload, h.payloadLen);
+    memcpy(out, &h, sizeof(h));
+}
+
+// --- LogBlockReader ---
+
+bool LOG_peekHeader(const uint8_t *block, LogBlockHeader &h) {
+    memcpy(&h, block, sizeof(h));
+    return h.magic == LOG_BLOCK_MAGIC && h.version == LOG_VERSION && h.payloadLen <= LOG_PAYLOAD_SIZE;
+}
+
+bool LogBlockReader::open(const uint8_t *block) {
+    payload_ = nullptr;
+    if (!LOG_peekHeader(block, hdr_)) return false;
+    if ((hdr_.cells ? hdr_.cells : 4) != PACK_CELLS) return false;   // Log de outro pack
+    const uint8_t *p = block + sizeof(LogBlockHeader);
+    if (LOG_crc32(0, p, hdr_.payloadLen) != hdr_.crc) return false;
+    payload_ = p;
+    bitPos_ = 0;
+    index_ = 0;
+    prevDt_ = 0;
+    prev_ = LogRecord{};
+    memset(adapt_, 0, sizeof(adapt_));
+    return true;
+}
+
+bool LogBlockReader::next(LogRecord &r) {
+    if (!payload_ || index_ >= hdr_.count) return false;
+    size_t pos = bitPos_;
+    const size_t cap = hdr_.payloadLen;
+    uint32_t v;
+
+    if (index_ == 0) {
+        r.epochMs = hdr_.t0;
+        for (uint8_t i = 0; i < PACK_CELLS; i++) {
+            if (!getBits(payload_, cap, pos, 16, v)) return false;
+            r.mv[i] = (uint16_t)v;
+        }
+        if (!getTail(payload_, cap, pos, r, 0)) return false;
+        prevDt_ = 0;
+    } else {
+        int64_t dod;
+        if (!getTime(payload_, cap, pos, adapt_[0], dod)) return false;
+        prevDt_ += dod;
+        r.epochMs = prev_.epochMs + prevDt_;
+        for (uint8_t i = 0; i < PACK_CELLS; i++) {
+            if (!getMv(payload_, cap, pos, adapt_[i + 1], prev_.mv[i], r.mv[i])) return false;
+        }
+        if (!getTail(payload_, cap, pos, r, prev_.flags)) return false;
+    }
+    bitPos_ = pos;
+    prev_ = r;
+    index_++;
+    return true;
+}
@@ -0,0 +1,138 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include "pack_config.h"
+
+/**
+ * Formato binário do log.
+ *
+ * O log é uma sequência de blocos de tamanho fixo (LOG_BLOCK_SIZE, múltiplo
+ * da página da SPIFFS). Cada bloco tem um cabeçalho com o intervalo de tempo
+ * coberto e um CRC32, seguido de um payload codificado em bits: o primeiro
+ * registro vai completo e os seguintes como diferenças em relação ao anterior
+ * (delta-of-delta no tempo, delta por célula em Golomb-Rice adaptativo,
+ * total/flags só quando mudam). Com as variações típicas de poucos mV entre
+ * amostras, um registro ocupa ~2–3 bytes, contra ~47 bytes por linha do CSV antigo.
+ *
+ * O número de células é o de pack_config.h e vai no cabeçalho de cada bloco;
+ * um leitor compilado para outro pack rejeita o bloco em vez de decodificar
+ * lixo. Blocos gravados antes do campo existir têm 0 ali e valem como 4.
+ *
+ * Este módulo não depende do Arduino: é compartilhado com as ferramentas de host.
+ */
+
+static constexpr size_t   LOG_BLOCK_SIZE = 512;
+static constexpr uint16_t LOG_BLOCK_MAGIC = 0x424C;   // "LB"
+static constexpr uint8_t  LOG_VERSION = 1;
+
+/**
+ * Registro lógico do log.
+ */
+struct LogRecord {
+    uint64_t epochMs;    // Timestamp Unix em milissegundos
+    uint16_t mv[PACK_CELLS];   // Tensões das células em mV
+    uint16_t total;      // Tensão total do pack em mV
+    uint8_t  flags;      // Indicadores de qualidade (SAMPLE_FLAG_*)
+};
+
+/**
+ * Cabeçalho de cada bloco (little-endian, 24 bytes).
+ */
+struct LogBlockHeader {
+    uint16_t magic;        // LOG_BLOCK_MAGIC
+    uint8_t  version;      // LOG_VERSION
+    uint8_t  cells;        // Células por registro (PACK_CELLS; 0 = 4, blocos antigos)
+    uint16_t count;        // Número de registros no bloco
+    uint16_t payloadLen;   // Bytes úteis de payload após o cabeçalho
+    uint64_t t0;           // Timestamp do primeiro registro (ms)
+    uint32_t span;         // Último timestamp - t0 (ms)
+    uint32_t crc;          // CRC32 do payload
+};
+static_assert(sizeof(LogBlockHeader) == 24, "LogBlockHeader deve ter 24 bytes");
+
+static constexpr size_t LOG_PAYLOAD_SIZE = LOG_BLOCK_SIZE - sizeof(LogBlockHeader);
+
+/**
+ * Calcula/continua um CRC32 (IEEE 802.3, o mesmo do gzip/zip).
+ * @param crc CRC acumulado (0 para começar).
+ * @param data Dados.
+ * @param len Tamanho dos dados.
+ * @return CRC atualizado.
+ */
+uint32_t LOG_crc32(uint32_t crc, const uint8_t *data, size_t len);
+
+/**
+ * Codificador de um bloco. Acumula registros até o payload encher.
+ */
+class LogBlockWriter {
+public:
+    /** Descarta o conteúdo e começa um bloco vazio. */
+    void reset();
+
+    /**
+     * Acrescenta um registro ao bloco.
+     * @param r Registro (timestamps devem ser não decrescentes).
+     * @return true se coube, false se o bloco está cheio (nada foi escrito).
+     */
+    bool append(const LogRecord &r);
+
+    /**
+     * Fecha o bloco: preenche cabeçalho e CRC e copia LOG_BLOCK_SIZE bytes
+     * (payload completado com zeros) para 'out'.
+     * @param out Buffer de LOG_BLOCK_SIZE bytes.
+     */
+    void finish(uint8_t *out) const;
+
+    uint16_t count() const { return count_; }
+    bool empty() const { return count_ == 0; }
+    uint64_t firstMs() const { return t0_; }
+    uint64_t lastMs() const { return prev_.epochMs; }
+
+private:
+    uint8_t   buf_[LOG_PAYLOAD_SIZE];
+    size_t    bitPos_ = 0;
+    uint16_t  count_ = 0;
+    uint64_t  t0_ = 0;
+    int64_t   prevDt_ = 0;
+    LogRecord prev_{};
+    uint16_t  adapt_[PACK_SERIES] = {0};   // Média móvel (Q4) do tempo e de cada célula
+};
+
+/**
+ * Decodificador de um bloco.
+ */
+class LogBlockReader {
+public:
+    /**
+     * Valida (magic, versão, número de células, CRC) e prepara a leitura de um bloco.
+     * @param block LOG_BLOCK_SIZE bytes lidos do log (devem permanecer válidos).
+     * @return true se o bloco é válido.
+     */
+    bool open(const uint8_t *block);
+
+    /**
+     * Decodifica o próximo registro.
+     * @param r Recebe o registro.
+     * @return true se havia registro, false no fim do bloco.
+     */
+    bool next(LogRecord &r);
+
+    const LogBlockHeader &header() const { return hdr_; }
+
+private:
+    LogBlockHeader hdr_{};
+    const uint8_t *payload_ = nullptr;
+    size_t    bitPos_ = 0;
+    uint16_t  index_ = 0;
+    int64_t   prevDt_ = 0;
+    LogRecord prev_{};
+    uint16_t  adapt_[PACK_SERIES] = {0};   // Média móvel (Q4) do tempo e de cada célula
+};
+
+/**
+ * Lê só o cabeçalho de um bloco, sem validar o CRC (para índices/buscas).
+ * @param block Início do bloco.
+ * @param h Recebe o cabeçalho.
+ * @return true se o magic e a versão conferem.
+ */
+bool LOG_peekHeader(const uint8_t *block, LogBlockHeader &h);
@@ -1,12 +1,19 @@
 #include <SPIFFS.h>
 #include <WiFi.h>
 #include "ads_driver.h"
+#include "acquisition.h"
 #include "storage.h"
+#include "rollup.h"
+#include "recent.h"
 #include "config.h"
 #include "net.h"
+#include "timebase.h"
+#include "metrics.h"
+#include "events.h"
+#include "uplink.h"
 
 // Valores de calibração padrão caso o /config.json não exista ou falhe.
-Calib calib{{1.043f, 2.114f, 3.022f, 4.039f}};
+Calib calib = CFG_defaultCalib();
 
 /**
  * Lida com erros irrecuperáveis durante a inicialização.
@@ -50,60 +57,115 @@ void setup() {
         // Se não pudermos abrir o arquivo de log, a gravação de dados falhará. Erro fatal.
         handleFatalError("[MAIN] Erro fatal: Falha ao inicializar o sistema de arquivos de log");
     }
+    // Timestamps provisórios continuam do fim do log até o NTP sincronizar.
+    TIME_init(FS_lastMs());
+    LogPolicy logPolicy = LOG_DEFAULT_POLICY;
+    CFG_loadLogPolicy(logPolicy);
+    FS_setPolicy(logPolicy);
+    ROLL_init();
+    uint16_t recentDepth = REC_DEFAULT_DEPTH;
+    CFG_loadRecentDepth(recentDepth);
+    REC_init(recentDepth);
+    AlarmConfig alarmCfg = ALM_defaultConfig();
+    CFG_loadAlarmConfig(alarmCfg);
+    EVT_init(alarmCfg);
 
-    // Se todos os sistemas críticos estão OK, inicializa a rede.
+    uint32_t metricsDumpSec = 0;
+    CFG_loadMetricsDump(metricsDumpSec);
+    MET_setDumpInterval(metricsDumpSec);
+
+    SchedConfig schedCfg = SCHED_DEFAULT_CONFIG;
+    CFG_loadSchedConfig(schedCfg);
+    ACQ_setSchedule(schedCfg);
+    AdsProfile profile = ADS_DEFAULT_PROFILE;
+    CFG_loadAcqProfile(profile);
+    if (!ACQ_setProfile(profile)) ACQ_setProfile(ADS_DEFAULT_PROFILE);
+
+    // A aquisição roda em sua própria tarefa (núcleo 0); o loop() só consome a fila.
+    if (!ACQ_start()) {
+        handleFatalError("[MAIN] Erro fatal: Falha ao iniciar a tarefa de aquisição");
+    }
+
+    // A rede sobe depois da aquisição e sem bloquear: WiFi e NTP em segundo plano.
     Serial.println("[MAIN] Inicializando WiFi e servidor...");
     NET_init();
+
+    // Envio do log ao coletor, se configurado: retoma do cursor salvo na NVS.
+    UplinkConfig uplinkCfg = UPL_DEFAULT_CONFIG;
+    CFG_loadUplinkConfig(uplinkCfg);
+    if (!UPL_init(uplinkCfg)) Serial.println("[MAIN] Aviso: envio ao coletor não iniciado");
     Serial.println("[MAIN] Inicialização completa");
 }
 
 void loop() {
-    static uint32_t last = 0;
-    static uint32_t errorCount = 0;
-    static bool timeOk = false;
+    static uint32_t lastOverflows = 0;
+    static bool firstSample = true;
     CellSample s;
+    const uint32_t loopStart = micros();
 
-    // Loop de amostragem principal, roda a 2Hz.
-    if (millis() - last >= 500) {
-        last = millis();
-        time_t now = time(nullptr);
+    // Quando o NTP sincroniza, registra a correção do boot e acerta as
+    // amostras provisórias que estão na RAM.
+    NET_poll();
+    TimeFix fix;
+    if (TIME_poll(fix)) REC_fixup(fix);
 
-        // Só começa a registrar dados depois que o tempo NTP for sincronizado.
-        if (now > 1600000000) {
-            timeOk = true;
-        }
-        if (!timeOk) {
-            Serial.println("[MAIN] Aguardando sincronização do tempo NTP...");
-            return;
+    // Consome todas as amostras publicadas pela tarefa de aquisição. Um flush
+    // lento ou um cliente WS travado atrasa só este consumidor, não o ADC.
+    while (ACQ_pop(s)) {
+        if (firstSample) {
+            Serial.printf("[MAIN] Primeira amostra %lu ms após o boot\n", (unsigned long)millis());
+            firstSample = false;
         }
 
-        // Tenta obter uma nova amostra do ADC.
-        if (!ADS_getSample(s)) {
-            errorCount++;
-            Serial.printf("[MAIN] Erro na leitura do ADC (%d erros)\n", errorCount);
-            // Se o ADC falhar muitas vezes seguidas, algo está errado. Reinicia pra tentar recuperar.
-            if (errorCount > 10) {
-                Serial.println("[MAIN] Muitos erros consecutivos, reiniciando...");
-                ESP.restart();
-            }
-            return;
-        }
-        // Leitura bem-sucedida, reseta o contador de erros.
-        errorCount = 0;
-        
-        // Salva a nova amostra no arquivo CSV.
-        if (!FS_appendCsv(s)) {
-            Serial.println("[MAIN] Erro ao salvar dados no CSV");
+        // Amostras reproduzidas não são do pack: vão só ao dashboard (anel e
+        // WebSocket), nunca ao log persistente (nem ao coletor, que lê o log)
+        // nem aos agregados.
+        const bool replayed = s.flags & SAMPLE_FLAG_REPLAY;
+
+        // Salva a nova amostra no log, com o timestamp como foi carimbado
+        // (a correção de um timestamp provisório é aplicada na leitura).
+        if (!replayed && !FS_append(s)) {
+            Serial.println("[MAIN] Erro ao salvar dados no log");
         }
 
+        // Alarmes: avalia as regras e publica só as mudanças de estado.
+        EVT_process(s);
+
+        // Os consumidores da RAM já recebem o timestamp corrigido, se houver correção.
+        CellSample live = s;
+        live.epochMs = TIME_toWall(s.epochMs, s.flags);
+
+        // Atualiza os agregados de 1s/1min/1h. Amostras provisórias ficam de
+        // fora: os baldes fechados não são corrigidos depois.
+        if (!replayed && !(s.flags & SAMPLE_FLAG_PROVISIONAL)) ROLL_add(live);
+
+        // Guarda no anel da RAM (histórico inicial do dashboard).
+        REC_add(live);
+
         // Envia a amostra via WebSocket para a interface web.
-        NET_tick(s);
-        
+        NET_tick(live);
+
         // Imprime os dados no monitor serial para debug.
+        time_t now = time(nullptr);
         struct tm tm;
         localtime_r(&now,&tm);
-        Serial.printf("%02d:%02d:%02d,%u,%u,%u,%u,%u\n",
-            tm.tm_hour, tm.tm_min, tm.tm_sec,
-            s.mv[0], s.mv[1], s.mv[2], s.mv[3], s.total);
+        Serial.printf("%02d:%02d:%02d", tm.tm_hour, tm.tm_min, tm.tm_sec);
+        for (uint8_t i = 0; i < PACK_CELLS; i++) Serial.printf(",%u", s.mv[i]);
+        Serial.printf(",%u\n", s.total);
+    }
+
+    // Grava o lote pendente se a janela de perda venceu.
+    FS_tick();
+    MET_tick();
+
+    // Avisa se a fila transbordou desde a última verificação.
+    AcqStats st;
+    ACQ_getStats(st);
+    if (st.overflows != lastOverflows) {
+        Serial.printf("[MAIN] Fila de amostras cheia: %u descartadas (pico %u/%u)\n",
+            st.overflows - lastOverflows, st.highWater, st.capacity);
+        lastOverflows = st.overflows;
     }
+    MET_RECORD(MET_LOOP, micros() - loopStart);
+    delay(10);
 }
\ No newline at end of file
@@ -0,0 +1,180 @@
+#include "metrics.h"
+#include "acquisition.h"
+#include "storage.h"
+#include <atomic>
+
+static const char *const kStageNames[MET_STAGES] = {
+    "ads_conv", "ads_sample", "fs_append", "fs_flush", "ws_encode", "net_tick", "loop"
+};
+static const char *const kCounterNames[MET_COUNTERS] = {
+    "ads_timeouts", "ads_errors", "ws_skipped", "loop_overruns"
+};
+
+static uint32_t dumpIntervalMs = 0;
+
+#if METRICS_ENABLED
+struct Histogram {
+    std::atomic<uint32_t> count{0};
+    std::atomic<uint32_t> sumLo{0};   // Soma em µs, em duas metades (sem atômico de 64 bits)
+    std::atomic<uint32_t> sumHi{0};
+    std::atomic<uint32_t> maxUs{0};
+    std::atomic<uint32_t> buckets[MET_BUCKETS];
+};
+
+static Histogram stages[MET_STAGES];
+static std::atomic<uint32_t> counters[MET_COUNTERS];
+
+// Balde i guarda durações < 2^i µs (o último, o resto).
+static inline uint8_t bucketOf(uint32_t us) {
+    uint8_t i = us ? 32 - __builtin_clz(us) : 0;
+    return i < MET_BUCKETS ? i : MET_BUCKETS - 1;
+}
+
+void MET_record(MetStage s, uint32_t us) {
+    Histogram &h = stages[s];
+    h.count.fetch_add(1, std::memory_order_relaxed);
+    uint32_t lo = h.sumLo.fetch_add(us, std::memory_order_relaxed);
+    if (lo + us < lo) h.sumHi.fetch_add(1, std::memory_order_relaxed);
+    h.buckets[bucketOf(us)].fetch_add(1, std::memory_order_relaxed);
+    uint32_t m = h.maxUs.load(std::memory_order_relaxed);
+    while (us > m && !h.maxUs.compare_exchange_weak(m, us, std::memory_order_relaxed)) {}
+    if (s == MET_LOOP && us > MET_LOOP_BUDGET_US) MET_count(MET_LOOP_OVERRUN);
+}
+
+void MET_count(MetCounter c, uint32_t n) {
+    counters[c].fetch_add(n, std::memory_order_relaxed);
+}
+
+void MET_getStage(MetStage s, MetStageStats &out) {
+    const Histogram &h = stages[s];
+    out.count = h.count.load(std::memory_order_relaxed);
+    out.sumUs = ((uint64_t)h.sumHi.load(std::memory_order_relaxed) << 32) | h.sumLo.load(std::memory_order_relaxed);
+    out.maxUs = h.maxUs.load(std::memory_order_relaxed);
+    for (uint8_t i = 0; i < MET_BUCKETS; i++) out.buckets[i] = h.buckets[i].load(std::memory_order_relaxed);
+}
+
+static uint32_t counterValue(uint8_t c) {
+    return counters[c].load(std::memory_order_relaxed);
+}
+#else
+void MET_getStage(MetStage, MetStageStats &out) {
+    memset(&out, 0, sizeof(out));
+}
+
+static uint32_t counterValue(uint8_t) {
+    return 0;
+}
+#endif
+
+// Limite superior do balde que contém o quantil q (em µs; máximo no último balde).
+static uint32_t quantileUs(const MetStageStats &st, float q) {
+    if (!st.count) return 0;
+    uint32_t target = (uint32_t)(q * st.count + 0.5f);
+    if (target == 0) target = 1;
+    uint32_t acc = 0;
+    for (uint8_t i = 0; i < MET_BUCKETS - 1; i++) {
+        acc += st.buckets[i];
+        if (acc >= target) return (1UL << i) < st.maxUs ? (1UL << i) : st.maxUs;
+    }
+    return st.maxUs;
+}
+
+// Indicadores lidos na hora: heap e estado da fila e do log.
+struct Gauges {
+    uint32_t heapFree, heapMin, heapMaxBlock, uptimeS;
+    AcqStats acq;
+    FsStats fs;
+};
+
+static void readGauges(Gauges &g) {
+    g.heapFree = ESP.getFreeHeap();
+    g.heapMin = ESP.getMinFreeHeap();
+    g.heapMaxBlock = ESP.getMaxAllocHeap();
+    g.uptimeS = millis() / 1000;
+    ACQ_getStats(g.acq);
+    FS_getStats(g.fs);
+}
+
+void MET_writePrometheus(Print &out) {
+    for (uint8_t s = 0; s < MET_STAGES && METRICS_ENABLED; s++) {
+        MetStageStats st;
+        MET_getStage((MetStage)s, st);
+        if (s == 0) out.print("# TYPE bat_stage_us histogram\n");
+        uint32_t acc = 0;
+        for (uint8_t i = 0; i < MET_BUCKETS - 1; i++) {
+            acc += st.buckets[i];
+            out.printf("bat_stage_us_bucket{stage=\"%s\",le=\"%lu\"} %lu\n",
+                kStageNames[s], (unsigned long)(1UL << i), (unsigned long)acc);
+        }
+        out.printf("bat_stage_us_bucket{stage=\"%s\",le=\"+Inf\"} %lu\n", kStageNames[s], (unsigned long)st.count);
+        out.printf("bat_stage_us_sum{stage=\"%s\"} %llu\n", kStageNames[s], (unsigned long long)st.sumUs);
+        out.printf("bat_stage_us_count{stage=\"%s\"} %lu\n", kStageNames[s], (unsigned long)st.count);
+        out.printf("bat_stage_us_max{stage=\"%s\"} %lu\n", kStageNames[s], (unsigned long)st.maxUs);
+    }
+    for (uint8_t c = 0; c < MET_COUNTERS && METRICS_ENABLED; c++) {
+        out.printf("# TYPE bat_%s_total counter\nbat_%s_total %lu\n",
+            kCounterNames[c], kCounterNames[c], (unsigned long)counterValue(c));
+    }
+
+    Gauges g;
+    readGauges(g);
+    out.printf("# TYPE bat_heap_free_bytes gauge\nbat_heap_free_bytes %lu\n", (unsigned long)g.heapFree);
+    out.printf("# TYPE bat_heap_min_free_bytes gauge\nbat_heap_min_free_bytes %lu\n", (unsigned long)g.heapMin);
+    out.printf("# TYPE bat_heap_max_block_bytes gauge\nbat_heap_max_block_bytes %lu\n", (unsigned long)g.heapMaxBlock);
+    out.printf("# TYPE bat_uptime_seconds counter\nbat_uptime_seconds %lu\n", (unsigned long)g.uptimeS);
+    out.printf("# TYPE bat_samples_total counter\nbat_samples_total %lu\n", (unsigned long)g.acq.produced);
+    out.printf("# TYPE bat_queue_overflows_total counter\nbat_queue_overflows_total %lu\n", (unsigned long)g.acq.overflows);
+    out.printf("# TYPE bat_queue_high_water gauge\nbat_queue_high_water %u\n", (unsigned)g.acq.highWater);
+    out.printf("# TYPE bat_rate_level gauge\nbat_rate_level %u\n", (unsigned)g.acq.rateLevel);
+    out.printf("# TYPE bat_fs_bytes_written_total counter\nbat_fs_bytes_written_total %lu\n", (unsigned long)g.fs.bytesWritten);
+    out.printf("# TYPE bat_fs_dropped_blocks_total counter\nbat_fs_dropped_blocks_total %lu\n", (unsigned long)g.fs.droppedBlocks);
+    out.printf("# TYPE bat_fs_buffered_blocks gauge\nbat_fs_buffered_blocks %u\n", (unsigned)g.fs.bufferedBlocks);
+}
+
+void MET_writeJson(Print &out) {
+    out.printf("{\"enabled\":%s,\"stages\":{", METRICS_ENABLED ? "true" : "false");
+    for (uint8_t s = 0; s < MET_STAGES && METRICS_ENABLED; s++) {
+        MetStageStats st;
+        MET_getStage((MetStage)s, st);
+        out.printf("%s\"%s\":{\"count\":%lu,\"sumUs\":%llu,\"maxUs\":%lu,\"p50Us\":%lu,\"p99Us\":%lu,\"buckets\":[",
+            s ? "," : "", kStageNames[s], (unsigned long)st.count, (unsigned long long)st.sumUs,
+            (unsigned long)st.maxUs, (unsigned long)quantileUs(st, 0.5f), (unsigned long)quantileUs(st, 0.99f));
+        for (uint8_t i = 0; i < MET_BUCKETS; i++) out.printf("%s%lu", i ? "," : "", (unsigned long)st.buckets[i]);
+        out.print("]}");
+    }
+    out.print("},\"counters\":{");
+    for (uint8_t c = 0; c < MET_COUNTERS && METRICS_ENABLED; c++) {
+        out.printf("%s\"%s\":%lu", c ? "," : "", kCounterNames[c], (unsigned long)counterValue(c));
+    }
+    Gauges g;
+    readGauges(g);
+    out.printf("},\"heap\":{\"free\":%lu,\"minFree\":%lu,\"maxBlock\":%lu},\"uptimeS\":%lu,",
+        (unsigned long)g.heapFree, (unsigned long)g.heapMin, (unsigned long)g.heapMaxBlock, (unsigned long)g.uptimeS);
+    out.printf("\"acq\":{\"samples\":%lu,\"overflows\":%lu,\"highWater\":%u,\"capacity\":%u,\"rateLevel\":%u},",
+        (unsigned long)g.acq.produced, (unsigned long)g.acq.overflows, (unsigned)g.acq.highWater,
+        (unsigned)g.acq.capacity, (unsigned)g.acq.rateLevel);
+    out.printf("\"fs\":{\"bytesWritten\":%lu,\"droppedBlocks\":%lu,\"bufferedBlocks\":%u}}",
+        (unsigned long)g.fs.bytesWritten, (unsigned long)g.fs.droppedBlocks, (unsigned)g.fs.bufferedBlocks);
+}
+
+void MET_setDumpInterval(uint32_t sec) {
+    dumpIntervalMs = sec * 1000;
+}
+
+void MET_tick() {
+    static uint32_t last = 0;
+    if (!dumpIntervalMs || millis() - last < dumpIntervalMs) return;
+    last = millis();
+    for (uint8_t s = 0; s < MET_STAGES && METRICS_ENABLED; s++) {
+        MetStageStats st;
+        MET_getStage((MetStage)s, st);
+        if (!st.count) continue;
+        Serial.printf("[MET] %-10s n=%lu média=%lu us p99<=%lu us máx=%lu us\n", kStageNames[s],
+            (unsigned long)st.count, (unsigned long)(st.sumUs / st.count),
+            (unsigned long)quantileUs(st, 0.99f), (unsigned long)st.maxUs);
+    }
+    Serial.printf("[MET] timeouts=%lu erros=%lu ws_pulados=%lu loop_estouros=%lu heap=%lu (mín %lu)\n",
+        (unsigned long)counterValue(MET_ADS_TIMEOUT), (unsigned long)counterValue(MET_ADS_ERROR),
+        (unsigned long)counterValue(MET_WS_SKIPPED), (unsigned long)counterValue(MET_LOOP_OVERRUN),
+        (unsigned long)ESP.getFreeHeap(), (unsigned long)ESP.getMinFreeHeap());
+}
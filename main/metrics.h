@@ -0,0 +1,109 @@
+#pragma once
+#include <Arduino.h>
+
+/**
+ * Instrumentação dos caminhos quentes: histogramas de duração por etapa
+ * (baldes log2 em µs) e contadores de eventos, atualizados com operações
+ * atômicas de qualquer tarefa. Com METRICS_ENABLED=0 as macros somem do
+ * código e só os indicadores de heap/fila continuam disponíveis.
+ */
+
+#ifndef METRICS_ENABLED
+#define METRICS_ENABLED 1
+#endif
+
+enum MetStage : uint8_t {
+    MET_ADS_CONV,     // Uma conversão do ADS1115 (disparo até o resultado)
+    MET_ADS_SAMPLE,   // Aquisição completa (canais x oversampling)
+    MET_FS_APPEND,    // FS_append(): redução + codificação do registro
+    MET_FS_FLUSH,     // Gravação de um lote na SPIFFS (escritas + flush)
+    MET_WS_ENCODE,    // Serialização de um quadro WS (binário ou JSON)
+    MET_NET_TICK,     // NET_tick() completo (serialização + envio)
+    MET_LOOP,         // Uma volta do loop() sem o delay
+    MET_STAGES
+};
+
+enum MetCounter : uint8_t {
+    MET_ADS_TIMEOUT,    // Conversões perdidas (barramento reinicializado)
+    MET_ADS_ERROR,      // Aquisições descartadas por leituras inválidas
+    MET_WS_SKIPPED,     // Quadros não enviados a um cliente com fila cheia
+    MET_LOOP_OVERRUN,   // Voltas do loop() acima de MET_LOOP_BUDGET_US
+    MET_COUNTERS
+};
+
+static constexpr uint8_t  MET_BUCKETS = 16;            // < 2^1 µs ... < 2^15 µs, e o último aberto
+static constexpr uint32_t MET_LOOP_BUDGET_US = 50000;  // Acima disso o consumo da fila atrasa
+
+/**
+ * Resumo de uma etapa.
+ */
+struct MetStageStats {
+    uint32_t count;
+    uint64_t sumUs;
+    uint32_t maxUs;
+    uint32_t buckets[MET_BUCKETS];   // Contagem por balde (não cumulativa)
+};
+
+#if METRICS_ENABLED
+/**
+ * Registra a duração de uma etapa.
+ * @param s Etapa.
+ * @param us Duração em µs.
+ */
+void MET_record(MetStage s, uint32_t us);
+
+/**
+ * Incrementa um contador.
+ * @param c Contador.
+ * @param n Incremento.
+ */
+void MET_count(MetCounter c, uint32_t n = 1);
+
+// Mede o escopo atual como uma etapa.
+struct MetTimer {
+    MetStage stage;
+    uint32_t t0;
+    explicit MetTimer(MetStage s) : stage(s), t0(micros()) {}
+    ~MetTimer() { MET_record(stage, micros() - t0); }
+};
+
+#define MET_CAT_(a, b) a##b
+#define MET_CAT(a, b) MET_CAT_(a, b)
+#define MET_SCOPE(stage) MetTimer MET_CAT(metTimer_, __LINE__)(stage)
+#define MET_RECORD(stage, us) MET_record(stage, us)
+#define MET_COUNT(c) MET_count(c)
+#else
+#define MET_SCOPE(stage) ((void)0)
+#define MET_RECORD(stage, us) ((void)sizeof(us))   // Não avalia a expressão
+#define MET_COUNT(c) ((void)0)
+#endif
+
+/**
+ * Copia o resumo de uma etapa (zerado com METRICS_ENABLED=0).
+ * @param s Etapa.
+ * @param out Estrutura a preencher.
+ */
+void MET_getStage(MetStage s, MetStageStats &out);
+
+/**
+ * Escreve as métricas no formato de texto do Prometheus.
+ * @param out Destino (resposta HTTP, Serial...).
+ */
+void MET_writePrometheus(Print &out);
+
+/**
+ * Escreve as métricas em JSON.
+ * @param out Destino.
+ */
+void MET_writeJson(Print &out);
+
+/**
+ * Define o intervalo do resumo periódico no serial.
+ * @param sec Intervalo em segundos (0 = desligado).
+ */
+void MET_setDumpInterval(uint32_t sec);
+
+/**
+ * Imprime o resumo no serial quando o intervalo vence. Chamar do loop().
+ */
+void MET_tick();
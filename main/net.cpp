@@ -5,9 +5,20 @@
 #include <AsyncTCP.h>
 #include <ESPAsyncWebServer.h>
 #include <ArduinoJson.h>
+#include <memory>
+#include <new>
 #include "storage.h"
+#include "gzip_stream.h"
+#include "query.h"
+#include "recent.h"
 #include "config.h"
 #include "ads_driver.h"
+#include "acquisition.h"
+#include "timebase.h"
+#include "metrics.h"
+#include "events.h"
+#include "uplink.h"
+#include "ws_frame.h"
 
 static AsyncWebServer server(80);
 static AsyncWebSocket ws("/ws");
@@ -15,97 +26,639 @@ static AsyncWebSocket ws("/ws");
 const char *SSID = "Mocoto";
 const char *PASS = "1234567i";
 static constexpr long TZ_OFFSET = -3 * 3600;
+static constexpr uint8_t CALIB_SAMPLES = 6;        // Aquisições promediadas na calibração
+static constexpr uint32_t WIFI_RETRY_MS = 30000;   // Nova tentativa de conexão enquanto offline
+static constexpr const char *REPLAY_PATH = "/replay.csv";   // Destino do upload e arquivo padrão da reprodução
+static constexpr size_t REPLAY_MAX_BYTES = 1024 * 1024;     // Teto do upload de captura (~25 mil linhas de 4 células)
+static constexpr uint16_t ALARMS_MAX_EVENTS = 100;   // Teto de ?n= em /api/alarms (a resposta é montada na RAM)
 
-// Monitor + Setup
-static void putIndex() {
-    File f = SPIFFS.open("/index.html", "w");
-    f.print(index_html);
+// Calibração pedida pelo POST e ainda não concluída (só a tarefa AsyncTCP acessa).
+static struct {
+    uint32_t id = 0;                 // Captura em andamento (ACQ_captureStart), 0 = nenhuma
+    float    mv[PACK_CELLS] = {0};   // Tensões medidas no multímetro, em mV
+} calibPending;
+
+// Lê um parâmetro inteiro de 64 bits da query string (timestamps em ms).
+static uint64_t paramU64(AsyncWebServerRequest *r, const char *name, uint64_t def) {
+    if (!r->hasParam(name)) return def;
+    return strtoull(r->getParam(name)->value().c_str(), nullptr, 10);
+}
+
+// Upload de captura em andamento, em AsyncWebServerRequest::_tempObject
+// (liberado pela requisição com free()).
+struct ReplayUpload {
+    int    code;    // Resposta: 200, 409 (reprodução em andamento), 413 (não cabe) ou 500 (erro de escrita)
+    size_t limit;   // REPLAY_MAX_BYTES ou o espaço livre da SPIFFS, o que for menor
+};
+
+// Interrompe o upload: o arquivo parcial não fica para uma reprodução.
+static void failReplayUpload(AsyncWebServerRequest *r, ReplayUpload *u, int code) {
+    u->code = code;
+    if (r->_tempFile) r->_tempFile.close();
+    SPIFFS.remove(REPLAY_PATH);
+}
+
+// CSV do log, gerado em trechos. Com gzip, cada trecho do CSV passa pelo
+// compressor de memória fixa antes de sair (~3x menos bytes no Wi-Fi).
+struct CsvDownload {
+    std::unique_ptr<CsvExport, void (*)(CsvExport *)> exp{nullptr, FS_csvClose};
+    GzipStream gz;
+    uint8_t    in[GZ_CHUNK];
+};
+
+static void sendCsv(AsyncWebServerRequest *r, uint64_t since) {
+    AsyncWebServerResponse *resp;
+    if (r->hasHeader("Accept-Encoding") && r->header("Accept-Encoding").indexOf("gzip") >= 0) {
+        std::shared_ptr<CsvDownload> d(new (std::nothrow) CsvDownload());
+        if (d) d->exp.reset(FS_csvOpen(since));
+        if (!d || !d->exp) { r->send(503, "text/plain", "Sem memória"); return; }
+        d->gz.begin();
+        resp = r->beginChunkedResponse("text/csv",
+            [d](uint8_t *buf, size_t maxLen, size_t index) -> size_t {
+                size_t n = 0;
+                for (;;) {
+                    n += d->gz.read(buf + n, maxLen - n);
+                    if (d->gz.pending() || d->gz.finished()) break;
+                    size_t len = FS_csvRead(d->exp.get(), d->in, sizeof(d->in));
+                    if (len) d->gz.write(d->in, len);
+                    else d->gz.finish();
+                }
+                return n;
+            });
+        resp->addHeader("Content-Encoding", "gzip");
+    } else {
+        std::shared_ptr<CsvExport> exp(FS_csvOpen(since), FS_csvClose);
+        if (!exp) { r->send(503, "text/plain", "Sem memória"); return; }
+        resp = r->beginChunkedResponse("text/csv",
+            [exp](uint8_t *buf, size_t maxLen, size_t index) -> size_t {
+                return FS_csvRead(exp.get(), buf, maxLen);
+            });
+    }
+    resp->addHeader("Content-Disposition", "attachment; filename=\"log.csv\"");
+    r->send(resp);
+}
+
+// Interpreta "Range: bytes=a-b", "bytes=a-" ou "bytes=-n" sobre [start, end).
+// Retorna false se o cabeçalho não existe ou não é um intervalo único.
+static bool parseRange(AsyncWebServerRequest *r, uint64_t start, uint64_t end,
+                       uint64_t &from, uint64_t &to) {
+    if (!r->hasHeader("Range")) return false;
+    String v = r->header("Range");
+    if (!v.startsWith("bytes=") || v.indexOf(',') >= 0) return false;
+    int dash = v.indexOf('-');
+    if (dash < 0) return false;
+    String a = v.substring(6, dash), b = v.substring(dash + 1);
+    if (a.length() == 0) {
+        uint64_t n = strtoull(b.c_str(), nullptr, 10);
+        from = n < end - start ? end - n : start;
+        to = end;
+    } else {
+        from = strtoull(a.c_str(), nullptr, 10);
+        to = b.length() ? strtoull(b.c_str(), nullptr, 10) + 1 : end;
+        if (to > end) to = end;
+        // O início já saiu do anel: entrega a partir do mais antigo disponível
+        // (o Content-Range informa o trecho real).
+        if (from < start) from = start;
+    }
+    return true;
+}
+
+// Blocos binários do log. Os offsets são endereços lógicos do anel, estáveis
+// enquanto o bloco existir: um coletor guarda o último endereço recebido e
+// pede só o restante com "Range: bytes=<fim>-".
+static void sendBinary(AsyncWebServerRequest *r, uint64_t since) {
+    uint64_t start, end;
+    FS_rawRange(since, start, end);
+    uint64_t from = start, to = end;
+    bool partial = parseRange(r, start, end, from, to);
+    if (partial && from >= to) {
+        AsyncWebServerResponse *resp = r->beginResponse(416, "text/plain", "Intervalo fora do log");
+        resp->addHeader("Content-Range", "bytes */" + String((unsigned long long)end));
+        r->send(resp);
+        return;
+    }
+
+    std::shared_ptr<RawExport> raw(FS_rawOpen(from, to), FS_rawClose);
+    if (!raw) { r->send(503, "text/plain", "Sem memória"); return; }
+    AsyncWebServerResponse *resp = r->beginResponse("application/octet-stream", (size_t)(to - from),
+        [raw](uint8_t *buf, size_t maxLen, size_t index) -> size_t {
+            return FS_rawRead(raw.get(), buf, maxLen);
+        });
+    if (partial) {
+        resp->setCode(206);
+        resp->addHeader("Content-Range", "bytes " + String((unsigned long long)from) + "-" +
+                        String((unsigned long long)(to - 1)) + "/" + String((unsigned long long)end));
+    }
+    resp->addHeader("Accept-Ranges", "bytes");
+    resp->addHeader("X-Log-Start", String((unsigned long long)start));
+    resp->addHeader("Content-Disposition", "attachment; filename=\"log.bin\"");
+    r->send(resp);
+}
+
+// --- WebSocket ---
+//
+// Cada cliente escolhe o formato e a taxa com uma mensagem de texto, p.ex.
+// {"fmt":"bin","hz":1}. Padrão: JSON a cada amostra (compatível com clientes
+// antigos). hz = 0 recebe todas as amostras.
+//
+// Quadros: ws_frame.h.
+static constexpr uint8_t WS_BATCH = 16;           // Máximo de amostras num quadro ao vivo
+static constexpr uint8_t WS_MAX_PEERS = 8;
+
+struct WsPeer {
+    uint32_t id;            // AsyncWebSocketClient::id(), 0 = livre
+    bool     binary;
+    uint16_t minIntervalMs; // 1000 / hz (0 = sem limite)
+    uint32_t lastSentMs;
+    uint32_t nextSeq;       // Próxima amostra que o cliente ainda não recebeu
+    uint32_t skipped;       // Envios pulados por fila cheia
+};
+
+static WsPeer peers[WS_MAX_PEERS];
+
+// Os eventos do WebSocket chegam pela tarefa AsyncTCP; NET_tick() roda no loop().
+static SemaphoreHandle_t wsMutex = nullptr;
+
+struct WsLock {
+    WsLock()  { xSemaphoreTakeRecursive(wsMutex, portMAX_DELAY); }
+    ~WsLock() { xSemaphoreGiveRecursive(wsMutex); }
+};
+
+static WsPeer *peerOf(uint32_t id) {
+    for (WsPeer &p : peers) if (p.id == id) return &p;
+    return nullptr;
+}
+
+// Monta em 'buf' (WSF_binarySize(count) bytes) um quadro binário com até
+// 'count' amostras do anel a partir de 'from'. Retorna o tamanho do quadro.
+static size_t encodeBatch(uint8_t *buf, uint8_t type, uint32_t from, uint16_t count) {
+    MET_SCOPE(MET_WS_ENCODE);
+    uint8_t *out = buf + sizeof(WsFrameHeader);
+    uint16_t n = 0;
+    CellSample tmp[16];
+    while (n < count) {
+        size_t got = REC_read(from, tmp, count - n < 16 ? count - n : 16);
+        if (!got) break;
+        out += WSF_putSamples(out, tmp, got);
+        n += got;
+    }
+    WSF_putHeader(buf, type, n);
+    return WSF_binarySize(n);
+}
+
+// Intervalo mínimo entre envios para 'hz' mensagens por segundo (0 = sem
+// limite). Abaixo de ~0,015 Hz o intervalo não cabe em 16 bits: satura.
+static uint16_t intervalOf(float hz) {
+    if (!(hz > 0)) return 0;
+    if (hz * UINT16_MAX <= 1000.0f) return UINT16_MAX;
+    return (uint16_t)(1000.0f / hz);
+}
+
+// Histórico inicial de um cliente que passou ao binário: o anel inteiro num
+// só quadro, para o gráfico não começar vazio; os quadros ao vivo continuam
+// de onde ele termina. Anel vazio não gera quadro. Retorna as amostras enviadas.
+static uint16_t sendBackfill(AsyncWebSocketClient *cli, WsPeer &p) {
+    RecStats rs;
+    REC_getStats(rs);
+    p.nextSeq = rs.seq;
+    if (!rs.count) return 0;
+    uint8_t *buf = new (std::nothrow) uint8_t[WSF_binarySize(rs.count)];
+    if (!buf) return 0;
+    cli->binary(buf, encodeBatch(buf, WS_FRAME_BACKFILL, rs.seq - rs.count, rs.count));
+    delete[] buf;
+    return rs.count;
+}
+
+static void onWsEvent(AsyncWebSocket *srv, AsyncWebSocketClient *cli, AwsEventType type,
+                      void *arg, uint8_t *data, size_t len) {
+    WsLock lock;
+    if (type == WS_EVT_CONNECT) {
+        WsPeer *p = peerOf(0);
+        if (!p) { cli->close(); return; }
+        // Começa em JSON (clientes antigos); o histórico só vai a quem pedir binário.
+        *p = WsPeer{cli->id(), false, 0, 0, REC_seq(), 0};
+        Serial.printf("[WS] cliente %u conectado\n", (unsigned)cli->id());
+    } else if (type == WS_EVT_DISCONNECT) {
+        WsPeer *p = peerOf(cli->id());
+        if (p) {
+            Serial.printf("[WS] cliente %u desconectado (%u envios pulados)\n",
+                (unsigned)p->id, (unsigned)p->skipped);
+            p->id = 0;
+        }
+    } else if (type == WS_EVT_DATA) {
+        AwsFrameInfo *info = (AwsFrameInfo *)arg;
+        WsPeer *p = peerOf(cli->id());
+        if (!p || !info->final || info->index != 0 || info->len != len || info->opcode != WS_TEXT) return;
+        StaticJsonDocument<96> d;
+        if (deserializeJson(d, data, len)) return;
+        const bool wasBinary = p->binary;
+        if (d.containsKey("fmt")) p->binary = d["fmt"] == "bin";
+        if (d.containsKey("hz")) p->minIntervalMs = intervalOf(d["hz"].as<float>());
+        uint16_t backfill = 0;
+        if (p->binary && !wasBinary) backfill = sendBackfill(cli, *p);
+        Serial.printf("[WS] cliente %u: %s, intervalo %u ms (%u amostras de histórico)\n", (unsigned)p->id,
+            p->binary ? "binário" : "JSON", (unsigned)p->minIntervalMs, (unsigned)backfill);
+    }
+}
+
+// Dashboard (web_ui.h): gzip direto da flash, sem cópia na SPIFFS. O ETag é o
+// hash do conteúdo; "/" é sempre revalidado (304 sem corpo enquanto o firmware
+// não muda) e o script, de URL versionada, fica em cache por um ano.
+static void serveAsset(AsyncWebServerRequest *r, const UiAsset &a) {
+    const char *cache = a.immutable ? "public, max-age=31536000, immutable" : "no-cache";
+    AsyncWebServerResponse *resp;
+    if (r->hasHeader("If-None-Match") && r->header("If-None-Match").indexOf(a.etag) >= 0) {
+        resp = r->beginResponse(304);
+    } else {
+        // Todo navegador aceita gzip; o corpo não é recomprimido nem copiado para a RAM.
+        resp = r->beginResponse_P(200, a.type, a.gz, a.len);
+        resp->addHeader("Content-Encoding", "gzip");
+    }
+    resp->addHeader("ETag", a.etag);
+    resp->addHeader("Cache-Control", cache);
+    r->send(resp);
 }
 
 void NET_init() {
-    SPIFFS.remove("/index.html");
-    putIndex();
+    wsMutex = xSemaphoreCreateRecursiveMutex();
+    // Cópia da página gravada pelas versões anteriores.
+    if (SPIFFS.exists("/index.html")) SPIFFS.remove("/index.html");
 
+    // Não bloqueia: a conexão e o NTP sobem em segundo plano enquanto a
+    // aquisição já está gravando (NET_poll() acompanha o estado).
     WiFi.mode(WIFI_STA);
+    WiFi.setAutoReconnect(true);
     WiFi.begin(SSID, PASS);
-    uint32_t t0 = millis();
-    while (WiFi.status() != WL_CONNECTED && millis() - t0 < 30000) delay(100);
-    if (WiFi.status() != WL_CONNECTED) {
-        WiFi.disconnect(true);
-        WiFi.mode(WIFI_OFF);
-        esp_sleep_enable_timer_wakeup(5 * 60 * 1000000ULL);
-        Serial.flush();
-        esp_deep_sleep_start();
-    }
-
     configTime(TZ_OFFSET, 0, "pool.ntp.org");
-    struct tm tmcheck; time_t now; uint32_t ntpTimeout=millis();
-    do{ now=time(nullptr); localtime_r(&now,&tmcheck); }while(now<1600000000 && millis()-ntpTimeout<2000);
 
-    server.on("/", HTTP_GET, [](auto *r){ r->send(SPIFFS, "/index.html", "text/html"); });
-    server.on("/download", HTTP_GET, [](auto *r){ r->send(SPIFFS, "/log.csv", "text/csv", true); });
-    server.on("/api/raw", HTTP_GET, [](auto *r){ int16_t raw[4]; ADS_raw(raw); StaticJsonDocument<128> d; for(int i=0;i<4;i++) d["raw"][i]=raw[i]; d["lsb"]=0.1875; String o; serializeJson(d,o); r->send(200,"application/json",o); });
+    for (const UiAsset &a : UI_ASSETS) {
+        server.on(a.path, HTTP_GET, [&a](AsyncWebServerRequest *r){ serveAsset(r, a); });
+    }
+    // O log é binário; o CSV é gerado sob demanda, em trechos, sem carregar o arquivo na RAM.
+    // /download[?since=<ms>]: CSV, comprimido com gzip se o cliente aceitar.
+    // /download?format=bin[&since=<ms>]: blocos binários, com suporte a Range.
+    // Sem FS_sync(): o CSV lê o que está na RAM pelo cursor, e o binário só
+    // serve blocos já gravados (os da RAM vêm no próximo Range).
+    server.on("/download", HTTP_GET, [](AsyncWebServerRequest *r){
+        uint64_t since = paramU64(r, "since", 0);
+        if (r->hasParam("format") && r->getParam("format")->value() == "bin") sendBinary(r, since);
+        else sendCsv(r, since);
+    });
+    // Histórico reduzido: /api/history?from=<ms>&to=<ms>&points=<n>&fmt=json|bin
+    // Padrão: última hora, 300 pontos. A resposta é gerada em trechos direto do log.
+    server.on("/api/history", HTTP_GET, [](AsyncWebServerRequest *r){
+        // 'to' no futuro vale agora (QRY_open também limita); o 'from' padrão sai dele.
+        const uint64_t now = TIME_nowMs();
+        uint64_t to = paramU64(r, "to", now);
+        if (to > now) to = now;
+        uint64_t from = paramU64(r, "from", to > 3600000ULL ? to - 3600000ULL : 0);
+        uint64_t pts = paramU64(r, "points", 300);
+        uint16_t points = pts > QRY_MAX_POINTS ? QRY_MAX_POINTS : (uint16_t)pts;
+        bool binary = r->hasParam("fmt") && r->getParam("fmt")->value() == "bin";
+
+        std::shared_ptr<HistoryQuery> q(QRY_open(from, to, points, binary), QRY_close);
+        if (!q) { r->send(400, "text/plain", "Intervalo inválido"); return; }
+        AsyncWebServerResponse *resp = r->beginChunkedResponse(
+            binary ? "application/octet-stream" : "application/json",
+            [q](uint8_t *buf, size_t maxLen, size_t index) -> size_t {
+                return QRY_read(q.get(), buf, maxLen);
+            });
+        r->send(resp);
+    });
+    // Valores da última aquisição, lidos do snapshot: não toca no barramento I2C.
+    server.on("/api/raw", HTTP_GET, [](auto *r){
+        AcqSnapshot snap;
+        if (!ACQ_snapshot(snap)) { r->send(503, "text/plain", "Sem aquisição ainda"); return; }
+        StaticJsonDocument<JSON_OBJECT_SIZE(8) + 2 * JSON_ARRAY_SIZE(PACK_CELLS)> d;
+        for (int i = 0; i < PACK_CELLS; i++) {
+            d["raw"][i] = snap.raw[i];
+            d["mv"][i] = snap.mv[i];
+        }
+        d["total"] = snap.total;
+        d["flags"] = snap.flags;
+        d["rate"] = SCHED_name((SchedLevel)((snap.flags & SAMPLE_FLAG_RATE_MASK) >> SAMPLE_FLAG_RATE_SHIFT));
+        d["t"] = snap.epochMs;
+        d["lsb"] = 0.1875;
+        String o;
+        serializeJson(d, o);
+        r->send(200, "application/json", o);
+    });
 
+    // Calibração em duas etapas, sem prender a tarefa AsyncTCP: o POST guarda
+    // as tensões medidas e pede a captura bruta (202); o GET consulta e, quando
+    // a captura termina, calcula, aplica e salva os fatores.
     server.on("/api/calibrate", HTTP_POST, [](AsyncWebServerRequest *request){}, NULL,
     [](AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
         // Faz o parse do corpo da requisição JSON
         String body((char*)data, len);
-        StaticJsonDocument<128> d;
+        StaticJsonDocument<JSON_OBJECT_SIZE(1) + JSON_ARRAY_SIZE(PACK_CELLS) + 32> d;
         if (deserializeJson(d, body)) {
             request->send(400, "text/plain", "Erro de JSON");
             return;
         }
+        JsonArray v_cells = d["v"];
+        if (v_cells.size() != PACK_CELLS) {
+            request->send(400, "text/plain", "Número de tensões diferente do número de células");
+            return;
+        }
+        ReplayStats rs;
+        ACQ_getReplayStats(rs);
+        if (rs.state == RPL_RUNNING) {
+            request->send(409, "text/plain", "Reprodução em andamento");
+            return;
+        }
+
+        // Média bruta de algumas aquisições, feita pela tarefa dona do ADC.
+        uint32_t id = ACQ_captureStart(CALIB_SAMPLES);
+        if (!id) {
+            request->send(409, "text/plain", "Calibração em andamento ou aquisição indisponível");
+            return;
+        }
+        calibPending.id = id;
+        for (int i = 0; i < PACK_CELLS; i++) calibPending.mv[i] = v_cells[i];
+        request->send(202, "text/plain", "Capturando");
+    });
+
+    server.on("/api/calibrate", HTTP_GET, [](AsyncWebServerRequest *request) {
+        if (!calibPending.id) {
+            request->send(404, "text/plain", "Nenhuma calibração pendente");
+            return;
+        }
+        float raw[PACK_CELLS];
+        AcqCaptureState st = ACQ_capturePoll(calibPending.id, raw);
+        if (st == CAP_RUNNING) {
+            request->send(202, "text/plain", "Capturando");
+            return;
+        }
+        calibPending.id = 0;
+        if (st == CAP_FAILED) {
+            request->send(503, "text/plain", "Aquisição indisponível");
+            return;
+        }
 
         Calib novaCalib;
-        int16_t raw[4];
-        ADS_raw(raw);
-        JsonArray v_cells = d["v"];
         float v_cumulative = 0.0f;
 
-        for (int i = 0; i < 4; i++) {
+        for (int i = 0; i < PACK_CELLS; i++) {
             // Verifica se a leitura raw do ADC é <= 0
             if (raw[i] <= 0) {
-                Serial.printf("[CALIB] Leitura raw inválida no canal %d: raw=%d. Abortando.\n", i + 1, raw[i]);
+                Serial.printf("[CALIB] Leitura raw inválida no canal %d: raw=%.1f. Abortando.\n", i + 1, raw[i]);
                 request->send(422, "text/plain", "Leitura raw inválida do ADC");
                 return; // Aborta a calibração completamente se um valor for inválido
             }
             
             // Acumula a tensão real medida para cada pino do ADC
-            v_cumulative += (float)v_cells[i];
+            v_cumulative += calibPending.mv[i];
             
             // Calcula o novo fator de calibração
             novaCalib.kDiv[i] = v_cumulative / (raw[i] * 0.1875f);
         }
 
         // Se o loop completou, os dados são válidos. Aplica e salva
-        ADS_setKDiv(novaCalib.kDiv);
+        ACQ_setKDiv(novaCalib.kDiv);
         CFG_save(novaCalib);
         Serial.println("[CALIB] Nova calibração salva:");
-        for (int i = 0; i < 4; i++) Serial.printf("  kDiv[%d] = %.6f\n", i, novaCalib.kDiv[i]);
+        for (int i = 0; i < PACK_CELLS; i++) Serial.printf("  kDiv[%d] = %.6f\n", i, novaCalib.kDiv[i]);
         request->send(200, "text/plain", "Calibração aplicada");
     });
 
+    // Perfil de aquisição: GET lê; POST {"rate","oversample","filter","iirShift"} aplica e salva.
+    server.on("/api/profile", HTTP_GET, [](auto *r){
+        AdsProfile p;
+        ACQ_getProfile(p);
+        StaticJsonDocument<128> d;
+        d["rate"] = p.dataRate;
+        d["oversample"] = p.oversample;
+        d["filter"] = FLT_name(p.filter);
+        d["iirShift"] = p.iirShift;
+        d["sampleMs"] = ADS_sampleTimeUs(p) / 1000;
+        String o;
+        serializeJson(d, o);
+        r->send(200, "application/json", o);
+    });
+    server.on("/api/profile", HTTP_POST, [](AsyncWebServerRequest *request){}, NULL,
+    [](AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
+        StaticJsonDocument<128> d;
+        if (deserializeJson(d, data, len)) {
+            request->send(400, "text/plain", "Erro de JSON");
+            return;
+        }
+        AdsProfile p;
+        ACQ_getProfile(p);
+        p.dataRate = d["rate"] | p.dataRate;
+        p.oversample = d["oversample"] | p.oversample;
+        p.iirShift = d["iirShift"] | p.iirShift;
+        if (d.containsKey("filter") && !FLT_parse(d["filter"], p.filter)) {
+            request->send(400, "text/plain", "Filtro desconhecido");
+            return;
+        }
+        if (!ACQ_setProfile(p)) {
+            request->send(422, "text/plain", "Perfil não cabe no período de amostragem");
+            return;
+        }
+        CFG_saveAcqProfile(p);
+        request->send(200, "text/plain", "Perfil aplicado");
+    });
+
+    // Reprodução de capturas. O upload vem antes: "/api/replay" também casaria "/api/replay/upload".
+    // O arquivo da reprodução em andamento não é truncado (409); o que passar
+    // do limite ou falhar na escrita é apagado.
+    server.on("/api/replay/upload", HTTP_POST,
+        [](AsyncWebServerRequest *r){
+            const ReplayUpload *u = (const ReplayUpload *)r->_tempObject;
+            const int code = u ? u->code : 400;
+            r->send(code, "text/plain", code == 200 ? "OK" : code == 409 ? "Reprodução em andamento"
+                : code == 413 ? "Arquivo grande demais" : code == 400 ? "Sem arquivo" : "Erro ao gravar");
+        },
+        [](AsyncWebServerRequest *r, const String &, size_t index, uint8_t *data, size_t len, bool final){
+            ReplayUpload *u = (ReplayUpload *)r->_tempObject;
+            if (index == 0 && !u) {
+                u = (ReplayUpload *)malloc(sizeof(ReplayUpload));
+                if (!u) return;
+                r->_tempObject = u;
+                u->code = 200;
+                ReplayStats st;
+                ACQ_getReplayStats(st);
+                if (st.state == RPL_RUNNING) { u->code = 409; return; }
+                r->_tempFile = SPIFFS.open(REPLAY_PATH, FILE_WRITE);
+                if (!r->_tempFile) { failReplayUpload(r, u, 500); return; }
+                // Medido depois de truncar: o arquivo anterior já não conta.
+                const size_t avail = SPIFFS.totalBytes() - SPIFFS.usedBytes();
+                u->limit = avail < REPLAY_MAX_BYTES ? avail : REPLAY_MAX_BYTES;
+            }
+            if (!u || u->code != 200) return;
+            if (index + len > u->limit) { failReplayUpload(r, u, 413); return; }
+            if (r->_tempFile.write(data, len) != len) { failReplayUpload(r, u, 500); return; }
+            if (final) r->_tempFile.close();
+        });
+    // POST /api/replay?file=&speed=&loops= inicia (speed 0 = máxima), ?stop=1 interrompe; GET lê o andamento.
+    server.on("/api/replay", HTTP_POST, [](AsyncWebServerRequest *r){
+        if (r->hasParam("stop")) {
+            r->send(ACQ_stopReplay() ? 200 : 503, "text/plain", "STOP");
+            return;
+        }
+        ReplayConfig cfg = {};
+        String path = r->hasParam("file") ? r->getParam("file")->value() : String(REPLAY_PATH);
+        if (path.length() >= sizeof(cfg.path) || !SPIFFS.exists(path)) {
+            r->send(404, "text/plain", "Arquivo não encontrado");
+            return;
+        }
+        ReplayStats st;
+        ACQ_getReplayStats(st);
+        if (st.state == RPL_RUNNING) { r->send(409, "text/plain", "Reprodução em andamento"); return; }
+        strlcpy(cfg.path, path.c_str(), sizeof(cfg.path));
+        cfg.speed = (uint16_t)paramU64(r, "speed", 1);
+        cfg.loops = (uint8_t)paramU64(r, "loops", 1);
+        r->send(ACQ_startReplay(cfg) ? 202 : 503, "text/plain", "STARTED");
+    });
+    server.on("/api/replay", HTTP_GET, [](AsyncWebServerRequest *r){
+        static const char *const kStates[] = {"idle", "running", "done", "error"};
+        ReplayStats st;
+        ACQ_getReplayStats(st);
+        AcqStats acq;
+        ACQ_getStats(acq);
+        StaticJsonDocument<384> d;
+        d["state"] = kStates[st.state];
+        d["speed"] = st.speed;
+        d["rows"] = st.rows;
+        d["badRows"] = st.badRows;
+        d["fed"] = st.fed;
+        d["dropped"] = st.dropped;
+        d["elapsedMs"] = st.elapsedMs;
+        d["recordedMs"] = st.recordedMs;
+        d["rate"] = st.elapsedMs ? st.fed * 1000.0f / st.elapsedMs : 0;
+        d["queueDepth"] = acq.depth;
+        d["queueHighWater"] = acq.highWater;
+        d["queueCapacity"] = acq.capacity;
+        String o;
+        serializeJson(d, o);
+        r->send(200, "application/json", o);
+    });
+    // Alarmes: ativos e os últimos eventos do log (?n=<quantos>, padrão 50, até ALARMS_MAX_EVENTS).
+    server.on("/api/alarms", HTTP_GET, [](AsyncWebServerRequest *r){
+        uint64_t n = paramU64(r, "n", 50);
+        if (n > ALARMS_MAX_EVENTS) n = ALARMS_MAX_EVENTS;
+        AsyncResponseStream *resp = r->beginResponseStream("application/json");
+        EVT_writeJson(*resp, (uint16_t)n);
+        r->send(resp);
+    });
+    // Tempos por etapa, contadores e heap: texto do Prometheus ou ?fmt=json.
+    server.on("/api/metrics", HTTP_GET, [](AsyncWebServerRequest *r){
+        bool json = r->hasParam("fmt") && r->getParam("fmt")->value() == "json";
+        AsyncResponseStream *resp = r->beginResponseStream(json ? "application/json" : "text/plain; version=0.0.4");
+        if (json) MET_writeJson(*resp);
+        else MET_writePrometheus(*resp);
+        r->send(resp);
+    });
+    // Envio ao coletor: cursor, blocos pendentes e contadores.
+    server.on("/api/uplink", HTTP_GET, [](AsyncWebServerRequest *r){
+        AsyncResponseStream *resp = r->beginResponseStream("application/json");
+        UPL_writeJson(*resp);
+        r->send(resp);
+    });
+    // Base de tempo: boot atual e correções dos timestamps gravados antes do NTP.
+    server.on("/api/time", HTTP_GET, [](auto *r){
+        TimeFix fixes[TIME_MAX_FIXES];
+        uint8_t n = TIME_fixes(fixes, TIME_MAX_FIXES);
+        DynamicJsonDocument d(256 + n * 96);
+        d["boot"] = TIME_bootId();
+        d["synced"] = TIME_synced();
+        d["now"] = TIME_nowMs();
+        JsonArray arr = d.createNestedArray("fixes");
+        for (uint8_t i = 0; i < n; i++) {
+            JsonObject o = arr.createNestedObject();
+            o["boot"] = fixes[i].bootId;
+            o["from"] = fixes[i].fromMs;
+            o["to"] = fixes[i].toMs;
+            o["correction"] = fixes[i].correctionMs;
+        }
+        String o;
+        serializeJson(d, o);
+        r->send(200, "application/json", o);
+    });
     server.on("/api/clear_logs", HTTP_POST, [](auto *r){ FS_clearLogs(); r->send(200, "text/plain", "CLEARED"); });
-    ws.onEvent([](AsyncWebSocket *srv, AsyncWebSocketClient *cli, AwsEventType type, void *arg, uint8_t *data, size_t len){ if(type==WS_EVT_CONNECT) Serial.println("[WS] cliente conectado"); });
+    ws.onEvent(onWsEvent);
     server.addHandler(&ws);
     server.begin();
+    Serial.println("[NET] Servidor iniciado, conectando ao WiFi em segundo plano");
+}
 
-    Serial.printf("[NET] Server pronto – acesse: http://%s\n", WiFi.localIP().toString().c_str());
+void NET_poll() {
+    static bool connected = false;
+    static uint32_t lastAttemptMs = 0;
+    bool now = WiFi.status() == WL_CONNECTED;
+    if (now != connected) {
+        connected = now;
+        if (now) Serial.printf("[NET] WiFi conectado – acesse: http://%s\n", WiFi.localIP().toString().c_str());
+        else Serial.println("[NET] WiFi desconectado");
+        lastAttemptMs = millis();
+    }
+    // O auto-reconnect cobre quedas; se a primeira conexão nunca aconteceu, tenta de novo.
+    if (!connected && millis() - lastAttemptMs >= WIFI_RETRY_MS) {
+        lastAttemptMs = millis();
+        WiFi.disconnect();
+        WiFi.begin(SSID, PASS);
+    }
 }
 
 void NET_tick(const CellSample &s) {
-    StaticJsonDocument<256> d; 
-    char tbuf[9];
-    snprintf(tbuf,9,"%02u:%02u:%02u",(s.epochMs/3600000)%24,(s.epochMs/60000)%60,(s.epochMs/1000)%60);
-    d["t"] = tbuf;
-    JsonArray v_arr = d.createNestedArray("v");
-    JsonArray soc_arr = d.createNestedArray("soc"); 
-    for (uint8_t i = 0; i < 4; i++) {
-        v_arr.add(s.mv[i]);
-        soc_arr.add(s.soc[i]); 
+    WsLock lock;
+    const uint32_t seq = REC_seq();   // A amostra 's' já foi guardada com REC_add()
+
+    uint32_t nowMs = millis();
+    static uint32_t lastCleanupMs = 0;
+    if (nowMs - lastCleanupMs >= 1000) {
+        ws.cleanupClients();   // Libera clientes desconectados e suas filas
+        lastCleanupMs = nowMs;
+    }
+    if (!ws.count()) return;
+    MET_SCOPE(MET_NET_TICK);
+
+    // Cada quadro é serializado uma vez e reaproveitado pelos clientes que
+    // pedem o mesmo conteúdo (a fila de cada cliente guarda a própria cópia).
+    static uint8_t bin[WSF_binarySize(WS_BATCH)];
+    static char json[WS_JSON_MAX];
+    size_t binLen = 0, jsonLen = 0;
+    uint32_t binFrom = 0;
+
+    for (AsyncWebSocketClient *c : ws.getClients()) {
+        if (c->status() != WS_CONNECTED) continue;
+        WsPeer *p = peerOf(c->id());
+        if (!p) continue;
+        if (p->minIntervalMs && nowMs - p->lastSentMs < p->minIntervalMs) continue;
+        // Fila cheia: pula agora; as amostras acumulam e vão juntas no próximo
+        // quadro binário (JSON sempre manda só a mais recente).
+        if (c->queueIsFull()) { p->skipped++; MET_COUNT(MET_WS_SKIPPED); continue; }
+
+        if (p->binary) {
+            uint32_t from = p->nextSeq;
+            if (seq - from > WS_BATCH) from = seq - WS_BATCH;
+            if (!binLen || binFrom != from) {
+                binLen = encodeBatch(bin, WS_FRAME_LIVE, from, (uint16_t)(seq - from));
+                binFrom = from;
+            }
+            c->binary(bin, binLen);
+        } else {
+            if (!jsonLen) {
+                MET_SCOPE(MET_WS_ENCODE);
+                jsonLen = WSF_json(json, sizeof(json), s);
+            }
+            c->text(json, jsonLen);
+        }
+        p->nextSeq = seq;
+        p->lastSentMs = nowMs;
     }
-    d["tot"] = s.total;
-    String o;
-    serializeJson(d, o);
-    ws.textAll(o);
-}
\ No newline at end of file
+}
+
+void NET_sendAlarm(const AlarmEvent &e) {
+    WsLock lock;
+    if (!ws.count()) return;
+    char buf[128];
+    int n = snprintf(buf, sizeof(buf), "{\"type\":\"alarm\",\"t\":%llu,\"kind\":\"%s\",",
+        (unsigned long long)TIME_toWall(e.epochMs, e.flags), ALM_kindName(e.kind));
+    if (e.cell != ALM_PACK) n += snprintf(buf + n, sizeof(buf) - n, "\"cell\":%u,", (unsigned)e.cell);
+    snprintf(buf + n, sizeof(buf) - n, "\"active\":%s,\"value\":%u}", e.active ? "true" : "false", e.value);
+    // Eventos são raros e não se acumulam como as amostras: vão para todos,
+    // inclusive clientes com limite de taxa.
+    ws.textAll(buf);
+}
@@ -1,13 +1,29 @@
 #pragma once
 #include "ads_driver.h"
+#include "alarm.h"
 
 /**
- * Inicializa WiFi, servidor HTTP/WS e endpoints.
+ * Inicializa servidor HTTP/WS e endpoints e dispara a conexão WiFi e o NTP
+ * sem esperar por eles.
  */
 void NET_init();
 
 /**
- * Envia uma amostra via WebSocket.
+ * Acompanha a conexão WiFi (log e novas tentativas). Chamar do loop().
+ */
+void NET_poll();
+
+/**
+ * Publica uma amostra via WebSocket. Cada cliente recebe no formato e na taxa
+ * que negociou (JSON ou quadros binários em lote); clientes com a fila de
+ * envio cheia são pulados e recebem as amostras acumuladas depois.
  * @param s Amostra a ser enviada.
  */
-void NET_tick(const CellSample &s);
\ No newline at end of file
+void NET_tick(const CellSample &s);
+
+/**
+ * Envia uma mudança de estado de alarme a todos os clientes do WebSocket,
+ * em JSON ({"type":"alarm",...}), qualquer que seja o formato negociado.
+ * @param e Evento (timestamp como gravado; a correção é aplicada aqui).
+ */
+void NET_sendAlarm(const AlarmEvent &e);
\ No newline at end of file
@@ -0,0 +1,93 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Curvas de tensão de circuito aberto (OCV) x estado de carga por química.
+ *
+ * Cada química declara alguns pontos medidos (mV crescente). A tabela usada
+ * em tempo de execução é gerada em tempo de compilação: os pontos são
+ * interpolados numa grade uniforme de OCV_STEP_MV, então a consulta é um
+ * índice direto mais uma interpolação inteira, sem busca e sem float.
+ *
+ * Para trocar a química do pack, altere OcvActive no fim do arquivo.
+ */
+
+struct OcvPoint {
+    uint16_t mv;    // Tensão em repouso (mV)
+    uint8_t  soc;   // Estado de carga (%)
+};
+
+// LiPo / Li-ion de alta tensão (4,20 V cheio), curva típica em repouso.
+struct OcvLiPo {
+    static constexpr OcvPoint points[] = {
+        {3270, 0},  {3610, 5},  {3690, 10}, {3710, 15}, {3730, 20}, {3750, 25},
+        {3770, 30}, {3790, 35}, {3800, 40}, {3820, 45}, {3840, 50}, {3850, 55},
+        {3870, 60}, {3910, 65}, {3950, 70}, {3980, 75}, {4020, 80}, {4080, 85},
+        {4110, 90}, {4150, 95}, {4200, 100},
+    };
+};
+
+// Li-ion NMC (18650 comum).
+struct OcvLiIon {
+    static constexpr OcvPoint points[] = {
+        {3000, 0},  {3450, 10}, {3550, 20}, {3620, 30}, {3680, 40}, {3740, 50},
+        {3800, 60}, {3880, 70}, {3950, 80}, {4050, 90}, {4200, 100},
+    };
+};
+
+// LiFePO4: patamar plano entre 20% e 90%, SoC pela tensão é só indicativo.
+struct OcvLiFePO4 {
+    static constexpr OcvPoint points[] = {
+        {2500, 0},  {3000, 10}, {3200, 20}, {3220, 30}, {3250, 40}, {3260, 50},
+        {3270, 60}, {3300, 70}, {3320, 80}, {3350, 90}, {3400, 100},
+    };
+};
+
+static constexpr uint16_t OCV_STEP_SHIFT = 2;                  // Grade de 4 mV
+static constexpr uint16_t OCV_STEP_MV = 1 << OCV_STEP_SHIFT;
+
+/**
+ * Tabela uniforme gerada a partir dos pontos de uma química. Os valores são
+ * SoC em Q8 (% x 256) para a interpolação entre nós não perder resolução.
+ */
+template <typename Chem>
+struct OcvTable {
+    static constexpr size_t NPOINTS = sizeof(Chem::points) / sizeof(Chem::points[0]);
+    static constexpr uint16_t MIN_MV = Chem::points[0].mv;
+    static constexpr uint16_t MAX_MV = Chem::points[NPOINTS - 1].mv;
+    static constexpr size_t SIZE = (MAX_MV - MIN_MV + OCV_STEP_MV - 1) / OCV_STEP_MV + 1;
+
+    uint16_t socQ8[SIZE];
+
+    constexpr OcvTable() : socQ8{} {
+        size_t seg = 0;
+        for (size_t i = 0; i < SIZE; i++) {
+            uint32_t mv = MIN_MV + i * OCV_STEP_MV;
+            if (mv > MAX_MV) mv = MAX_MV;
+            while (seg + 2 < NPOINTS && mv > Chem::points[seg + 1].mv) seg++;
+            const OcvPoint a = Chem::points[seg], b = Chem::points[seg + 1];
+            uint32_t num = (uint32_t)(b.soc - a.soc) * 256 * (mv - a.mv);
+            uint32_t den = b.mv - a.mv;
+            socQ8[i] = (uint16_t)(a.soc * 256 + (num + den / 2) / den);
+        }
+    }
+
+    /**
+     * Consulta o SoC de uma tensão (satura nos extremos da curva).
+     * @param mv Tensão da célula em mV.
+     * @return SoC em % (0–100), arredondado.
+     */
+    constexpr uint8_t soc(uint16_t mv) const {
+        if (mv <= MIN_MV) return socQ8[0] >> 8;
+        if (mv >= MAX_MV) return (socQ8[SIZE - 1] + 128) >> 8;
+        uint32_t off = mv - MIN_MV;
+        size_t i = off >> OCV_STEP_SHIFT;
+        uint32_t frac = off & (OCV_STEP_MV - 1);
+        int32_t q8 = socQ8[i] + (((int32_t)socQ8[i + 1] - socQ8[i]) * (int32_t)frac >> OCV_STEP_SHIFT);
+        return (uint8_t)((q8 + 128) >> 8);
+    }
+};
+
+// Química do pack monitorado.
+using OcvActive = OcvLiPo;
@@ -0,0 +1,66 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include "ocv_table.h"
+
+/**
+ * Topologia do pack em tempo de compilação.
+ *
+ * PACK_CELL_COUNT células em série, cada tap (tensão absoluta do topo da
+ * célula i) ligado ao canal i % 4 do ADS1115 i / 4. Com mais de 4 células
+ * entram mais ADS1115 no mesmo barramento (endereços 0x48..0x4B, pino ADDR
+ * em GND/VDD/SDA/SCL), e o driver converte o mesmo canal em todos os chips
+ * ao mesmo tempo: a aquisição leva o tempo de 4 canais, não de N.
+ *
+ * Para outro pack, compile com -DPACK_CELL_COUNT=N. Tudo o que depende do
+ * número de células (amostra, log, agregados, quadros do WebSocket, config)
+ * é dimensionado a partir daqui. Não depende do Arduino.
+ */
+
+#ifndef PACK_CELL_COUNT
+#define PACK_CELL_COUNT 4
+#endif
+
+static constexpr uint8_t PACK_CELLS = PACK_CELL_COUNT;
+static constexpr uint8_t PACK_SERIES = PACK_CELLS + 1;   // Células + total (agregados, compressão)
+static constexpr uint8_t PACK_CH_PER_ADC = 4;
+static constexpr uint8_t PACK_ADCS = (PACK_CELLS + PACK_CH_PER_ADC - 1) / PACK_CH_PER_ADC;
+// Canais convertidos em sequência em cada chip (o do mais carregado).
+static constexpr uint8_t PACK_ROUND_CHANNELS = PACK_CELLS < PACK_CH_PER_ADC ? PACK_CELLS : PACK_CH_PER_ADC;
+static constexpr uint8_t PACK_ADC_ADDR[4] = {0x48, 0x49, 0x4A, 0x4B};
+
+// Tensão máxima de uma célula (topo da curva OCV da química ativa).
+static constexpr uint16_t PACK_CELL_MAX_MV = OcvTable<OcvActive>::MAX_MV;
+
+static_assert(PACK_CELLS >= 1, "PACK_CELL_COUNT deve ser pelo menos 1");
+static_assert(PACK_ADCS <= sizeof(PACK_ADC_ADDR), "No máximo 4 ADS1115 (16 células) no barramento");
+static_assert((uint32_t)PACK_CELLS * PACK_CELL_MAX_MV <= UINT16_MAX,
+              "Tensão total do pack não cabe em 16 bits (mV) com esta química");
+
+// Indicadores de qualidade de uma amostra (CellSample::flags, gravados também no log)
+static constexpr uint8_t SAMPLE_FLAG_RANGE   = 0x01;   // Alguma tensão absoluta fora da faixa esperada
+static constexpr uint8_t SAMPLE_FLAG_PARTIAL = 0x02;   // Algum canal com oversampling incompleto
+static constexpr uint8_t SAMPLE_FLAG_RATE_SHIFT = 2;   // Bits 2–3: nível de taxa em que a amostra foi colhida (SchedLevel)
+static constexpr uint8_t SAMPLE_FLAG_RATE_MASK  = 0x0C;
+static constexpr uint8_t SAMPLE_FLAG_PROVISIONAL = 0x10;   // Timestamp provisório, anterior à sincronização do relógio (timebase.h)
+static constexpr uint8_t SAMPLE_FLAG_REPLAY = 0x20;        // Amostra reproduzida de uma captura (replay.h), não do ADC
+
+/** ADS1115 que mede o tap de uma célula. */
+constexpr uint8_t PACK_adcOf(uint8_t cell) { return cell / PACK_CH_PER_ADC; }
+
+/** Canal do ADS1115 que mede o tap de uma célula. */
+constexpr uint8_t PACK_chanOf(uint8_t cell) { return cell % PACK_CH_PER_ADC; }
+
+/**
+ * Fator de divisão nominal do tap de uma célula (tensão do tap / tensão no
+ * pino do ADC). Os 4 primeiros são os medidos na placa original; os demais
+ * assumem divisores dimensionados para (i + 1) células.
+ */
+constexpr float PACK_defaultKDiv(uint8_t cell) {
+    return cell == 0 ? 1.043f : cell == 1 ? 2.114f : cell == 2 ? 3.022f : cell == 3 ? 4.039f
+                     : (float)(cell + 1);
+}
+
+/** Faixa plausível da tensão absoluta no tap de uma célula (mV), para SAMPLE_FLAG_RANGE. */
+constexpr uint16_t PACK_tapMinMv(uint8_t cell) { return (uint16_t)(OcvTable<OcvActive>::MIN_MV * (cell + 1u)); }
+constexpr uint16_t PACK_tapMaxMv(uint8_t cell) { return (uint16_t)(PACK_CELL_MAX_MV * (cell + 1u)); }
@@ -0,0 +1,248 @@
+#include "query.h"
+#include "storage.h"
+#include "rollup.h"
+#include "timebase.h"
+#include <new>
+
+// Séries de cada balde: células + total.
+static constexpr uint8_t SERIES = ROLL_SERIES;
+// Maior trecho pendente: linha JSON com o tempo, a contagem e mín/máx/média
+// de cada série (até ",65535,65535,65535" por série), ou o cabeçalho.
+static constexpr size_t OUT_SIZE = SERIES * 18 + 160;
+static constexpr int8_t SRC_RAW = -1;
+static const char *const SRC_NAMES[ROLL_TIERS] = {"1s", "1m", "1h"};
+
+struct Bucket {
+    uint16_t min[SERIES];
+    uint16_t max[SERIES];
+    uint64_t sum[SERIES];
+    uint32_t count;
+};
+
+enum class QryState : uint8_t { Header, Rows, Footer, Done };
+
+struct HistoryQuery {
+    int8_t     src = SRC_RAW;      // Nível de agregados usado, ou SRC_RAW para o log
+    uint64_t   tierT = 0;          // Próximo intervalo do nível a ler (s Unix)
+    LogCursor *cur = nullptr;
+    uint64_t   fromMs = 0;
+    uint64_t   toMs = 0;
+    uint64_t   bucketMs = 1;
+    bool       binary = false;
+    QryState   state = QryState::Header;
+    uint32_t   rows = 0;           // Baldes emitidos
+    uint32_t   bucketIdx = 0;      // Índice do balde em acumulação
+    Bucket     b{};
+    bool       haveItem = false;   // 'next' já lido e ainda não acumulado
+    uint64_t   nextMs = 0;
+    RollBucket next{};
+    uint8_t    out[OUT_SIZE];      // Trecho pendente (uma linha/registro por vez)
+    uint16_t   outLen = 0;
+    uint16_t   outPos = 0;
+};
+
+static void resetBucket(Bucket &b) {
+    for (uint8_t i = 0; i < SERIES; i++) {
+        b.min[i] = UINT16_MAX;
+        b.max[i] = 0;
+        b.sum[i] = 0;
+    }
+    b.count = 0;
+}
+
+static void addItem(Bucket &b, const RollBucket &it) {
+    for (uint8_t i = 0; i < SERIES; i++) {
+        if (it.min[i] < b.min[i]) b.min[i] = it.min[i];
+        if (it.max[i] > b.max[i]) b.max[i] = it.max[i];
+        b.sum[i] += (uint64_t)it.avg[i] * it.n;
+    }
+    b.count += it.n;
+}
+
+// Lê o próximo item da fonte: um registro do log (n = 1) ou um agregado do
+// nível escolhido. Retorna false após o fim do intervalo.
+static bool nextItem(HistoryQuery *q) {
+    if (q->src != SRC_RAW) {
+        const RollTier tier = (RollTier)q->src;
+        const uint32_t res = ROLL_resolution(tier);
+        while (q->tierT * 1000 <= q->toMs) {
+            const uint32_t t = (uint32_t)q->tierT;
+            q->tierT += res;
+            if (ROLL_get(tier, t, q->next)) {
+                q->nextMs = (uint64_t)t * 1000;
+                return true;
+            }
+        }
+        return false;
+    }
+    LogRecord r;
+    if (!FS_cursorNext(q->cur, r) || r.epochMs > q->toMs) return false;
+    q->nextMs = r.epochMs;
+    q->next.n = 1;
+    for (uint8_t i = 0; i < SERIES; i++) {
+        uint16_t v = i < PACK_CELLS ? r.mv[i] : r.total;
+        q->next.min[i] = q->next.max[i] = q->next.avg[i] = v;
+    }
+    return true;
+}
+
+// Serializa um balde em q->out.
+static void emitBucket(HistoryQuery *q) {
+    const Bucket &b = q->b;
+    uint64_t t = q->fromMs + (uint64_t)q->bucketIdx * q->bucketMs;
+    if (q->binary) {
+        // Registro binário (LE): offset do balde em ms (u32, cabe porque o
+        // intervalo é limitado a QRY_MAX_SPAN_MS), contagem (u16), e para cada
+        // série mín/máx/média (u16).
+        uint32_t off = (uint32_t)(t - q->fromMs);
+        uint16_t cnt = b.count > UINT16_MAX ? UINT16_MAX : (uint16_t)b.count;
+        uint8_t *p = q->out;
+        memcpy(p, &off, 4); p += 4;
+        memcpy(p, &cnt, 2); p += 2;
+        for (uint8_t i = 0; i < SERIES; i++) {
+            uint16_t avg = (uint16_t)(b.sum[i] / b.count);
+            memcpy(p, &b.min[i], 2); p += 2;
+            memcpy(p, &b.max[i], 2); p += 2;
+            memcpy(p, &avg, 2); p += 2;
+        }
+        q->outLen = p - q->out;
+    } else {
+        int n = snprintf((char *)q->out, sizeof(q->out), "%s[%llu,%lu",
+            q->rows ? "," : "", (unsigned long long)t, (unsigned long)b.count);
+        for (uint8_t i = 0; i < SERIES; i++) {
+            n += snprintf((char *)q->out + n, sizeof(q->out) - n, ",%u,%u,%u",
+                b.min[i], b.max[i], (unsigned)(b.sum[i] / b.count));
+        }
+        q->outLen = (uint16_t)n;
+    }
+    q->outPos = 0;
+    q->rows++;
+}
+
+// Avança até ter um trecho pendente em q->out. Retorna false no fim.
+static bool produce(HistoryQuery *q) {
+    switch (q->state) {
+    case QryState::Header:
+        q->state = QryState::Rows;
+        if (q->binary) {
+            // Cabeçalho binário: fromMs (u64), bucketMs (u32), séries (u8).
+            uint32_t bms = (uint32_t)q->bucketMs;
+            memcpy(q->out, &q->fromMs, 8);
+            memcpy(q->out + 8, &bms, 4);
+            q->out[12] = SERIES;
+            q->outLen = 13;
+        } else {
+            int n = snprintf((char *)q->out, sizeof(q->out),
+                "{\"from\":%llu,\"to\":%llu,\"bucket\":%llu,\"src\":\"%s\",\"cols\":[\"t\",\"n\"",
+                (unsigned long long)q->fromMs, (unsigned long long)q->toMs,
+                (unsigned long long)q->bucketMs, q->src == SRC_RAW ? "raw" : SRC_NAMES[q->src]);
+            for (uint8_t i = 0; i < PACK_CELLS; i++) {
+                n += snprintf((char *)q->out + n, sizeof(q->out) - n, ",\"c%u\"", (unsigned)(i + 1));
+            }
+            n += snprintf((char *)q->out + n, sizeof(q->out) - n, ",\"total\"],\"rows\":[");
+            q->outLen = (uint16_t)n;
+        }
+        q->outPos = 0;
+        return true;
+
+    case QryState::Rows:
+        for (;;) {
+            if (!q->haveItem) {
+                if (!nextItem(q)) {
+                    // Fim do intervalo: emite o balde parcial, se houver.
+                    q->state = QryState::Footer;
+                    if (q->b.count) { emitBucket(q); resetBucket(q->b); return true; }
+                    return produce(q);
+                }
+                q->haveItem = true;
+            }
+            // Um agregado pode começar um pouco antes de 'from' (alinhamento do nível).
+            uint64_t rel = q->nextMs > q->fromMs ? q->nextMs - q->fromMs : 0;
+            uint32_t idx = (uint32_t)(rel / q->bucketMs);
+            if (idx != q->bucketIdx && q->b.count) {
+                // Registro de outro balde: fecha o atual e mantém o registro para depois.
+                emitBucket(q);
+                resetBucket(q->b);
+                q->bucketIdx = idx;
+                return true;
+            }
+            q->bucketIdx = idx;
+            addItem(q->b, q->next);
+            q->haveItem = false;
+        }
+
+    case QryState::Footer:
+        q->state = QryState::Done;
+        if (q->binary) return false;
+        q->outLen = (uint16_t)snprintf((char *)q->out, sizeof(q->out), "]}");
+        q->outPos = 0;
+        return true;
+
+    case QryState::Done:
+    default:
+        return false;
+    }
+}
+
+// Escolhe o nível de agregados mais grosso cuja resolução cabe no balde pedido
+// e cuja janela ainda cobre 'from'. Sem nível adequado, lê o log bruto.
+static int8_t pickSource(uint64_t fromMs, uint64_t bucketMs) {
+    const uint32_t nowSec = (uint32_t)(TIME_nowMs() / 1000);
+    for (int8_t k = ROLL_TIERS - 1; k >= 0; k--) {
+        const uint32_t res = ROLL_resolution((RollTier)k);
+        const uint32_t span = res * (ROLL_capacity((RollTier)k) - 1);
+        const uint32_t newest = nowSec - nowSec % res;
+        const uint32_t oldest = newest > span ? newest - span : 0;
+        if (bucketMs >= (uint64_t)res * 1000 && fromMs / 1000 >= oldest) return k;
+    }
+    return SRC_RAW;
+}
+
+HistoryQuery *QRY_open(uint64_t fromMs, uint64_t toMs, uint16_t points, bool binary) {
+    // Não há dados no futuro: um 'to' adiante só faria percorrer slots vazios
+    // (e, no nível de agregados, estourar os segundos de 32 bits).
+    const uint64_t now = TIME_nowMs();
+    if (toMs > now) toMs = now;
+    if (toMs < fromMs || toMs - fromMs > QRY_MAX_SPAN_MS) return nullptr;
+    if (points == 0) points = 1;
+    if (points > QRY_MAX_POINTS) points = QRY_MAX_POINTS;
+
+    HistoryQuery *q = new (std::nothrow) HistoryQuery();
+    if (!q) return nullptr;
+    q->fromMs = fromMs;
+    q->toMs = toMs;
+    q->bucketMs = (toMs - fromMs) / points + 1;
+    q->src = pickSource(fromMs, q->bucketMs);
+    if (q->src == SRC_RAW) {
+        q->cur = FS_cursorOpen(fromMs);
+        if (!q->cur) {
+            delete q;
+            return nullptr;
+        }
+    } else {
+        const uint32_t res = ROLL_resolution((RollTier)q->src);
+        const uint32_t fromSec = (uint32_t)(fromMs / 1000);
+        q->tierT = fromSec - fromSec % res;
+    }
+    q->binary = binary;
+    resetBucket(q->b);
+    return q;
+}
+
+size_t QRY_read(HistoryQuery *q, uint8_t *buf, size_t maxLen) {
+    size_t n = 0;
+    while (n < maxLen) {
+        if (q->outPos == q->outLen && !produce(q)) break;
+        size_t chunk = min((size_t)(q->outLen - q->outPos), maxLen - n);
+        memcpy(buf + n, q->out + q->outPos, chunk);
+        q->outPos += chunk;
+        n += chunk;
+    }
+    return n;
+}
+
+void QRY_close(HistoryQuery *q) {
+    if (!q) return;
+    FS_cursorClose(q->cur);
+    delete q;
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include <Arduino.h>
+
+/**
+ * Estado de uma consulta de histórico em andamento (uma por requisição).
+ */
+struct HistoryQuery;
+
+/**
+ * Abre uma consulta de histórico reduzido: o intervalo [fromMs, toMs] é
+ * dividido em 'points' baldes e, para cada balde com dados, são produzidos
+ * mín/máx/média de cada célula e do total. Quando o balde é maior que a
+ * resolução de um nível de agregados (rollup.h) que cobre o intervalo, os
+ * agregados são usados; senão só o trecho do log no intervalo é lido
+ * (cursor posicionado pelo índice de tempo).
+ * @param fromMs Início do intervalo (ms Unix).
+ * @param toMs Fim do intervalo (ms Unix, inclusivo); limitado ao horário atual.
+ * @param points Número máximo de baldes (limitado a QRY_MAX_POINTS).
+ * @param binary true para saída binária compacta, false para JSON.
+ * @return Consulta aberta, ou nullptr se o intervalo é inválido (fim antes do
+ *         início, depois de limitado ao horário atual, ou mais longo que
+ *         QRY_MAX_SPAN_MS) ou faltou memória.
+ */
+HistoryQuery *QRY_open(uint64_t fromMs, uint64_t toMs, uint16_t points, bool binary);
+
+/**
+ * Produz o próximo trecho da resposta.
+ * @param q Consulta aberta por QRY_open().
+ * @param buf Buffer de saída.
+ * @param maxLen Tamanho do buffer.
+ * @return Bytes escritos em 'buf'; 0 indica o fim da resposta.
+ */
+size_t QRY_read(HistoryQuery *q, uint8_t *buf, size_t maxLen);
+
+/**
+ * Libera uma consulta.
+ * @param q Consulta aberta por QRY_open() (pode ser nullptr).
+ */
+void QRY_close(HistoryQuery *q);
+
+static constexpr uint16_t QRY_MAX_POINTS = 2000;
+// Maior intervalo de uma consulta (49 dias, mais que o log guarda): o
+// formato binário leva o balde e os offsets em ms com 32 bits.
+static constexpr uint64_t QRY_MAX_SPAN_MS = 49ULL * 86400000;
@@ -0,0 +1,75 @@
+#include "recent.h"
+#include <new>
+
+// Anel das últimas amostras na RAM. Escrito pelo loop() e lido pelos handlers
+// do WebSocket (tarefa AsyncTCP) para o histórico inicial do dashboard.
+static CellSample *ring = nullptr;
+static uint16_t depth = 0;
+static uint32_t nextSeq = 0;
+static SemaphoreHandle_t recMutex = nullptr;
+
+bool REC_init(uint16_t d) {
+    if (d == 0) d = 1;
+    if (d > REC_MAX_DEPTH) d = REC_MAX_DEPTH;
+    if (!recMutex) recMutex = xSemaphoreCreateMutex();
+    delete[] ring;
+    ring = new (std::nothrow) CellSample[d];
+    depth = ring ? d : 0;
+    nextSeq = 0;
+    if (!ring) {
+        Serial.printf("[REC] Sem memória para %u amostras\n", (unsigned)d);
+        return false;
+    }
+    Serial.printf("[REC] Anel de %u amostras (%u bytes de RAM)\n",
+        (unsigned)depth, (unsigned)(depth * sizeof(CellSample)));
+    return true;
+}
+
+void REC_add(const CellSample &s) {
+    if (!ring) return;
+    xSemaphoreTake(recMutex, portMAX_DELAY);
+    ring[nextSeq % depth] = s;
+    nextSeq++;
+    xSemaphoreGive(recMutex);
+}
+
+uint32_t REC_seq() {
+    return nextSeq;
+}
+
+size_t REC_read(uint32_t &seq, CellSample *out, size_t max) {
+    if (!ring) return 0;
+    xSemaphoreTake(recMutex, portMAX_DELAY);
+    uint32_t oldest = nextSeq > depth ? nextSeq - depth : 0;
+    if (seq < oldest || seq > nextSeq) seq = oldest;
+    size_t n = 0;
+    while (n < max && seq != nextSeq) {
+        out[n++] = ring[seq % depth];
+        seq++;
+    }
+    xSemaphoreGive(recMutex);
+    return n;
+}
+
+void REC_fixup(const TimeFix &fix) {
+    if (!ring) return;
+    xSemaphoreTake(recMutex, portMAX_DELAY);
+    uint16_t n = nextSeq < depth ? nextSeq : depth;
+    for (uint16_t i = 0; i < n; i++) {
+        CellSample &s = ring[i];
+        if ((s.flags & SAMPLE_FLAG_PROVISIONAL) && s.epochMs >= fix.fromMs && s.epochMs <= fix.toMs) {
+            s.epochMs += fix.correctionMs;
+        }
+    }
+    xSemaphoreGive(recMutex);
+}
+
+void REC_getStats(RecStats &st) {
+    if (!recMutex) { st = {}; return; }
+    xSemaphoreTake(recMutex, portMAX_DELAY);
+    st.depth = depth;
+    st.count = nextSeq < depth ? nextSeq : depth;
+    st.bytes = depth * sizeof(CellSample);
+    st.seq = nextSeq;
+    xSemaphoreGive(recMutex);
+}
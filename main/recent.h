@@ -0,0 +1,58 @@
+#pragma once
+#include "ads_driver.h"
+#include "timebase.h"
+
+// Profundidade padrão do anel: 5 min a 2 Hz (~14 KB).
+static constexpr uint16_t REC_DEFAULT_DEPTH = 600;
+static constexpr uint16_t REC_MAX_DEPTH = 4096;
+
+/**
+ * Ocupação do anel de amostras recentes.
+ */
+struct RecStats {
+    uint16_t depth;   // Capacidade em amostras
+    uint16_t count;   // Amostras guardadas
+    uint32_t bytes;   // RAM reservada
+    uint32_t seq;     // Sequência da próxima amostra
+};
+
+/**
+ * Reserva o anel de amostras recentes na RAM.
+ * @param depth Capacidade em amostras (limitada a REC_MAX_DEPTH).
+ * @return true se bem sucedido, false se faltou memória.
+ */
+bool REC_init(uint16_t depth);
+
+/**
+ * Guarda uma amostra, sobrescrevendo a mais antiga quando cheio.
+ * @param s Amostra.
+ */
+void REC_add(const CellSample &s);
+
+/**
+ * Sequência da próxima amostra (total de amostras já guardadas).
+ */
+uint32_t REC_seq();
+
+/**
+ * Copia amostras a partir de uma sequência. Se 'seq' já saiu do anel, a cópia
+ * começa na mais antiga disponível.
+ * @param seq Primeira sequência desejada; recebe a sequência após a última copiada.
+ * @param out Destino.
+ * @param max Capacidade de 'out'.
+ * @return Amostras copiadas.
+ */
+size_t REC_read(uint32_t &seq, CellSample *out, size_t max);
+
+/**
+ * Corrige na RAM os timestamps provisórios cobertos por uma correção de
+ * relógio (a flash é corrigida na leitura, ver TIME_toWall()).
+ * @param fix Correção do boot atual.
+ */
+void REC_fixup(const TimeFix &fix);
+
+/**
+ * Lê a ocupação do anel.
+ * @param st Estrutura a preencher.
+ */
+void REC_getStats(RecStats &st);
@@ -0,0 +1,124 @@
+#include "replay.h"
+#include <SPIFFS.h>
+
+// Lê um inteiro sem sinal e avança até depois da vírgula seguinte.
+static bool field(const char *&p, uint32_t &v) {
+    if (*p < '0' || *p > '9') return false;
+    v = 0;
+    while (*p >= '0' && *p <= '9') v = v * 10 + (*p++ - '0');
+    if (*p == ',') p++;
+    return true;
+}
+
+// Horário da linha em ms: "HH:MM:SS" (formato antigo) ou
+// "AAAA-MM-DD HH:MM:SS.mmm" (download). Só a hora do dia importa: a data
+// entra pela virada de dia detectada em readRow().
+static bool parseTime(const char *&p, uint64_t &ms, bool &hasMs) {
+    const char *sp = strchr(p, ' ');
+    const char *comma = strchr(p, ',');
+    if (!comma) return false;
+    if (sp && sp < comma) p = sp + 1;   // Pula a data
+    uint32_t h, m, s, frac = 0;
+    if (!field(p, h) || *p++ != ':' || !field(p, m) || *p++ != ':' || !field(p, s)) return false;
+    hasMs = *p == '.';
+    if (hasMs) {
+        p++;
+        if (!field(p, frac)) return false;
+    } else if (*p == ',') {
+        p++;
+    }
+    ms = ((uint64_t)h * 3600 + m * 60 + s) * 1000 + frac;
+    return true;
+}
+
+bool ReplaySource::open(const ReplayConfig &cfg, uint32_t nowMs) {
+    close();
+    file_ = SPIFFS.open(cfg.path, FILE_READ);
+    if (!file_) return false;
+    speed_ = cfg.speed;
+    loopsLeft_ = cfg.loops ? cfg.loops - 1 : 0;
+    startMs_ = nowMs;
+    first_ = true;
+    passStart_ = true;
+    passOffset_ = prevRawMs_ = 0;
+    rows_ = bad_ = 0;
+    file_.readStringUntil('\n');   // Cabeçalho
+    hasRow_ = readRow();
+    return true;
+}
+
+void ReplaySource::close() {
+    if (file_) file_.close();
+    hasRow_ = false;
+}
+
+bool ReplaySource::readRow() {
+    char line[48 + 16 * PACK_CELLS];
+    for (;;) {
+        if (!file_.available()) {
+            if (!loopsLeft_) return false;
+            // Nova passada: o relógio da captura continua de onde parou.
+            loopsLeft_--;
+            passStart_ = true;
+            file_.seek(0);
+            file_.readStringUntil('\n');
+            continue;
+        }
+        size_t n = file_.readBytesUntil('\n', line, sizeof(line) - 1);
+        line[n] = '\0';
+        if (n == 0 || line[0] == '\r') continue;
+
+        const char *p = line;
+        uint64_t t;
+        bool hasMs;
+        uint32_t v[2 * PACK_CELLS + 1];
+        bool ok = parseTime(p, t, hasMs);
+        for (uint8_t i = 0; i < 2 * PACK_CELLS + 1 && ok; i++) ok = field(p, v[i]);
+        if (!ok) {
+            bad_++;
+            continue;
+        }
+
+        // Cada passada continua o relógio da anterior; dentro dela, a hora
+        // do dia vira o relógio da captura (com a virada de dia).
+        if (passStart_) {
+            passOffset_ = first_ ? 0 : lastMs_ + RPL_DUP_STEP_MS - t;
+            passStart_ = false;
+        } else if (t + 12 * 3600000ULL < prevRawMs_) {
+            passOffset_ += 24 * 3600000ULL;
+        }
+        prevRawMs_ = t;
+        uint64_t abs = passOffset_ + t;
+        if (!first_) {
+            // Linhas repetidas no mesmo segundo (CSV sem ms) são espaçadas.
+            if (!hasMs && abs <= lastMs_) abs = lastMs_ + RPL_DUP_STEP_MS;
+            if (abs < lastMs_) abs = lastMs_;
+        }
+        if (first_) {
+            firstMs_ = abs;
+            first_ = false;
+        }
+        lastMs_ = abs;
+
+        for (uint8_t i = 0; i < PACK_CELLS; i++) {
+            row_.mv[i] = (uint16_t)v[2 * i];
+            row_.soc[i] = (uint8_t)v[2 * i + 1];
+        }
+        row_.total = (uint16_t)v[2 * PACK_CELLS];
+        row_.flags = 0;
+        row_.epochMs = abs - firstMs_;
+        rows_++;
+        return true;
+    }
+}
+
+int8_t ReplaySource::next(uint32_t nowMs, CellSample &out) {
+    if (!hasRow_) return -1;
+    if (speed_) {
+        uint64_t due = (lastMs_ - firstMs_) / speed_;
+        if ((uint64_t)(nowMs - startMs_) < due) return 0;
+    }
+    out = row_;
+    hasRow_ = readRow();
+    return 1;
+}
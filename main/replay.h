@@ -0,0 +1,86 @@
+#pragma once
+#include <Arduino.h>
+#include <FS.h>
+#include "ads_driver.h"
+
+/**
+ * Fonte de reprodução: lê uma captura em CSV (formato do download ou o
+ * formato antigo "hora,c1_mv,c1_soc,...,total_mv") e entrega as amostras no
+ * ritmo gravado, N vezes mais rápido ou sem espera. A tarefa de aquisição usa
+ * esta fonte no lugar do ADC, então o resto do pipeline (fila, log,
+ * agregados, WebSocket) roda como com o hardware.
+ */
+
+static constexpr uint32_t RPL_DUP_STEP_MS = 500;   // Passo entre linhas repetidas no mesmo segundo (CSV sem ms)
+
+enum ReplayState : uint8_t { RPL_IDLE, RPL_RUNNING, RPL_DONE, RPL_ERROR };
+
+/**
+ * Parâmetros de uma reprodução.
+ */
+struct ReplayConfig {
+    char     path[32];   // CSV na SPIFFS
+    uint16_t speed;      // 1 = tempo real, N = N vezes mais rápido, 0 = o mais rápido que a fila aceitar
+    uint8_t  loops;      // Passadas pelo arquivo (mín. 1)
+};
+
+/**
+ * Resultado/andamento de uma reprodução.
+ */
+struct ReplayStats {
+    ReplayState state;
+    uint16_t speed;
+    uint32_t rows;        // Linhas válidas lidas
+    uint32_t badRows;     // Linhas ignoradas (formato inválido)
+    uint32_t fed;         // Amostras aceitas pela fila
+    uint32_t dropped;     // Amostras descartadas por fila cheia
+    uint32_t elapsedMs;   // Duração até agora (ou total, se terminou)
+    uint32_t recordedMs;  // Tempo de captura coberto pelas linhas lidas
+};
+
+/**
+ * Leitor do CSV com o relógio da captura.
+ */
+class ReplaySource {
+public:
+    /**
+     * Abre o arquivo e posiciona após o cabeçalho.
+     * @param cfg Parâmetros.
+     * @param nowMs Instante de início (millis()).
+     * @return false se o arquivo não abre.
+     */
+    bool open(const ReplayConfig &cfg, uint32_t nowMs);
+
+    /**
+     * Entrega a próxima amostra se ela já venceu.
+     * @param nowMs Instante atual (millis()).
+     * @param out Recebe a amostra; epochMs é o relógio da captura (ms desde a
+     *            primeira linha) e flags fica 0: o chamador põe o timestamp real.
+     * @return 1 se entregou, 0 se a próxima ainda não venceu, -1 no fim.
+     */
+    int8_t next(uint32_t nowMs, CellSample &out);
+
+    void close();
+    bool active() const { return (bool)file_; }
+    uint32_t rows() const { return rows_; }
+    uint32_t badRows() const { return bad_; }
+    uint32_t recordedMs() const { return first_ ? 0 : (uint32_t)(lastMs_ - firstMs_); }
+
+private:
+    bool readRow();
+
+    File      file_;
+    uint16_t  speed_ = 1;
+    uint8_t   loopsLeft_ = 0;
+    uint32_t  startMs_ = 0;
+    bool      hasRow_ = false;    // 'row_' contém a próxima amostra
+    bool      first_ = true;
+    uint64_t  firstMs_ = 0;       // Relógio da captura na primeira linha
+    uint64_t  lastMs_ = 0;        // Relógio da captura na linha em 'row_'
+    bool      passStart_ = true;  // Próxima linha é a primeira de uma passada
+    uint64_t  passOffset_ = 0;    // Relógio da captura - hora do dia, na passada atual
+    uint64_t  prevRawMs_ = 0;     // Hora do dia da última linha lida
+    CellSample row_;
+    uint32_t  rows_ = 0;
+    uint32_t  bad_ = 0;
+};
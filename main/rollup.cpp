@@ -0,0 +1,162 @@
+#include "rollup.h"
+#include <SPIFFS.h>
+
+// Cada nível é um anel endereçado pelo tempo: o intervalo que começa em t fica
+// no slot (t / res) % cap. Não há ponteiro de cabeça para persistir e um slot
+// só é válido se o tSec gravado nele confere.
+struct Tier {
+    uint32_t    resSec;
+    uint16_t    cap;
+    RollBucket *ring;
+    const char *path;                   // nullptr = só RAM
+    // Intervalo aberto
+    uint32_t    curT;
+    uint32_t    n;
+    uint16_t    mn[ROLL_SERIES];
+    uint16_t    mx[ROLL_SERIES];
+    uint64_t    sum[ROLL_SERIES];       // Em 32 bits estoura com ~65 mil amostras em fundo de escala (1 h a 18 Hz)
+};
+
+static RollBucket ring1s[120];    // 2 min
+static RollBucket ring1m[1500];   // 25 h: a consulta das últimas 24 h sai inteira deste nível
+static RollBucket ring1h[336];    // 14 dias
+
+// Um balde de 24 h / 300 pontos (288 s) é menor que 1 h; se o nível de 1 min
+// não cobrisse o dia todo, a consulta cairia no log bruto (query.cpp).
+static_assert((sizeof(ring1m) / sizeof(ring1m[0]) - 1) * 60 >= 86400, "o nível de 1 min deve cobrir 24 h");
+
+static Tier tiers[ROLL_TIERS] = {
+    {1,    120,  ring1s, nullptr},
+    {60,   1500, ring1m, "/roll_m.bin"},
+    {3600, 336,  ring1h, "/roll_h.bin"},
+};
+
+static SemaphoreHandle_t rollMutex = nullptr;
+
+static uint16_t slotOf(const Tier &t, uint32_t tSec) {
+    return (tSec / t.resSec) % t.cap;
+}
+
+static void resetOpen(Tier &t, uint32_t tSec) {
+    t.curT = tSec;
+    t.n = 0;
+    for (uint8_t i = 0; i < ROLL_SERIES; i++) {
+        t.mn[i] = UINT16_MAX;
+        t.mx[i] = 0;
+        t.sum[i] = 0;
+    }
+}
+
+static void openToBucket(const Tier &t, RollBucket &b) {
+    b.tSec = t.curT;
+    b.n = t.n;
+    for (uint8_t i = 0; i < ROLL_SERIES; i++) {
+        b.min[i] = t.mn[i];
+        b.max[i] = t.mx[i];
+        b.avg[i] = (uint16_t)(t.sum[i] / t.n);
+    }
+}
+
+// Grava um intervalo fechado no slot correspondente do arquivo do nível.
+static void persist(const Tier &t, const RollBucket &b) {
+    File f = SPIFFS.open(t.path, "r+");
+    if (!f) return;
+    f.seek((uint32_t)slotOf(t, b.tSec) * sizeof(RollBucket));
+    f.write((const uint8_t *)&b, sizeof(b));
+    f.close();
+}
+
+static void load(Tier &t) {
+    const size_t bytes = (size_t)t.cap * sizeof(RollBucket);
+    memset(t.ring, 0, bytes);
+    File f = SPIFFS.open(t.path, FILE_READ);
+    if (f && f.size() == bytes) {
+        f.read((uint8_t *)t.ring, bytes);
+        f.close();
+        // Descarta slots cujo tempo não corresponde à posição (arquivo antigo/corrompido).
+        for (uint16_t i = 0; i < t.cap; i++) {
+            RollBucket &b = t.ring[i];
+            if (b.n == 0 || b.tSec % t.resSec || slotOf(t, b.tSec) != i) memset(&b, 0, sizeof(b));
+        }
+        return;
+    }
+    if (f) f.close();
+    // Cria o arquivo já com o tamanho final: as gravações seguintes só sobrescrevem.
+    f = SPIFFS.open(t.path, FILE_WRITE);
+    if (!f) {
+        Serial.printf("[ROLL] Erro ao criar %s\n", t.path);
+        return;
+    }
+    f.write((const uint8_t *)t.ring, bytes);
+    f.close();
+}
+
+void ROLL_init() {
+    if (!rollMutex) rollMutex = xSemaphoreCreateMutex();
+    for (Tier &t : tiers) {
+        resetOpen(t, 0);
+        if (t.path) load(t);
+    }
+    size_t ram = sizeof(ring1s) + sizeof(ring1m) + sizeof(ring1h);
+    Serial.printf("[ROLL] Agregados 1s/1min/1h prontos (%u bytes de RAM)\n", (unsigned)ram);
+}
+
+void ROLL_add(const CellSample &s) {
+    const uint32_t tSec = (uint32_t)(s.epochMs / 1000);
+    RollBucket closed[ROLL_TIERS];
+    bool toPersist[ROLL_TIERS] = {false};
+
+    xSemaphoreTake(rollMutex, portMAX_DELAY);
+    for (uint8_t k = 0; k < ROLL_TIERS; k++) {
+        Tier &t = tiers[k];
+        uint32_t bt = tSec - tSec % t.resSec;
+        if (bt != t.curT) {
+            if (t.n) {
+                openToBucket(t, closed[k]);
+                t.ring[slotOf(t, t.curT)] = closed[k];
+                toPersist[k] = t.path != nullptr;
+            }
+            resetOpen(t, bt);
+        }
+        for (uint8_t i = 0; i < ROLL_SERIES; i++) {
+            uint16_t v = i < PACK_CELLS ? s.mv[i] : s.total;
+            if (v < t.mn[i]) t.mn[i] = v;
+            if (v > t.mx[i]) t.mx[i] = v;
+            t.sum[i] += v;
+        }
+        t.n++;
+    }
+    xSemaphoreGive(rollMutex);
+
+    // Grava fora da trava para não segurar as consultas durante o acesso à flash.
+    for (uint8_t k = 0; k < ROLL_TIERS; k++) {
+        if (toPersist[k]) persist(tiers[k], closed[k]);
+    }
+}
+
+bool ROLL_get(RollTier tier, uint32_t tSec, RollBucket &out) {
+    if (tier >= ROLL_TIERS) return false;
+    const Tier &t = tiers[tier];
+    bool ok = false;
+    xSemaphoreTake(rollMutex, portMAX_DELAY);
+    if (t.n && tSec == t.curT) {
+        openToBucket(t, out);
+        ok = true;
+    } else {
+        const RollBucket &b = t.ring[slotOf(t, tSec)];
+        if (b.n && b.tSec == tSec) {
+            out = b;
+            ok = true;
+        }
+    }
+    xSemaphoreGive(rollMutex);
+    return ok;
+}
+
+uint32_t ROLL_resolution(RollTier tier) {
+    return tier < ROLL_TIERS ? tiers[tier].resSec : 0;
+}
+
+uint16_t ROLL_capacity(RollTier tier) {
+    return tier < ROLL_TIERS ? tiers[tier].cap : 0;
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include "ads_driver.h"
+
+/**
+ * Resoluções mantidas pelo agregador.
+ */
+enum RollTier : uint8_t {
+    ROLL_1S,      // 1 s, só na RAM
+    ROLL_1M,      // 1 min, persistido em /roll_m.bin
+    ROLL_1H,      // 1 h, persistido em /roll_h.bin
+    ROLL_TIERS
+};
+
+// Séries agregadas: células + total.
+static constexpr uint8_t ROLL_SERIES = PACK_SERIES;
+
+/**
+ * Agregado de um intervalo (8 + 6 x ROLL_SERIES bytes, arredondado a
+ * múltiplo de 4: 40 com 4 células), também é o formato nos arquivos. Um
+ * arquivo de outro tamanho (outro pack ou versão anterior) é recriado em
+ * ROLL_init().
+ */
+struct RollBucket {
+    uint32_t tSec;                  // Início do intervalo (s Unix), múltiplo da resolução
+    uint32_t n;                     // Amostras agregadas
+    uint16_t min[ROLL_SERIES];      // mV
+    uint16_t max[ROLL_SERIES];      // mV
+    uint16_t avg[ROLL_SERIES];      // mV
+};
+
+/**
+ * Carrega os níveis persistidos e prepara o agregador.
+ */
+void ROLL_init();
+
+/**
+ * Acrescenta uma amostra a todos os níveis (O(1) por amostra). Fecha os
+ * intervalos vencidos e persiste os dos níveis de 1 min e 1 h.
+ * @param s Amostra a agregar.
+ */
+void ROLL_add(const CellSample &s);
+
+/**
+ * Lê o agregado de um intervalo, inclusive o intervalo ainda aberto.
+ * @param tier Nível.
+ * @param tSec Início do intervalo (s Unix, múltiplo da resolução).
+ * @param out Recebe o agregado.
+ * @return true se há dados para o intervalo.
+ */
+bool ROLL_get(RollTier tier, uint32_t tSec, RollBucket &out);
+
+/**
+ * Resolução de um nível em segundos.
+ */
+uint32_t ROLL_resolution(RollTier tier);
+
+/**
+ * Quantos intervalos um nível guarda (cobertura = capacidade x resolução).
+ */
+uint16_t ROLL_capacity(RollTier tier);
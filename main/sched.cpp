@@ -0,0 +1,104 @@
+#include "sched.h"
+
+const char *SCHED_name(SchedLevel l) {
+    switch (l) {
+        case SCHED_SLOW: return "slow";
+        case SCHED_FAST: return "fast";
+        default:         return "normal";
+    }
+}
+
+void SampleScheduler::configure(const SchedConfig &cfg) {
+    cfg_ = cfg;
+    level_ = SCHED_NORMAL;
+    haveRef_ = false;
+    calm_ = false;
+    if (started_) next_ = lastStart_ + periodMs();
+}
+
+void SampleScheduler::setMinPeriod(uint32_t ms) {
+    minPeriod_ = ms;
+}
+
+void SampleScheduler::setFloor(SchedLevel l) {
+    floor_ = l;
+    if (level_ < l) {
+        calm_ = false;
+        setLevel(l, clock_());
+    }
+}
+
+uint32_t SampleScheduler::periodOf(SchedLevel l) const {
+    uint32_t p = cfg_.periodMs[l];
+    return p > minPeriod_ ? p : minPeriod_;
+}
+
+bool SampleScheduler::due() {
+    uint32_t now = clock_();
+    uint32_t period = periodMs();
+    if (!started_) {
+        started_ = true;
+        next_ = now + period;
+    } else {
+        int32_t late = (int32_t)(now - next_);
+        if (late < 0) return false;
+        // Atrasou mais de um período: reancora em 'now' em vez de recuperar.
+        next_ = late < (int32_t)period ? next_ + period : now + period;
+    }
+    lastStart_ = now;
+    return true;
+}
+
+void SampleScheduler::setLevel(SchedLevel l, uint32_t now) {
+    if (l == level_) return;
+    level_ = l;
+    transitions_++;
+    // Ao acelerar, a próxima aquisição já segue o período novo.
+    next_ = lastStart_ + periodMs();
+    if ((int32_t)(next_ - now) < 0) next_ = now;
+}
+
+void SampleScheduler::observe(const uint16_t mv[PACK_CELLS]) {
+    uint32_t now = clock_();
+    if (!cfg_.adaptive) return;
+
+    uint16_t lo = mv[0], hi = mv[0];
+    for (uint8_t i = 1; i < PACK_CELLS; i++) {
+        if (mv[i] < lo) lo = mv[i];
+        if (mv[i] > hi) hi = mv[i];
+    }
+    uint16_t imbalance = hi - lo;
+
+    if (!haveRef_) {
+        for (uint8_t i = 0; i < PACK_CELLS; i++) ref_[i] = mv[i];
+        refMs_ = now;
+        haveRef_ = true;
+    }
+    uint32_t dt = now - refMs_;
+    if (dt >= SCHED_SLOPE_WINDOW_MS) {
+        uint32_t maxDv = 0;
+        for (uint8_t i = 0; i < PACK_CELLS; i++) {
+            uint32_t dv = mv[i] > ref_[i] ? mv[i] - ref_[i] : ref_[i] - mv[i];
+            if (dv > maxDv) maxDv = dv;
+            ref_[i] = mv[i];
+        }
+        uint32_t rate = maxDv * 1000 / dt;
+        dvdt_ = rate > UINT16_MAX ? UINT16_MAX : (uint16_t)rate;
+        refMs_ = now;
+    }
+
+    if (dvdt_ > cfg_.dvdtUp || imbalance > cfg_.imbalanceUp) {
+        calm_ = false;
+        setLevel(SCHED_FAST, now);
+    } else if (dvdt_ < cfg_.dvdtDown && imbalance < cfg_.imbalanceDown) {
+        if (!calm_) {
+            calm_ = true;
+            calmSince_ = now;
+        } else if (now - calmSince_ >= cfg_.holdMs && level_ > floor_) {
+            setLevel((SchedLevel)(level_ - 1), now);
+            calmSince_ = now;
+        }
+    } else {
+        calm_ = false;   // Entre os limiares: mantém o nível (histerese)
+    }
+}
@@ -0,0 +1,103 @@
+#pragma once
+#include <stdint.h>
+#include "pack_config.h"
+
+/**
+ * Escalonador adaptativo da amostragem: acelera em transitórios (dV/dt ou
+ * desbalanceamento entre células acima do limiar) e volta ao ritmo lento
+ * quando o pack fica estável. A descida tem histerese (limiares de descida
+ * abaixo dos de subida) e só acontece após holdMs de calma, um nível por vez.
+ *
+ * O relógio é injetado, então a lógica roda em host com um relógio simulado.
+ */
+
+enum SchedLevel : uint8_t {
+    SCHED_SLOW,     // Pack estável
+    SCHED_NORMAL,   // Ritmo padrão (nível inicial)
+    SCHED_FAST,     // Transitório
+    SCHED_LEVELS
+};
+
+struct SchedConfig {
+    bool     adaptive;                   // false = fica sempre em SCHED_NORMAL
+    uint32_t periodMs[SCHED_LEVELS];     // Período de cada nível
+    uint16_t dvdtUp;                     // mV/s em qualquer célula que leva ao nível rápido
+    uint16_t dvdtDown;                   // mV/s abaixo do qual o pack é considerado estável
+    uint16_t imbalanceUp;                // mV entre a maior e a menor célula que leva ao nível rápido
+    uint16_t imbalanceDown;              // mV abaixo do qual o desbalanceamento é considerado estável
+    uint32_t holdMs;                     // Tempo estável antes de descer um nível
+};
+
+static constexpr SchedConfig SCHED_DEFAULT_CONFIG = {
+    true, {2000, 500, 200}, 20, 8, 150, 120, 30000
+};
+
+// dV/dt é medido contra uma referência de pelo menos esta idade, para o
+// ruído de 1–2 mV entre amostras próximas não parecer transitório.
+static constexpr uint32_t SCHED_SLOPE_WINDOW_MS = 1000;
+
+/**
+ * Nome do nível ("slow", "normal", "fast"), para log e JSON.
+ */
+const char *SCHED_name(SchedLevel l);
+
+class SampleScheduler {
+public:
+    typedef uint32_t (*Clock)();   // ms monotônico (millis() no ESP32)
+
+    explicit SampleScheduler(Clock clock) : clock_(clock) {}
+
+    /** Aplica a configuração e volta ao nível SCHED_NORMAL. */
+    void configure(const SchedConfig &cfg);
+
+    /**
+     * Limite inferior do período (tempo de uma aquisição completa).
+     * @param ms Período mínimo em ms.
+     */
+    void setMinPeriod(uint32_t ms);
+
+    /**
+     * Nível mínimo enquanto alguém precisa de amostras num prazo (captura de
+     * calibração). Sobe na hora se o nível atual estiver abaixo; a calma não
+     * desce abaixo dele. SCHED_SLOW libera.
+     * @param l Nível mínimo.
+     */
+    void setFloor(SchedLevel l);
+
+    /**
+     * Indica se é hora de iniciar uma aquisição e agenda a próxima. Um atraso
+     * maior que um período não gera rajada de amostras para recuperar.
+     */
+    bool due();
+
+    /**
+     * Informa as tensões de uma aquisição concluída e reavalia o nível.
+     * @param mv Tensões das PACK_CELLS células em mV.
+     */
+    void observe(const uint16_t mv[PACK_CELLS]);
+
+    SchedLevel level() const { return level_; }
+    uint32_t periodMs() const { return periodOf(level_); }
+    uint32_t periodOf(SchedLevel l) const;
+    uint32_t transitions() const { return transitions_; }
+    uint16_t lastDvdt() const { return dvdt_; }
+
+private:
+    void setLevel(SchedLevel l, uint32_t now);
+
+    Clock       clock_;
+    SchedConfig cfg_ = SCHED_DEFAULT_CONFIG;
+    uint32_t    minPeriod_ = 0;
+    SchedLevel  level_ = SCHED_NORMAL;
+    SchedLevel  floor_ = SCHED_SLOW;
+    bool        started_ = false;
+    uint32_t    lastStart_ = 0;
+    uint32_t    next_ = 0;
+    bool        haveRef_ = false;
+    uint16_t    ref_[PACK_CELLS] = {0};
+    uint32_t    refMs_ = 0;
+    uint16_t    dvdt_ = 0;
+    bool        calm_ = false;
+    uint32_t    calmSince_ = 0;
+    uint32_t    transitions_ = 0;
+};
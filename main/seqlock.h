@@ -0,0 +1,69 @@
+#pragma once
+#include <atomic>
+#if defined(ESP_PLATFORM)
+#include <freertos/FreeRTOS.h>
+#else
+#include <thread>
+#endif
+
+/**
+ * Publicação de um valor por um único escritor para vários leitores, sem
+ * travas (seqlock). O escritor nunca espera; o leitor repete a cópia se ela
+ * coincidiu com uma escrita. Serve para valores pequenos e copiáveis que são
+ * escritos com pouca frequência e lidos de outras tarefas.
+ *
+ * O leitor gira enquanto a sequência está ímpar, então o escritor não pode
+ * ser preemptado por um leitor no meio da escrita: um leitor de prioridade
+ * maior no mesmo núcleo (AsyncTCP, 3, lendo o que o loop(), 1, publica)
+ * giraria para sempre. No ESP32 a escrita roda numa seção crítica (sem
+ * preempção nem interrupções no núcleo, alguns µs para estes valores); em
+ * host o leitor cede a CPU ao ver a escrita em andamento.
+ */
+template <typename T>
+class SeqLock {
+public:
+    /**
+     * Publica um novo valor (somente o escritor chama).
+     * @param v Valor a publicar.
+     */
+    void store(const T &v) {
+#if defined(ESP_PLATFORM)
+        portENTER_CRITICAL(&mux_);
+#endif
+        uint32_t s = seq_.load(std::memory_order_relaxed);
+        seq_.store(s + 1, std::memory_order_relaxed);   // Ímpar: escrita em andamento
+        std::atomic_thread_fence(std::memory_order_release);
+        value_ = v;
+        seq_.store(s + 2, std::memory_order_release);
+#if defined(ESP_PLATFORM)
+        portEXIT_CRITICAL(&mux_);
+#endif
+    }
+
+    /**
+     * Lê uma cópia consistente do último valor publicado.
+     * @param out Recebe o valor.
+     * @return true se algum valor já foi publicado.
+     */
+    bool load(T &out) const {
+        for (;;) {
+            uint32_t s1 = seq_.load(std::memory_order_acquire);
+            if (s1 & 1) {
+#if !defined(ESP_PLATFORM)
+                std::this_thread::yield();
+#endif
+                continue;   // No ESP32 o escritor só pode estar no outro núcleo, por alguns µs
+            }
+            out = value_;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (seq_.load(std::memory_order_relaxed) == s1) return s1 != 0;
+        }
+    }
+
+private:
+    std::atomic<uint32_t> seq_{0};
+    T value_{};
+#if defined(ESP_PLATFORM)
+    portMUX_TYPE mux_ = portMUX_INITIALIZER_UNLOCKED;
+#endif
+};
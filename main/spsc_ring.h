@@ -0,0 +1,82 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+
+/**
+ * Fila circular lock-free de capacidade fixa para um único produtor e um
+ * único consumidor (SPSC). O produtor só escreve 'head' e o consumidor só
+ * escreve 'tail'; a ordem acquire/release garante que o item está completo
+ * antes de ficar visível do outro lado. Não depende do Arduino/FreeRTOS,
+ * então compila também em host com std::thread.
+ *
+ * Capacity precisa ser potência de 2 (índices mascarados).
+ */
+template <typename T, size_t Capacity>
+class SpscRing {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                  "SpscRing: Capacity deve ser potência de 2");
+public:
+    /**
+     * Insere um item (somente o produtor chama).
+     * @param item Item a copiar para a fila.
+     * @return true se inserido, false se a fila estava cheia (item descartado).
+     */
+    bool push(const T &item) {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        const size_t tail = tail_.load(std::memory_order_acquire);
+        const size_t used = head - tail;
+        if (used >= Capacity) {
+            overflows_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        buf_[head & (Capacity - 1)] = item;
+        head_.store(head + 1, std::memory_order_release);
+        pushed_.fetch_add(1, std::memory_order_relaxed);
+
+        // Marca d'água: só o produtor escreve, leitura relaxada basta.
+        if (used + 1 > highWater_.load(std::memory_order_relaxed)) {
+            highWater_.store(used + 1, std::memory_order_relaxed);
+        }
+        return true;
+    }
+
+    /**
+     * Remove o item mais antigo (somente o consumidor chama).
+     * @param out Recebe o item removido.
+     * @return true se havia item, false se a fila estava vazia.
+     */
+    bool pop(T &out) {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        const size_t head = head_.load(std::memory_order_acquire);
+        if (head == tail) return false;
+        out = buf_[tail & (Capacity - 1)];
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /** Número de itens na fila (aproximado se chamado de uma terceira thread). */
+    size_t size() const {
+        return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+    }
+
+    static constexpr size_t capacity() { return Capacity; }
+
+    /** Total de itens inseridos com sucesso. */
+    uint32_t pushed() const { return pushed_.load(std::memory_order_relaxed); }
+
+    /** Total de itens descartados por fila cheia. */
+    uint32_t overflows() const { return overflows_.load(std::memory_order_relaxed); }
+
+    /** Maior ocupação já observada pelo produtor. */
+    size_t highWater() const { return highWater_.load(std::memory_order_relaxed); }
+
+private:
+    T buf_[Capacity];
+    // Produtor e consumidor em linhas de cache distintas (evita false sharing).
+    alignas(32) std::atomic<size_t> head_{0};
+    alignas(32) std::atomic<size_t> tail_{0};
+    std::atomic<uint32_t> pushed_{0};
+    std::atomic<uint32_t> overflows_{0};
+    std::atomic<size_t> highWater_{0};
+};
@@ -1,71 +1,668 @@
 #include "storage.h"
+#include "timebase.h"
+#include "metrics.h"
 #include <SPIFFS.h>
+#include <new>
 
-static File logFile;
+// O log é um anel de SEG_COUNT segmentos de tamanho fixo (/segNN.bin). Cada
+// segmento recebe um número de sequência crescente e ocupa o slot seq % SEG_COUNT,
+// então o mais antigo é sobrescrito naturalmente. O endereço lógico de um bloco
+// é seq * SEG_BYTES + offset. Um índice pequeno (/log.idx) guarda o intervalo de
+// tempo de cada segmento: a montagem não varre arquivos e a busca por tempo
+// só lê cabeçalhos de bloco do segmento certo.
+// Retenção: a partição limita o anel, não um alvo de dias. Com ~2,4 bytes por
+// amostra (logfmt_test sobre experimento2, que é ruidosa) cabem ~3,9 M amostras:
+// ~23 dias a 2 Hz, ~9 dias se o pack ficar no nível rápido (5 Hz) e ~3 meses no
+// lento (0,5 Hz). Para guardar mais, use o escalonador adaptativo (sched.h) ou a
+// redução do log (logcomp.h, ~3,5x com ±10 mV).
+static constexpr uint8_t  SEG_COUNT = 36;                          // 9 MB de ~12 MB (folga para o GC da SPIFFS)
+static constexpr uint32_t SEG_BYTES = 512 * LOG_BLOCK_SIZE;        // 256 KB por segmento
+static constexpr uint32_t IDX_MAGIC = 0x31584449;                  // "IDX1"
+static constexpr const char *IDX_PATH = "/log.idx";
+static constexpr uint8_t  WB_MAX_BLOCKS = 16;                      // Buffer de write-behind: 8 KB
 
-static bool openLog(bool writeHeader) {
-    logFile = SPIFFS.open("/log.csv", FILE_APPEND);
+struct SegEntry {
+    uint32_t seq;      // Sequência do segmento no slot (válido se >= firstSeq)
+    uint32_t bytes;    // Bytes de blocos fechados
+    uint64_t t0;       // Primeiro timestamp (ms)
+    uint64_t t1;       // Último timestamp (ms)
+};
+
+struct SegIndex {
+    uint32_t magic;
+    uint32_t headSeq;    // Segmento em escrita
+    uint32_t firstSeq;   // Segmentos com seq menor foram apagados (FS_clearLogs)
+    uint32_t crc;        // CRC32 das entradas
+    SegEntry seg[SEG_COUNT];
+};
+
+static SegIndex idx;
+static File logFile;                  // Segmento em escrita (idx.headSeq)
+static LogBlockWriter writer;
+static uint8_t blockBuf[LOG_BLOCK_SIZE];
+
+// Write-behind: blocos fechados esperam na RAM e vão para a flash em lotes.
+// O bloco ainda aberto é gravado como "cauda" no fim do segmento e regravado
+// no mesmo lugar a cada lote, então nenhum espaço é perdido com blocos parciais.
+static uint8_t  wbBuf[WB_MAX_BLOCKS][LOG_BLOCK_SIZE];
+static uint8_t  wbCount = 0;
+static uint32_t committedEnd = 0;     // Offset após o último bloco fechado no segmento
+static uint32_t pendingSinceMs = 0;   // Chegada do registro mais antigo ainda não gravado
+static bool     pending = false;
+static LogPolicy policy = LOG_DEFAULT_POLICY;
+static LogCompressor comp;            // Redução antes do codificador (LogPolicy::mode)
+static FsStats  stats = {};
+
+// O log é escrito pelo loop() e lido/limpo pelos handlers HTTP (tarefa AsyncTCP).
+static SemaphoreHandle_t fsMutex = nullptr;
+
+// Trava recursiva do módulo durante o escopo.
+struct FsLock {
+    FsLock()  { xSemaphoreTakeRecursive(fsMutex, portMAX_DELAY); }
+    ~FsLock() { xSemaphoreGiveRecursive(fsMutex); }
+};
+
+static SegEntry &entryOf(uint32_t seq) {
+    return idx.seg[seq % SEG_COUNT];
+}
+
+static void segPath(uint32_t seq, char *path) {
+    snprintf(path, 16, "/seg%02u.bin", (unsigned)(seq % SEG_COUNT));
+}
+
+// Sequência do segmento mais antigo ainda válido.
+static uint32_t oldestSeq() {
+    uint32_t s = idx.headSeq >= SEG_COUNT - 1 ? idx.headSeq - (SEG_COUNT - 1) : 0;
+    return s < idx.firstSeq ? idx.firstSeq : s;
+}
+
+static bool segValid(uint32_t seq) {
+    return seq >= oldestSeq() && seq <= idx.headSeq && entryOf(seq).seq == seq;
+}
+
+// --- Índice ---
+
+static void saveIndex() {
+    idx.magic = IDX_MAGIC;
+    idx.crc = LOG_crc32(0, (const uint8_t *)idx.seg, sizeof(idx.seg));
+    File f = SPIFFS.open(IDX_PATH, FILE_WRITE);
+    if (!f || f.write((const uint8_t *)&idx, sizeof(idx)) != sizeof(idx)) {
+        Serial.println("[FS] Erro ao gravar o índice do log");
+    }
+    if (f) f.close();
+}
+
+static bool loadIndex() {
+    File f = SPIFFS.open(IDX_PATH, FILE_READ);
+    if (!f) return false;
+    bool ok = f.read((uint8_t *)&idx, sizeof(idx)) == sizeof(idx)
+        && idx.magic == IDX_MAGIC
+        && idx.crc == LOG_crc32(0, (const uint8_t *)idx.seg, sizeof(idx.seg));
+    f.close();
+    return ok;
+}
+
+// Lê o cabeçalho do bloco em 'off' de um arquivo aberto.
+static bool readHeaderAt(File &f, uint32_t off, LogBlockHeader &h) {
+    uint8_t raw[sizeof(LogBlockHeader)];
+    return f.seek(off) && f.read(raw, sizeof(raw)) == sizeof(raw) && LOG_peekHeader(raw, h);
+}
+
+// Recalcula t0/t1/bytes de um segmento a partir do primeiro e do último bloco.
+static void refreshEntry(uint32_t seq) {
+    SegEntry &e = entryOf(seq);
+    char path[16];
+    segPath(seq, path);
+    File f = SPIFFS.open(path, FILE_READ);
+    e.seq = seq;
+    e.bytes = 0;
+    e.t0 = e.t1 = 0;
+    if (!f) return;
+    uint32_t size = f.size() - f.size() % LOG_BLOCK_SIZE;
+    LogBlockHeader h;
+    if (size && readHeaderAt(f, 0, h)) e.t0 = h.t0;
+    if (size && readHeaderAt(f, size - LOG_BLOCK_SIZE, h)) e.t1 = h.t0 + h.span;
+    e.bytes = size;
+    f.close();
+}
+
+// Índice ausente ou corrompido: reconstrói a partir dos segmentos existentes
+// (só dois cabeçalhos lidos por arquivo). O mais novo é o de maior t0; os
+// anteriores ocupam os slots imediatamente antes dele, com t0 decrescente.
+static void rebuildIndex() {
+    Serial.println("[FS] Índice do log ausente/inválido, reconstruindo...");
+    memset(&idx, 0, sizeof(idx));
+    int newest = -1;
+    for (uint8_t slot = 0; slot < SEG_COUNT; slot++) {
+        refreshEntry(slot);
+        if (idx.seg[slot].bytes && (newest < 0 || idx.seg[slot].t0 > idx.seg[newest].t0)) newest = slot;
+    }
+    if (newest < 0) return;   // Log vazio: começa do segmento 0
+
+    // Renumera mantendo seq % SEG_COUNT == slot (SEG_COUNT de folga para não ficar negativo).
+    idx.headSeq = SEG_COUNT + newest;
+    idx.firstSeq = idx.headSeq;
+    uint64_t prevT0 = idx.seg[newest].t0;
+    for (uint8_t k = 1; k < SEG_COUNT; k++) {
+        SegEntry &e = entryOf(idx.headSeq - k);
+        if (!e.bytes || e.t0 >= prevT0) break;
+        prevT0 = e.t0;
+        idx.firstSeq = idx.headSeq - k;
+    }
+    for (uint8_t slot = 0; slot < SEG_COUNT; slot++) {
+        uint32_t seq = idx.headSeq - ((newest - slot + SEG_COUNT) % SEG_COUNT);
+        idx.seg[slot].seq = seq >= idx.firstSeq ? seq : 0;
+    }
+}
+
+// --- Escrita ---
+
+static bool openHead(bool truncate) {
+    char path[16];
+    segPath(idx.headSeq, path);
+    // "r+" permite regravar a cauda; cria/trunca o arquivo quando necessário.
+    if (truncate || !SPIFFS.exists(path)) {
+        File f = SPIFFS.open(path, FILE_WRITE);
+        if (f) f.close();
+    }
+    logFile = SPIFFS.open(path, "r+");
     if (!logFile) {
-        Serial.println("[FS] Erro ao abrir/criar /log.csv");
+        Serial.printf("[FS] Erro ao abrir/criar %s\n", path);
         return false;
     }
-    // Escreve cabeçalho se o arquivo está vazio
-    if (logFile.size() == 0 && writeHeader) {
-        logFile.println("hora,c1_mv,c1_soc,c2_mv,c2_soc,c3_mv,c3_soc,c4_mv,c4_soc,total_mv");
-        logFile.flush();
-    }
+    // Um bloco parcial deixado por um boot anterior é mantido como está.
+    committedEnd = logFile.size() - logFile.size() % LOG_BLOCK_SIZE;
     return true;
 }
 
-bool FS_init() {
-    // SPIFFS já deve estar montado no setup()
-    if (!openLog(true)) {
-        Serial.println("[FS] Arquivo de log não disponível");
-        return false;
+// Fecha o segmento atual e passa para o próximo slot, descartando o mais antigo.
+static bool rollSegment() {
+    logFile.close();
+    entryOf(idx.headSeq).bytes = committedEnd;
+    idx.headSeq++;
+    SegEntry &e = entryOf(idx.headSeq);
+    e = SegEntry{idx.headSeq, 0, 0, 0};
+    saveIndex();
+    return openHead(true);
+}
+
+// Grava um bloco em committedEnd e atualiza o intervalo de tempo do segmento.
+static bool writeBlockAt(const uint8_t *blk, bool advance) {
+    if (committedEnd + LOG_BLOCK_SIZE > SEG_BYTES && !rollSegment()) return false;
+    if (!logFile.seek(committedEnd) || logFile.write(blk, LOG_BLOCK_SIZE) != LOG_BLOCK_SIZE) return false;
+
+    LogBlockHeader h;
+    LOG_peekHeader(blk, h);
+    SegEntry &e = entryOf(idx.headSeq);
+    if (committedEnd == 0) e.t0 = h.t0;
+    e.t1 = h.t0 + h.span;
+    if (advance) {
+        committedEnd += LOG_BLOCK_SIZE;
+        e.bytes = committedEnd;
     }
-    Serial.println("[FS] Log pronto para uso");
     return true;
 }
 
-bool FS_appendCsv(const CellSample &s) {
+// Grava os blocos fechados pendentes e a cauda (bloco aberto) em escritas
+// alinhadas a LOG_BLOCK_SIZE, seguidas de um único flush.
+static bool commit() {
+    if (!pending) return true;
     if (!logFile) {
         Serial.println("[FS] Log não aberto, tentando reabrir...");
-        if (!openLog(false)) return false;
-    }
-    // Rotaciona log se necessário
-    if (logFile.size() > 512000) {
-        logFile.close();
-        if (SPIFFS.exists("/log_old.csv")) SPIFFS.remove("/log_old.csv");
-        SPIFFS.rename("/log.csv", "/log_old.csv");
-        if (!openLog(true)) return false;
-    }
-    // Escreve linha de dados
-    time_t now = time(nullptr);
-    if (now < 1600000000) {
-        Serial.println("[FS] Tempo do sistema inválido");
-        return false;
+        if (!openHead(false)) return false;
+    }
+    uint32_t t0 = micros();
+    bool hasTail = !writer.empty();
+    size_t bytes = 0;
+    bool ok = true;
+    uint8_t written = 0;
+
+    while (written < wbCount && (ok = writeBlockAt(wbBuf[written], true))) {
+        bytes += LOG_BLOCK_SIZE;
+        written++;
+    }
+    if (ok && hasTail) {
+        writer.finish(blockBuf);
+        ok = writeBlockAt(blockBuf, false);
+        if (ok) bytes += LOG_BLOCK_SIZE;
     }
-    struct tm tm;
-    localtime_r(&now, &tm);
-    size_t bytesWritten = logFile.printf("%02d:%02d:%02d,%u,%u,%u,%u,%u,%u,%u,%u,%u\n",
-        tm.tm_hour, tm.tm_min, tm.tm_sec,
-        s.mv[0], s.soc[0], s.mv[1], s.soc[1],
-        s.mv[2], s.soc[2], s.mv[3], s.soc[3],
-        s.total);
     logFile.flush();
-    if (bytesWritten == 0) {
+
+    if (!ok) {
+        // Descarta o resto do lote para manter a RAM limitada; a cauda segue no writer.
         Serial.println("[FS] Erro ao escrever no log");
+        stats.droppedBlocks += wbCount - written;
+    }
+    wbCount = 0;
+    pending = !ok && hasTail;
+    pendingSinceMs = millis();
+
+    uint32_t dt = micros() - t0;
+    stats.bytesWritten += bytes;
+    stats.flushes++;
+    stats.lastFlushUs = dt;
+    MET_RECORD(MET_FS_FLUSH, dt);
+    if (dt > stats.maxFlushUs) stats.maxFlushUs = dt;
+    return ok;
+}
+
+// Fecha o bloco aberto e o coloca no buffer de write-behind.
+static bool closeBlock() {
+    if (writer.empty()) return true;
+    bool ok = true;
+    if (wbCount == WB_MAX_BLOCKS) ok = commit();   // Esvazia o buffer mesmo se falhar
+    writer.finish(wbBuf[wbCount++]);
+    writer.reset();
+    return ok;
+}
+
+bool FS_init() {
+    if (!fsMutex) fsMutex = xSemaphoreCreateRecursiveMutex();
+    FsLock lock;
+    writer.reset();
+    wbCount = 0;
+    pending = false;
+
+    // SPIFFS já deve estar montado no setup()
+    if (!loadIndex()) {
+        rebuildIndex();
+        saveIndex();
+    }
+    // A posição de escrita vem do índice; só o segmento atual é consultado
+    // (tamanho do arquivo e primeiro/último cabeçalho).
+    refreshEntry(idx.headSeq);
+    if (!openHead(false)) {
+        Serial.println("[FS] Arquivo de log não disponível");
         return false;
     }
+    Serial.printf("[FS] Log pronto para uso (segmento %lu, %lu bytes, %lu segmentos)\n",
+        (unsigned long)idx.headSeq, (unsigned long)committedEnd,
+        (unsigned long)(idx.headSeq - oldestSeq() + 1));
     return true;
 }
 
+void FS_setPolicy(const LogPolicy &p) {
+    FsLock lock;
+    policy = p;
+    if (policy.batchBlocks == 0) policy.batchBlocks = 1;
+    if (policy.batchBlocks > WB_MAX_BLOCKS) policy.batchBlocks = WB_MAX_BLOCKS;
+    comp.configure(LogCompConfig{policy.mode, policy.deviationMv, policy.heartbeatMs});
+    Serial.printf("[FS] Write-behind: lote de %u blocos, perda máx. %lu ms\n",
+        policy.batchBlocks, (unsigned long)policy.maxLossMs);
+    if (policy.mode != LOG_MODE_ALL) {
+        Serial.printf("[FS] Redução %s: desvio máx. %u mV, heartbeat %lu ms\n",
+            policy.mode == LOG_MODE_DEADBAND ? "banda morta" : "swinging door",
+            policy.deviationMv, (unsigned long)policy.heartbeatMs);
+    }
+}
+
+// Acrescenta um registro ao bloco aberto (fecha o bloco se estiver cheio).
+static bool appendRecord(const LogRecord &r) {
+    bool ok = true;
+    if (!writer.append(r)) {
+        // Bloco cheio: vai para o buffer e começa outro com este registro.
+        ok = closeBlock();
+        writer.append(r);
+    }
+    if (!pending) {
+        pending = true;
+        pendingSinceMs = millis();
+    }
+    if (wbCount >= policy.batchBlocks) ok = commit() && ok;
+    return ok;
+}
+
+bool FS_append(const CellSample &s) {
+    MET_SCOPE(MET_FS_APPEND);
+    LogRecord r;
+    r.epochMs = s.epochMs;
+    memcpy(r.mv, s.mv, sizeof(r.mv));
+    r.total = s.total;
+    r.flags = s.flags;
+
+    FsLock lock;
+    LogRecord out[2];
+    uint8_t n = comp.push(r, out);
+    bool ok = true;
+    for (uint8_t i = 0; i < n; i++) ok = appendRecord(out[i]) && ok;
+    return ok;
+}
+
+void FS_tick() {
+    static uint32_t lastReport = 0;
+    FsLock lock;
+    if (pending && millis() - pendingSinceMs >= policy.maxLossMs) commit();
+
+    // Resumo de desgaste/latência uma vez por hora.
+    if (millis() - lastReport >= 3600000UL) {
+        lastReport = millis();
+        FsStats st;
+        FS_getStats(st);
+        Serial.printf("[FS] %lu bytes gravados, %lu lotes/h, flush máx. %lu us, %lu blocos perdidos\n",
+            (unsigned long)st.bytesWritten, (unsigned long)st.flushesPerHour,
+            (unsigned long)st.maxFlushUs, (unsigned long)st.droppedBlocks);
+        if (st.recordsOut) {
+            Serial.printf("[FS] Redução: %lu amostras -> %lu registros (%.1f:1)\n",
+                (unsigned long)st.samplesIn, (unsigned long)st.recordsOut,
+                (float)st.samplesIn / st.recordsOut);
+        }
+    }
+}
+
+bool FS_sync() {
+    FsLock lock;
+    LogRecord r;
+    bool ok = true;
+    if (comp.flush(r)) ok = appendRecord(r);
+    return commit() && ok;
+}
+
+void FS_getStats(FsStats &st) {
+    FsLock lock;
+    st = stats;
+    uint32_t up = millis();
+    st.flushesPerHour = up ? (uint32_t)((uint64_t)stats.flushes * 3600000ULL / up) : 0;
+    st.bufferedBlocks = wbCount;
+    st.segments = idx.headSeq - oldestSeq() + 1;
+    st.oldestMs = entryOf(oldestSeq()).t0;
+    st.samplesIn = comp.samplesIn();
+    st.recordsOut = comp.recordsOut();
+}
+
+uint64_t FS_lastMs() {
+    FsLock lock;
+    const uint32_t oldest = oldestSeq();
+    for (uint32_t seq = idx.headSeq + 1; seq-- > oldest; ) {
+        if (segValid(seq) && entryOf(seq).t1) return entryOf(seq).t1;
+    }
+    return 0;
+}
+
 bool FS_clearLogs() {
+    FsLock lock;
+    // O(1): as entradas antigas passam a ser ignoradas pelo índice e os arquivos
+    // são truncados quando o slot for reutilizado. Só o segmento novo é criado.
     if (logFile) logFile.close();
-    if (SPIFFS.remove("/log.csv")) {
+    writer.reset();
+    comp.configure(LogCompConfig{policy.mode, policy.deviationMv, policy.heartbeatMs});
+    wbCount = 0;
+    pending = false;
+    idx.headSeq++;
+    idx.firstSeq = idx.headSeq;
+    entryOf(idx.headSeq) = SegEntry{idx.headSeq, 0, 0, 0};
+    saveIndex();
+    if (openHead(true)) {
         Serial.println("[FS] Log apagado");
-        return openLog(true);
+        return true;
     }
     Serial.println("[FS] Falha ao apagar log");
     return false;
-}
\ No newline at end of file
+}
+
+// --- Leitura ---
+
+struct LogCursor {
+    uint64_t       addr = 0;         // Endereço lógico do próximo bloco
+    File           f;
+    uint32_t       fSeq = UINT32_MAX;
+    uint8_t        block[LOG_BLOCK_SIZE];
+    LogBlockReader reader;
+    bool           blockOpen = false;
+    bool           atWriter = false; // 'block' é a cópia do bloco aberto: addr não avançou
+    uint16_t       seen = 0;         // Registros já lidos de 'block'
+    uint16_t       skip = 0;         // Registros do início de 'block' já entregues antes
+    uint64_t       fromMs = 0;
+};
+
+// Fim (exclusivo) dos blocos fechados de um segmento na flash. A cauda do
+// segmento atual fica de fora: a versão em vigor do bloco aberto está na RAM.
+static uint32_t segEnd(uint32_t seq) {
+    return seq == idx.headSeq ? committedEnd : entryOf(seq).bytes;
+}
+
+// Primeiro bloco que pode conter registros >= ms: escolhe o segmento pelo
+// índice e faz busca binária nos cabeçalhos dos blocos dele.
+static uint64_t findAddr(uint64_t ms) {
+    uint32_t seq = oldestSeq();
+    while (seq < idx.headSeq && (!segValid(seq) || entryOf(seq).t1 < ms)) seq++;
+    uint64_t base = (uint64_t)seq * SEG_BYTES;
+    if (ms == 0 || entryOf(seq).t0 >= ms) return base;
+
+    char path[16];
+    segPath(seq, path);
+    File f = SPIFFS.open(path, FILE_READ);
+    if (!f) return base;
+    uint32_t lo = 0, hi = segEnd(seq) / LOG_BLOCK_SIZE;   // Primeiro bloco com fim >= ms
+    LogBlockHeader h;
+    while (lo < hi) {
+        uint32_t mid = (lo + hi) / 2;
+        if (readHeaderAt(f, mid * LOG_BLOCK_SIZE, h) && h.t0 + h.span < ms) lo = mid + 1;
+        else hi = mid;
+    }
+    f.close();
+    return base + (uint64_t)lo * LOG_BLOCK_SIZE;
+}
+
+// Depois do fim da flash vêm, no mesmo endereçamento, os blocos fechados do
+// write-behind e o bloco aberto (copiado do writer sem avançar o endereço: ele
+// ainda cresce). Assim a leitura vê tudo sem forçar um commit fora do lote.
+// 'done' registros do bloco aberto já foram entregues: sem nada novo, é o fim.
+static bool readRamBlock(LogCursor *c, uint64_t flashEnd, uint16_t done) {
+    const uint64_t k = (c->addr - flashEnd) / LOG_BLOCK_SIZE;
+    if (k < wbCount) {
+        memcpy(c->block, wbBuf[k], LOG_BLOCK_SIZE);
+        c->addr += LOG_BLOCK_SIZE;
+        c->atWriter = false;
+        return true;
+    }
+    if (k > wbCount || writer.count() <= done) return false;
+    writer.finish(c->block);
+    c->atWriter = true;
+    return true;
+}
+
+// Lê o bloco em c->addr e avança. Retorna false no fim do log (o cursor fica
+// como estava e pode continuar depois).
+static bool readNextBlock(LogCursor *c) {
+    // O bloco aberto lido antes pode ter crescido, fechado ou ido para a flash
+    // no mesmo endereço: o começo dele já foi entregue.
+    const uint16_t done = c->atWriter ? c->seen : 0;
+    for (;;) {
+        const uint64_t flashEnd = (uint64_t)idx.headSeq * SEG_BYTES + committedEnd;
+        if (c->addr >= flashEnd) {
+            if (!readRamBlock(c, flashEnd, done)) return false;
+            break;
+        }
+        uint32_t seq = (uint32_t)(c->addr / SEG_BYTES);
+        uint32_t off = (uint32_t)(c->addr % SEG_BYTES);
+        if (seq > idx.headSeq) return false;
+        if (seq < oldestSeq()) {
+            // O escritor deu a volta no anel: pula para o segmento mais antigo.
+            c->addr = (uint64_t)oldestSeq() * SEG_BYTES;
+            continue;
+        }
+        if (!segValid(seq) || off >= segEnd(seq)) {
+            if (seq == idx.headSeq) return false;
+            c->addr = (uint64_t)(seq + 1) * SEG_BYTES;
+            continue;
+        }
+        if (c->fSeq != seq) {
+            if (c->f) c->f.close();
+            char path[16];
+            segPath(seq, path);
+            c->f = SPIFFS.open(path, FILE_READ);
+            c->fSeq = seq;
+        }
+        bool ok = c->f && c->f.seek(off) && c->f.read(c->block, LOG_BLOCK_SIZE) == LOG_BLOCK_SIZE;
+        c->addr += LOG_BLOCK_SIZE;
+        if (ok) {
+            c->atWriter = false;
+            break;
+        }
+    }
+    c->skip = done;
+    c->seen = 0;
+    return true;
+}
+
+LogCursor *FS_cursorOpen(uint64_t fromMs) {
+    LogCursor *c = new (std::nothrow) LogCursor();
+    if (!c) return nullptr;
+    FsLock lock;
+    c->fromMs = fromMs;
+    c->addr = findAddr(TIME_toStored(fromMs));
+    return c;
+}
+
+bool FS_cursorNext(LogCursor *c, LogRecord &r) {
+    FsLock lock;   // Não intercala com a troca de segmento
+    for (;;) {
+        while (c->blockOpen && c->reader.next(r)) {
+            if (c->seen++ < c->skip) continue;
+            r.epochMs = TIME_toWall(r.epochMs, r.flags);
+            if (r.epochMs >= c->fromMs) return true;
+        }
+        c->blockOpen = false;
+        if (!readNextBlock(c)) return false;
+        // Bloco corrompido é pulado; os demais continuam legíveis.
+        c->blockOpen = c->reader.open(c->block);
+    }
+}
+
+void FS_cursorClose(LogCursor *c) {
+    if (!c) return;
+    if (c->f) c->f.close();
+    delete c;
+}
+
+// --- Exportação CSV ---
+
+struct CsvExport {
+    LogCursor *cur = nullptr;
+    char       line[48 + 16 * PACK_CELLS];   // Hora + ",mV,SoC" por célula + total (ou o cabeçalho)
+    uint16_t   lineLen = 0;
+    uint16_t   linePos = 0;
+};
+
+// Gera a próxima linha em e->line. Retorna false no fim do log.
+static bool nextCsvLine(CsvExport *e) {
+    LogRecord r;
+    if (!FS_cursorNext(e->cur, r)) return false;
+
+    time_t secs = (time_t)(r.epochMs / 1000);
+    struct tm tm;
+    localtime_r(&secs, &tm);
+    int n = snprintf(e->line, sizeof(e->line), "%04d-%02d-%02d %02d:%02d:%02d.%03u",
+        tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday, tm.tm_hour, tm.tm_min, tm.tm_sec,
+        (unsigned)(r.epochMs % 1000));
+    for (uint8_t i = 0; i < PACK_CELLS; i++) {
+        n += snprintf(e->line + n, sizeof(e->line) - n, ",%u,%u", r.mv[i], ADS_mvToSoc(r.mv[i]));
+    }
+    n += snprintf(e->line + n, sizeof(e->line) - n, ",%u\n", r.total);
+    e->lineLen = (uint16_t)n;
+    e->linePos = 0;
+    return true;
+}
+
+CsvExport *FS_csvOpen(uint64_t fromMs) {
+    CsvExport *e = new (std::nothrow) CsvExport();
+    if (!e) return nullptr;
+    e->cur = FS_cursorOpen(fromMs);
+    if (!e->cur) {
+        delete e;
+        return nullptr;
+    }
+    int n = snprintf(e->line, sizeof(e->line), "hora");
+    for (uint8_t i = 0; i < PACK_CELLS; i++) {
+        n += snprintf(e->line + n, sizeof(e->line) - n, ",c%u_mv,c%u_soc", (unsigned)(i + 1), (unsigned)(i + 1));
+    }
+    n += snprintf(e->line + n, sizeof(e->line) - n, ",total_mv\n");
+    e->lineLen = (uint16_t)n;
+    return e;
+}
+
+size_t FS_csvRead(CsvExport *e, uint8_t *buf, size_t maxLen) {
+    size_t n = 0;
+    while (n < maxLen) {
+        if (e->linePos == e->lineLen && !nextCsvLine(e)) break;
+        size_t chunk = min((size_t)(e->lineLen - e->linePos), maxLen - n);
+        memcpy(buf + n, e->line + e->linePos, chunk);
+        e->linePos += chunk;
+        n += chunk;
+    }
+    return n;
+}
+
+void FS_csvClose(CsvExport *e) {
+    if (!e) return;
+    FS_cursorClose(e->cur);
+    delete e;
+}
+
+// --- Acesso bruto por endereço lógico ---
+
+struct RawExport {
+    uint64_t addr = 0;                // Próximo byte a copiar
+    uint64_t end = 0;
+    uint64_t blockAddr = UINT64_MAX;  // Endereço do bloco em 'block'
+    File     f;
+    uint32_t fSeq = UINT32_MAX;
+    uint8_t  block[LOG_BLOCK_SIZE];
+};
+
+void FS_rawRange(uint64_t fromMs, uint64_t &start, uint64_t &end) {
+    FsLock lock;
+    end = (uint64_t)idx.headSeq * SEG_BYTES + committedEnd;
+    start = findAddr(TIME_toStored(fromMs));
+    if (start > end) start = end;
+}
+
+// Carrega em e->block o bloco que começa em 'addr' (zeros se não houver).
+static void loadRawBlock(RawExport *e, uint64_t addr) {
+    uint32_t seq = (uint32_t)(addr / SEG_BYTES);
+    uint32_t off = (uint32_t)(addr % SEG_BYTES);
+    e->blockAddr = addr;
+    bool ok = false;
+    if (segValid(seq) && off + LOG_BLOCK_SIZE <= (seq == idx.headSeq ? committedEnd : entryOf(seq).bytes)) {
+        if (e->fSeq != seq) {
+            if (e->f) e->f.close();
+            char path[16];
+            segPath(seq, path);
+            e->f = SPIFFS.open(path, FILE_READ);
+            e->fSeq = seq;
+        }
+        ok = e->f && e->f.seek(off) && e->f.read(e->block, LOG_BLOCK_SIZE) == LOG_BLOCK_SIZE;
+    }
+    if (!ok) memset(e->block, 0, LOG_BLOCK_SIZE);
+}
+
+RawExport *FS_rawOpen(uint64_t start, uint64_t end) {
+    RawExport *e = new (std::nothrow) RawExport();
+    if (!e) return nullptr;
+    e->addr = start;
+    e->end = end;
+    return e;
+}
+
+size_t FS_rawRead(RawExport *e, uint8_t *buf, size_t maxLen) {
+    FsLock lock;   // O slot pode ser reaproveitado pela troca de segmento
+    size_t n = 0;
+    while (n < maxLen && e->addr < e->end) {
+        uint64_t blockAddr = e->addr - e->addr % LOG_BLOCK_SIZE;
+        if (blockAddr != e->blockAddr) loadRawBlock(e, blockAddr);
+        size_t off = (size_t)(e->addr - blockAddr);
+        size_t chunk = LOG_BLOCK_SIZE - off;
+        if (chunk > maxLen - n) chunk = maxLen - n;
+        if (chunk > e->end - e->addr) chunk = (size_t)(e->end - e->addr);
+        memcpy(buf + n, e->block + off, chunk);
+        e->addr += chunk;
+        n += chunk;
+    }
+    return n;
+}
+
+void FS_rawClose(RawExport *e) {
+    if (!e) return;
+    if (e->f) e->f.close();
+    delete e;
+}
@@ -1,5 +1,37 @@
 #pragma once
 #include "ads_driver.h"
+#include "logfmt.h"
+#include "logcomp.h"
+
+/**
+ * Política de gravação do log (write-behind).
+ */
+struct LogPolicy {
+    uint32_t maxLossMs;     // Idade máxima de um registro só na RAM (janela de perda em queda de energia)
+    uint8_t  batchBlocks;   // Blocos fechados acumulados antes de gravar um lote
+    LogMode  mode;          // Quais amostras gravar (ver logcomp.h)
+    uint16_t deviationMv;   // Erro máximo da série reconstruída nos modos com redução
+    uint32_t heartbeatMs;   // Intervalo máximo entre registros nos modos com redução
+};
+
+static constexpr LogPolicy LOG_DEFAULT_POLICY = {30000, 8, LOG_MODE_ALL, 2, 60000};
+
+/**
+ * Contadores de gravação, para medir desgaste da flash e latência.
+ */
+struct FsStats {
+    uint32_t bytesWritten;     // Bytes gravados na flash desde o boot
+    uint32_t flushes;          // Lotes gravados (cada um termina com um flush)
+    uint32_t flushesPerHour;   // Média de lotes por hora desde o boot
+    uint32_t maxFlushUs;       // Maior latência de um lote (µs)
+    uint32_t lastFlushUs;      // Latência do último lote (µs)
+    uint32_t droppedBlocks;    // Blocos descartados por erro de escrita
+    uint8_t  bufferedBlocks;   // Blocos fechados aguardando na RAM
+    uint8_t  segments;         // Segmentos em uso no anel
+    uint64_t oldestMs;         // Timestamp mais antigo ainda no log
+    uint32_t samplesIn;        // Amostras recebidas por FS_append() desde o boot
+    uint32_t recordsOut;       // Registros gravados após a redução (LogPolicy::mode)
+};
 
 /**
  * Inicializa o sistema de arquivos.
@@ -8,14 +40,146 @@
 bool FS_init();
 
 /**
- * Adiciona uma amostra ao arquivo CSV.
+ * Define a política de write-behind (chamar após FS_init()).
+ * @param p Nova política (batchBlocks é limitado à capacidade do buffer).
+ */
+void FS_setPolicy(const LogPolicy &p);
+
+/**
+ * Adiciona uma amostra ao log binário (ver logfmt.h), passando antes pela
+ * redução configurada em LogPolicy::mode. O registro fica na RAM até o lote
+ * encher, a janela de perda vencer (FS_tick) ou FS_sync(). No modo swinging
+ * door a última amostra aceita fica retida até o próximo vértice (no máximo
+ * heartbeatMs), então a janela de perda cresce nesse tanto.
  * @param s Amostra a ser salva.
  * @return true se bem sucedido, false em caso de erro.
  */
-bool FS_appendCsv(const CellSample &s);
+bool FS_append(const CellSample &s);
+
+/**
+ * Grava o lote pendente se o registro mais antigo ficou na RAM mais que
+ * LogPolicy::maxLossMs. Deve ser chamada periodicamente pelo loop().
+ */
+void FS_tick();
+
+/**
+ * Grava imediatamente tudo o que está na RAM (incluindo o bloco aberto e a
+ * amostra retida pela redução).
+ * @return true se bem sucedido, false em caso de erro.
+ */
+bool FS_sync();
+
+/**
+ * Lê os contadores de gravação.
+ * @param st Estrutura a preencher.
+ */
+void FS_getStats(FsStats &st);
+
+/**
+ * Último timestamp gravado no log (como está na flash, sem correção).
+ * @return Timestamp em ms, ou 0 se o log está vazio.
+ */
+uint64_t FS_lastMs();
+
+/**
+ * Estado de uma leitura sequencial do log.
+ */
+struct LogCursor;
+
+/**
+ * Abre uma leitura do log a partir de um instante. Usa o índice de segmentos
+ * e busca binária nos cabeçalhos de bloco, sem varrer o log.
+ * @param fromMs Primeiro timestamp desejado (0 = desde o início).
+ * @return Cursor aberto, ou nullptr em caso de erro.
+ */
+LogCursor *FS_cursorOpen(uint64_t fromMs);
+
+/**
+ * Lê o próximo registro do log, com o timestamp já no relógio de parede
+ * (registros provisórios passam por TIME_toWall()). Depois da flash vêm os
+ * registros ainda na RAM (write-behind e bloco aberto), sem forçar gravação;
+ * só a amostra retida pela redução fica de fora até sair dela.
+ * @param c Cursor aberto por FS_cursorOpen().
+ * @param r Recebe o registro.
+ * @return true se havia registro, false no fim do log.
+ */
+bool FS_cursorNext(LogCursor *c, LogRecord &r);
+
+/**
+ * Libera um cursor.
+ * @param c Cursor aberto por FS_cursorOpen() (pode ser nullptr).
+ */
+void FS_cursorClose(LogCursor *c);
 
 /**
- * Limpa todos os logs.
+ * Limpa todos os logs (O(1): invalida os segmentos no índice).
  * @return true se bem sucedido, false em caso de erro.
  */
-bool FS_clearLogs();
\ No newline at end of file
+bool FS_clearLogs();
+
+/**
+ * Estado de uma exportação do log em CSV (uma por download).
+ */
+struct CsvExport;
+
+/**
+ * Inicia a transcodificação do log binário para CSV.
+ * @param fromMs Primeiro timestamp exportado (0 = todo o log).
+ * @return Exportação aberta, ou nullptr em caso de erro.
+ */
+CsvExport *FS_csvOpen(uint64_t fromMs = 0);
+
+/**
+ * Produz o próximo trecho do CSV.
+ * @param e Exportação aberta por FS_csvOpen().
+ * @param buf Buffer de saída.
+ * @param maxLen Tamanho do buffer.
+ * @return Bytes escritos em 'buf'; 0 indica o fim do CSV.
+ */
+size_t FS_csvRead(CsvExport *e, uint8_t *buf, size_t maxLen);
+
+/**
+ * Libera uma exportação.
+ * @param e Exportação aberta por FS_csvOpen() (pode ser nullptr).
+ */
+void FS_csvClose(CsvExport *e);
+
+/**
+ * Intervalo de endereços lógicos (seq * tamanho do segmento + offset) dos
+ * blocos fechados já gravados. Esses bytes não mudam mais até serem
+ * sobrescritos pelo anel, então servem para downloads retomáveis (Range).
+ * @param fromMs Começa no primeiro bloco que pode ter registros >= fromMs (0 = início).
+ * @param start Recebe o endereço inicial (alinhado a LOG_BLOCK_SIZE).
+ * @param end Recebe o endereço final (exclusivo).
+ */
+void FS_rawRange(uint64_t fromMs, uint64_t &start, uint64_t &end);
+
+/**
+ * Estado de uma leitura dos blocos binários por endereço lógico.
+ */
+struct RawExport;
+
+/**
+ * Abre a leitura de um trecho de endereços lógicos.
+ * @param start Primeiro byte.
+ * @param end Fim (exclusivo).
+ * @return Leitura aberta, ou nullptr em caso de erro.
+ */
+RawExport *FS_rawOpen(uint64_t start, uint64_t end);
+
+/**
+ * Copia os próximos bytes do trecho. Endereços sem dados (segmento apagado
+ * ou já sobrescrito) saem como zeros, para o tamanho anunciado valer sempre;
+ * o leitor descarta esses blocos pelo magic/CRC.
+ * @param e Leitura aberta por FS_rawOpen().
+ * @param buf Buffer de saída.
+ * @param maxLen Tamanho do buffer.
+ * @return Bytes escritos; 0 indica o fim do trecho.
+ */
+size_t FS_rawRead(RawExport *e, uint8_t *buf, size_t maxLen);
+
+/**
+ * Libera uma leitura.
+ * @param e Leitura aberta por FS_rawOpen() (pode ser nullptr).
+ */
+void FS_rawClose(RawExport *e);
@@ -0,0 +1,165 @@
+#include "timebase.h"
+#include "ads_driver.h"
+#include <SPIFFS.h>
+#include <Preferences.h>
+#include <esp_timer.h>
+#include <sys/time.h>
+#include <atomic>
+
+static constexpr const char *MAP_PATH = "/time.map";
+static constexpr uint64_t BOOT_GAP_MS = 1000;       // Folga entre o fim do log e o primeiro timestamp provisório
+static constexpr uint64_t FIX_SLACK_MS = 5000;      // Amostra carimbada enquanto TIME_poll() troca de relógio
+
+static uint32_t bootId = 0;
+static uint64_t provBase = TIME_VALID_EPOCH_MS;     // Constante depois de TIME_init()
+static volatile bool synced = false;
+static volatile bool provisionalUsed = false;
+static bool aheadWarned = false;
+
+// Correções: só acrescentadas (uma por boot), então os leitores percorrem
+// até 'fixCount' sem trava.
+static TimeFix fixes[TIME_MAX_FIXES];
+static std::atomic<uint8_t> fixCount{0};
+
+static uint64_t monoMs() {
+    return (uint64_t)esp_timer_get_time() / 1000;
+}
+
+static uint64_t wallMs() {
+    struct timeval tv;
+    gettimeofday(&tv, nullptr);
+    return (uint64_t)tv.tv_sec * 1000 + tv.tv_usec / 1000;
+}
+
+// Carrega /time.map mantendo as TIME_MAX_FIXES - 1 mais novas (sobra lugar
+// para a deste boot); regrava o arquivo se descartou alguma.
+static void loadFixes() {
+    File f = SPIFFS.open(MAP_PATH, FILE_READ);
+    if (!f) return;
+    size_t total = f.size() / sizeof(TimeFix);
+    size_t skip = total > TIME_MAX_FIXES - 1 ? total - (TIME_MAX_FIXES - 1) : 0;
+    uint8_t n = 0;
+    f.seek(skip * sizeof(TimeFix));
+    while (n < TIME_MAX_FIXES - 1 && f.read((uint8_t *)&fixes[n], sizeof(TimeFix)) == sizeof(TimeFix)) n++;
+    f.close();
+    fixCount.store(n);
+
+    if (skip) {
+        File w = SPIFFS.open(MAP_PATH, FILE_WRITE);
+        if (w) {
+            w.write((const uint8_t *)fixes, n * sizeof(TimeFix));
+            w.close();
+        }
+    }
+}
+
+void TIME_init(uint64_t lastLoggedMs) {
+    Preferences prefs;
+    prefs.begin("time", false);
+    bootId = prefs.getUInt("boot", 0) + 1;
+    prefs.putUInt("boot", bootId);
+    prefs.end();
+
+    loadFixes();
+    synced = false;
+    provisionalUsed = false;
+
+    // Reinício por software mantém o RTC: não há o que corrigir.
+    if (wallMs() >= TIME_VALID_EPOCH_MS) {
+        synced = true;
+        Serial.printf("[TIME] Boot %u com relógio válido\n", (unsigned)bootId);
+        return;
+    }
+    uint64_t start = lastLoggedMs + BOOT_GAP_MS;
+    if (start < TIME_VALID_EPOCH_MS) start = TIME_VALID_EPOCH_MS;
+    provBase = start - monoMs();
+    Serial.printf("[TIME] Boot %u sem relógio: timestamps provisórios até a sincronização\n", (unsigned)bootId);
+}
+
+uint64_t TIME_nowMs(bool *provisional) {
+    if (synced) {
+        if (provisional) *provisional = false;
+        return wallMs();
+    }
+    provisionalUsed = true;
+    if (provisional) *provisional = true;
+    return provBase + monoMs();
+}
+
+bool TIME_poll(TimeFix &fix) {
+    if (synced) return false;
+    uint64_t wall = wallMs();
+    if (wall < TIME_VALID_EPOCH_MS) return false;
+    uint64_t prov = provBase + monoMs();
+    if (wall < prov) {
+        // O log anterior estava adiantado: segue no relógio provisório até o
+        // de parede passar dele, para os timestamps gravados não voltarem.
+        if (!aheadWarned) {
+            Serial.printf("[TIME] Relógio de parede %llu ms atrás do log, aguardando\n",
+                (unsigned long long)(prov - wall));
+            aheadWarned = true;
+        }
+        return false;
+    }
+    synced = true;
+
+    fix.bootId = bootId;
+    fix.reserved = 0;
+    fix.fromMs = provBase;
+    fix.toMs = prov + FIX_SLACK_MS;
+    fix.correctionMs = (int64_t)(wall - prov);
+    Serial.printf("[TIME] Relógio sincronizado (boot %u): correção de %lld ms\n",
+        (unsigned)bootId, (long long)fix.correctionMs);
+    if (!provisionalUsed) return false;
+
+    uint8_t n = fixCount.load();
+    if (n < TIME_MAX_FIXES) {
+        fixes[n] = fix;
+        fixCount.store(n + 1);
+    }
+    File f = SPIFFS.open(MAP_PATH, FILE_APPEND);
+    if (f) {
+        f.write((const uint8_t *)&fix, sizeof(fix));
+        f.close();
+    } else {
+        Serial.println("[TIME] Falha ao gravar /time.map");
+    }
+    return true;
+}
+
+bool TIME_synced() {
+    return synced;
+}
+
+uint32_t TIME_bootId() {
+    return bootId;
+}
+
+uint64_t TIME_toWall(uint64_t storedMs, uint8_t flags) {
+    if (!(flags & SAMPLE_FLAG_PROVISIONAL)) return storedMs;
+    uint8_t n = fixCount.load();
+    for (uint8_t i = 0; i < n; i++) {
+        if (storedMs >= fixes[i].fromMs && storedMs <= fixes[i].toMs) return storedMs + fixes[i].correctionMs;
+    }
+    return storedMs;   // Boot que nunca sincronizou: fica com o tempo provisório
+}
+
+uint64_t TIME_toStored(uint64_t wallMs) {
+    uint8_t n = fixCount.load();
+    for (uint8_t i = 0; i < n; i++) {
+        const TimeFix &f = fixes[i];
+        // A correção é sempre >= 0 (TIME_poll espera o relógio de parede
+        // alcançar o provisório), então o trecho corrigido fica à frente.
+        uint64_t c = (uint64_t)f.correctionMs;
+        if (wallMs >= f.fromMs + c && wallMs <= f.toMs + c) return wallMs - c;
+        if (wallMs >= f.fromMs && wallMs < f.fromMs + c) return f.fromMs;
+    }
+    return wallMs;
+}
+
+uint8_t TIME_fixes(TimeFix *out, uint8_t max) {
+    uint8_t n = fixCount.load();
+    if (n > max) n = max;
+    memcpy(out, fixes + (fixCount.load() - n), n * sizeof(TimeFix));
+    return n;
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include <Arduino.h>
+
+/**
+ * Base de tempo das amostras.
+ *
+ * A aquisição começa logo após o boot, antes do WiFi/NTP. Enquanto o relógio
+ * de parede não é válido, as amostras recebem um timestamp provisório
+ * (continuação do fim do log + relógio monotônico desde o boot) e a flag
+ * SAMPLE_FLAG_PROVISIONAL. Quando o NTP sincroniza, a correção daquele boot é
+ * gravada como um registro de deslocamento em /time.map; os leitores do log
+ * aplicam a correção (TIME_toWall) em vez de reescrever blocos já gravados.
+ */
+
+static constexpr uint64_t TIME_VALID_EPOCH_MS = 1600000000000ULL;   // Antes disso o relógio não foi acertado
+static constexpr uint8_t  TIME_MAX_FIXES = 32;                      // Correções mantidas (uma por boot sem RTC válido)
+
+/**
+ * Correção de um boot: registros provisórios com timestamp em [fromMs, toMs]
+ * valem timestamp + correctionMs.
+ */
+struct TimeFix {
+    uint32_t bootId;         // Boot que gerou os registros provisórios
+    uint32_t reserved;
+    uint64_t fromMs;         // Primeiro timestamp provisório possível do boot
+    uint64_t toMs;           // Último timestamp provisório possível do boot
+    int64_t  correctionMs;   // Relógio de parede - relógio provisório na sincronização
+};
+static_assert(sizeof(TimeFix) == 32, "TimeFix deve ter 32 bytes");
+
+/**
+ * Incrementa o ID de boot (NVS), carrega as correções e define a base
+ * provisória. Chamar após FS_init().
+ * @param lastLoggedMs Último timestamp gravado no log (0 = log vazio).
+ */
+void TIME_init(uint64_t lastLoggedMs);
+
+/**
+ * Timestamp atual em ms: relógio de parede se já sincronizado, senão provisório.
+ * @param provisional Se não for nullptr, recebe true quando o valor é provisório.
+ */
+uint64_t TIME_nowMs(bool *provisional = nullptr);
+
+/**
+ * Verifica se o relógio de parede ficou válido (chamar periodicamente do loop()).
+ * @param fix Recebe a correção do boot atual quando a sincronização acontece.
+ * @return true uma única vez, quando houve amostras provisórias a corrigir.
+ */
+bool TIME_poll(TimeFix &fix);
+
+/** Indica se os timestamps novos já vêm do relógio de parede. */
+bool TIME_synced();
+
+/** ID deste boot (incrementado a cada boot, persistido em NVS). */
+uint32_t TIME_bootId();
+
+/**
+ * Converte o timestamp gravado de um registro para o relógio de parede.
+ * @param storedMs Timestamp gravado.
+ * @param flags Flags do registro (só registros com SAMPLE_FLAG_PROVISIONAL mudam).
+ */
+uint64_t TIME_toWall(uint64_t storedMs, uint8_t flags);
+
+/**
+ * Menor timestamp gravado cujo registro pode valer >= wallMs no relógio de
+ * parede, para buscas no log.
+ * @param wallMs Instante no relógio de parede.
+ */
+uint64_t TIME_toStored(uint64_t wallMs);
+
+/**
+ * Copia as correções conhecidas (mais antiga primeiro).
+ * @param out Destino.
+ * @param max Capacidade de 'out'.
+ * @return Correções copiadas.
+ */
+uint8_t TIME_fixes(TimeFix *out, uint8_t max);
@@ -0,0 +1,234 @@
+#include "uplink.h"
+#include <WiFi.h>
+#include <WiFiUdp.h>
+#include <HTTPClient.h>
+#include <Preferences.h>
+#include "seqlock.h"
+#include "storage.h"
+
+static constexpr BaseType_t UPL_CORE = 1;         // Junto com o loop(); a aquisição fica sozinha no núcleo 0
+static constexpr UBaseType_t UPL_PRIORITY = 1;    // Abaixo do AsyncTCP (3): o dashboard tem preferência
+static constexpr uint32_t UPL_STACK = 6144;       // HTTPClient + WiFiClient
+static constexpr uint32_t UPL_POLL_MS = 1000;     // Verificação de blocos novos
+static constexpr uint32_t UPL_RETRY_MIN_MS = 2000;
+static constexpr uint32_t UPL_RETRY_MAX_MS = 120000;
+
+// Estado publicado pela tarefa de envio para a API.
+struct UplinkStatus {
+    uint64_t cursor;      // Próximo endereço a enviar
+    uint64_t end;         // Fim dos blocos fechados no log
+    uint32_t seq;         // Próximo número de lote
+    uint32_t batches;     // Lotes confirmados desde o boot
+    uint32_t blocks;      // Blocos confirmados desde o boot
+    uint32_t failures;    // Envios sem confirmação desde o boot
+    uint32_t skipped;     // Blocos sobrescritos pelo anel antes do envio
+    uint32_t lastOkMs;    // millis() da última confirmação (0 = nenhuma)
+    int16_t  lastCode;    // Último status HTTP (ou 1/0 = ACK/sem ACK no UDP; <0 = erro de conexão)
+};
+
+static UplinkConfig cfg = UPL_DEFAULT_CONFIG;
+// Publicado pela tarefa de envio (prioridade 1) e lido pelo UPL_writeJson() no
+// AsyncTCP (3): a escrita roda em seção crítica (seqlock.h), então o leitor
+// nunca pega a tarefa preemptada no meio dela.
+static SeqLock<UplinkStatus> status;
+static UplinkStatus published{};   // Última cópia publicada (só a tarefa de envio acessa)
+static uint8_t *buf = nullptr;   // Cabeçalho + blocos do lote em envio
+static WiFiUDP udp;
+static bool udpOpen = false;
+static uint8_t mac[6];
+
+// Publica só quando algo mudou: a verificação de 1 s quase sempre não muda nada.
+static void publish(const UplinkStatus &st) {
+    if (!memcmp(&st, &published, sizeof(st))) return;
+    published = st;
+    status.store(st);
+}
+
+static void saveCursor(uint64_t cursor, uint32_t seq) {
+    Preferences prefs;
+    prefs.begin("uplink", false);
+    prefs.putULong64("addr", cursor);
+    prefs.putUInt("seq", seq);
+    prefs.end();
+}
+
+static bool sendHttp(size_t len, int16_t &code) {
+    HTTPClient http;
+    http.setTimeout(cfg.timeoutMs);
+    http.setConnectTimeout(cfg.timeoutMs);
+    if (!http.begin(cfg.host, cfg.port, cfg.path)) {
+        code = -1;
+        return false;
+    }
+    http.addHeader("Content-Type", "application/octet-stream");
+    int c = http.POST(buf, len);
+    http.end();
+    code = (int16_t)c;
+    return c >= 200 && c < 300;
+}
+
+static bool sendUdp(size_t len, const UplinkHeader &h, int16_t &code) {
+    code = 0;
+    // Porta local qualquer: o coletor responde ao remetente.
+    if (!udpOpen) udpOpen = udp.begin(0);
+    if (!udpOpen || !udp.beginPacket(cfg.host, cfg.port)) {
+        code = -1;
+        return false;
+    }
+    udp.write(buf, len);
+    if (!udp.endPacket()) {
+        code = -1;
+        return false;
+    }
+    // Espera o ACK deste lote; ACKs atrasados de tentativas anteriores são descartados.
+    const uint64_t next = h.addr + (uint64_t)h.blocks * LOG_BLOCK_SIZE;
+    const uint32_t t0 = millis();
+    while (millis() - t0 < cfg.timeoutMs) {
+        int n = udp.parsePacket();
+        if (n == sizeof(UplinkAck)) {
+            UplinkAck ack;
+            udp.read((uint8_t *)&ack, sizeof(ack));
+            if (ack.magic == UPL_ACK_MAGIC && ack.seq == h.seq && ack.next == next) {
+                code = 1;
+                return true;
+            }
+        } else if (n > 0) {
+            udp.flush();
+        }
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+    return false;
+}
+
+// Lê 'n' blocos a partir de 'addr' para depois do cabeçalho.
+static bool readBlocks(uint64_t addr, uint16_t n) {
+    const uint64_t end = addr + (uint64_t)n * LOG_BLOCK_SIZE;
+    RawExport *e = FS_rawOpen(addr, end);
+    if (!e) return false;
+    size_t want = (size_t)n * LOG_BLOCK_SIZE;
+    size_t got = FS_rawRead(e, buf + sizeof(UplinkHeader), want);
+    FS_rawClose(e);
+    return got == want;
+}
+
+static void uplinkTask(void *) {
+    UplinkStatus st = published;
+    uint32_t pendingSince = 0;   // millis() em que apareceu o bloco mais antigo ainda não enviado
+    uint32_t retryAt = 0;
+    uint8_t fails = 0;
+
+    for (;;) {
+        vTaskDelay(pdMS_TO_TICKS(UPL_POLL_MS));
+
+        uint64_t start;
+        FS_rawRange(0, start, st.end);
+        if (st.cursor > st.end) {
+            // Log recriado (índice perdido): os endereços recomeçaram.
+            Serial.println("[UPL] Cursor além do fim do log, recomeçando do início");
+            st.cursor = start;
+            saveCursor(st.cursor, st.seq);
+        }
+        if (st.cursor < start) {
+            // O anel passou por cima de blocos não enviados: segue do mais antigo.
+            uint32_t lost = (uint32_t)((start - st.cursor) / LOG_BLOCK_SIZE);
+            Serial.printf("[UPL] %u blocos sobrescritos antes do envio\n", (unsigned)lost);
+            st.skipped += lost;
+            st.cursor = start;
+            saveCursor(st.cursor, st.seq);
+        }
+        publish(st);
+
+        uint64_t avail = (st.end - st.cursor) / LOG_BLOCK_SIZE;
+        if (!avail) {
+            pendingSince = 0;
+            continue;
+        }
+        if (!pendingSince) pendingSince = millis() | 1;
+        if (avail < cfg.batchBlocks && millis() - pendingSince < cfg.flushMs) continue;
+        if (fails && (int32_t)(millis() - retryAt) < 0) continue;
+        if (WiFi.status() != WL_CONNECTED) continue;
+
+        UplinkHeader h{};
+        h.magic = UPL_MAGIC;
+        h.version = UPL_VERSION;
+        h.cells = PACK_CELLS;
+        h.blocks = (uint16_t)(avail < cfg.batchBlocks ? avail : cfg.batchBlocks);
+        h.addr = st.cursor;
+        h.seq = st.seq;
+        memcpy(h.mac, mac, sizeof(h.mac));
+        memcpy(buf, &h, sizeof(h));
+        if (!readBlocks(h.addr, h.blocks)) continue;
+
+        const size_t len = sizeof(h) + (size_t)h.blocks * LOG_BLOCK_SIZE;
+        bool ok = cfg.mode == UPL_UDP ? sendUdp(len, h, st.lastCode) : sendHttp(len, st.lastCode);
+        if (ok) {
+            st.cursor += (uint64_t)h.blocks * LOG_BLOCK_SIZE;
+            st.seq++;
+            st.batches++;
+            st.blocks += h.blocks;
+            st.lastOkMs = millis() | 1;
+            saveCursor(st.cursor, st.seq);
+            if (fails) Serial.printf("[UPL] Coletor de volta após %u falhas\n", (unsigned)fails);
+            fails = 0;
+            pendingSince = 0;
+        } else {
+            // Backoff exponencial: um coletor fora do ar não ocupa a rede a cada segundo.
+            st.failures++;
+            uint32_t wait = UPL_RETRY_MIN_MS << (fails < 6 ? fails : 6);
+            if (wait > UPL_RETRY_MAX_MS) wait = UPL_RETRY_MAX_MS;
+            retryAt = millis() + wait;
+            if (!fails) Serial.printf("[UPL] Lote %u sem confirmação (%d), tentando de novo\n", (unsigned)h.seq, st.lastCode);
+            if (fails < UINT8_MAX) fails++;
+        }
+        publish(st);
+    }
+}
+
+bool UPL_init(const UplinkConfig &c) {
+    cfg = c;
+    if (cfg.batchBlocks < 1) cfg.batchBlocks = 1;
+    if (cfg.batchBlocks > UPL_MAX_BLOCKS) cfg.batchBlocks = UPL_MAX_BLOCKS;
+    if (cfg.mode == UPL_UDP && cfg.batchBlocks > UPL_UDP_MAX_BLOCKS) cfg.batchBlocks = UPL_UDP_MAX_BLOCKS;
+
+    UplinkStatus st{};
+    Preferences prefs;
+    prefs.begin("uplink", true);
+    st.cursor = prefs.getULong64("addr", 0);
+    st.seq = prefs.getUInt("seq", 0);
+    prefs.end();
+    published = st;
+    status.store(st);
+
+    if (!cfg.enabled || !cfg.host[0]) {
+        Serial.println("[UPL] Envio ao coletor desligado");
+        return true;
+    }
+    buf = (uint8_t *)malloc(sizeof(UplinkHeader) + (size_t)cfg.batchBlocks * LOG_BLOCK_SIZE);
+    if (!buf) {
+        Serial.println("[UPL] Sem memória para o buffer do lote");
+        return false;
+    }
+    WiFi.macAddress(mac);
+    if (xTaskCreatePinnedToCore(uplinkTask, "uplink", UPL_STACK, nullptr, UPL_PRIORITY, nullptr, UPL_CORE) != pdPASS) {
+        Serial.println("[UPL] Falha ao criar tarefa de envio");
+        return false;
+    }
+    Serial.printf("[UPL] Enviando para %s:%u via %s a partir do endereço %llu (lote %u)\n",
+        cfg.host, (unsigned)cfg.port, cfg.mode == UPL_UDP ? "UDP" : "HTTP",
+        (unsigned long long)st.cursor, (unsigned)st.seq);
+    return true;
+}
+
+void UPL_writeJson(Print &out) {
+    UplinkStatus st;
+    status.load(st);
+    uint64_t pending = st.end > st.cursor ? (st.end - st.cursor) / LOG_BLOCK_SIZE : 0;
+    out.printf("{\"enabled\":%s,\"mode\":\"%s\",\"host\":\"%s\",\"port\":%u,",
+        cfg.enabled ? "true" : "false", cfg.mode == UPL_UDP ? "udp" : "http", cfg.host, (unsigned)cfg.port);
+    out.printf("\"cursor\":%llu,\"end\":%llu,\"pendingBlocks\":%llu,\"seq\":%u,",
+        (unsigned long long)st.cursor, (unsigned long long)st.end, (unsigned long long)pending, (unsigned)st.seq);
+    out.printf("\"batches\":%u,\"blocks\":%u,\"failures\":%u,\"skipped\":%u,\"lastCode\":%d,",
+        (unsigned)st.batches, (unsigned)st.blocks, (unsigned)st.failures, (unsigned)st.skipped, st.lastCode);
+    if (st.lastOkMs) out.printf("\"lastOkAgoMs\":%u}", (unsigned)(millis() - st.lastOkMs));
+    else out.print("\"lastOkAgoMs\":null}");
+}
@@ -0,0 +1,89 @@
+#pragma once
+#include <Arduino.h>
+#include "logfmt.h"
+
+/**
+ * Envio do log a um coletor na rede local (store-and-forward).
+ *
+ * A unidade de envio é o bloco fechado do log (logfmt.h), exatamente como
+ * está na flash: já vem delta-codificado (~2–3 bytes por registro) e com
+ * CRC. Cada lote leva um cabeçalho com o endereço lógico do primeiro bloco
+ * (o mesmo de FS_rawRange()) e um número de sequência, e só avança o cursor
+ * quando o coletor confirma (HTTP 2xx ou datagrama de ACK no UDP). O cursor
+ * e a sequência ficam na NVS: depois de uma queda do Wi-Fi, do coletor ou um
+ * reboot, o envio retoma do primeiro bloco não confirmado. Se o anel
+ * sobrescrever blocos ainda não enviados, o envio pula para o bloco mais
+ * antigo disponível e o coletor vê o salto no endereço.
+ *
+ * Roda numa tarefa própria (HTTP/UDP bloqueiam), lendo o log pelo mesmo
+ * caminho do /download?format=bin.
+ */
+
+enum UplinkMode : uint8_t {
+    UPL_HTTP,   // POST do lote inteiro em http://host:port/path
+    UPL_UDP     // Um datagrama por lote (até UPL_UDP_MAX_BLOCKS blocos), ACK do coletor
+};
+
+static constexpr uint16_t UPL_MAX_BLOCKS = 16;      // Teto do lote (8 KB de buffer)
+static constexpr uint16_t UPL_UDP_MAX_BLOCKS = 2;   // Cabe num quadro Ethernet sem fragmentar
+
+struct UplinkConfig {
+    bool       enabled;
+    UplinkMode mode;
+    char       host[64];
+    uint16_t   port;
+    char       path[48];      // Só no HTTP
+    uint16_t   batchBlocks;   // Blocos por lote (envia assim que houver esse tanto)
+    uint32_t   flushMs;       // Envia um lote incompleto se o bloco mais antigo esperou isso
+    uint32_t   timeoutMs;     // Espera pela confirmação do coletor
+};
+
+static constexpr UplinkConfig UPL_DEFAULT_CONFIG = {
+    false, UPL_HTTP, "", 8089, "/ingest", 8, 60000, 3000
+};
+
+static constexpr uint32_t UPL_MAGIC = 0x314C5055;       // "UPL1"
+static constexpr uint32_t UPL_ACK_MAGIC = 0x4B415055;   // "UPAK"
+static constexpr uint8_t  UPL_VERSION = 1;
+
+/**
+ * Cabeçalho de cada lote (little-endian, 32 bytes), seguido de 'blocks'
+ * blocos de LOG_BLOCK_SIZE bytes.
+ */
+struct UplinkHeader {
+    uint32_t magic;      // UPL_MAGIC
+    uint8_t  version;    // UPL_VERSION
+    uint8_t  cells;      // PACK_CELLS
+    uint16_t blocks;     // Blocos no lote
+    uint64_t addr;       // Endereço lógico do primeiro bloco (múltiplo de LOG_BLOCK_SIZE)
+    uint32_t seq;        // Número do lote (+1 a cada lote confirmado)
+    uint8_t  mac[6];     // Identifica o dispositivo no coletor
+    uint8_t  reserved[6];
+};
+static_assert(sizeof(UplinkHeader) == 32, "UplinkHeader deve ter 32 bytes");
+
+/**
+ * Confirmação de um lote no UDP (16 bytes): 'seq' do lote e o endereço
+ * seguinte ao último bloco recebido.
+ */
+struct UplinkAck {
+    uint32_t magic;      // UPL_ACK_MAGIC
+    uint32_t seq;
+    uint64_t next;
+};
+static_assert(sizeof(UplinkAck) == 16, "UplinkAck deve ter 16 bytes");
+
+/**
+ * Carrega o cursor da NVS e inicia a tarefa de envio (se habilitado).
+ * Chamar depois de FS_init().
+ * @param cfg Configuração (UPL_DEFAULT_CONFIG + seção "uplink" do /config.json).
+ * @return true se a tarefa está rodando ou o envio está desligado.
+ */
+bool UPL_init(const UplinkConfig &cfg);
+
+/**
+ * Escreve em JSON o estado do envio: destino, cursor, blocos pendentes e
+ * contadores. Pode ser chamada de qualquer tarefa.
+ * @param out Destino.
+ */
+void UPL_writeJson(Print &out);
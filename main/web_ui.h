@@ -1,130 +1,237 @@
 #pragma once
+#include <Arduino.h>
 
-static const char index_html[] PROGMEM = R"rawliteral(
-<!DOCTYPE html>
-<html>
-<head>
-<meta charset='utf-8'>
-<meta name='viewport' content='width=device-width, initial-scale=1'>
-<title>LiPo Monitor</title>
-<script src='https://cdn.jsdelivr.net/npm/chart.js'></script>
-<style>
-body { font-family: 'Segoe UI', sans-serif; background: #f4f4f9; margin: 0 auto; max-width: 1000px; padding: 20px; color: #333; }
-h2 { text-align: center; }
-.tabs { text-align: center; margin-bottom: 20px; }
-.tabs button {
-  background-color: #2196F3;
-  border: none;
-  color: white;
-  padding: 10px 20px;
-  margin: 0 5px;
-  border-radius: 6px;
-  cursor: pointer;
-  transition: background-color 0.3s;
-}
-.tabs button:hover { background-color: #1565c0; }
-.tabs button.active { background-color: #0d47a1; }
-.pane { display: none; }
-.pane.active { display: block; }
-.cards { display: flex; gap: 12px; flex-wrap: wrap; justify-content: center; }
-.card { background: white; border-radius: 10px; padding: 12px; width: 140px; box-shadow: 0 4px 8px rgba(0,0,0,0.1); text-align: center; cursor: pointer; transition: transform 0.2s; }
-.card:hover { transform: scale(1.05); }
-.battery { width: 50px; height: 100px; border: 3px solid #333; border-radius: 6px; position: relative; margin: 8px auto; background: linear-gradient(to top, var(--batt-color) var(--level), #ddd var(--level)); }
-.battery::before { content: ""; position: absolute; top: -10px; left: 15px; width: 20px; height: 6px; background: #333; border-radius: 2px; }
-.total-battery { border-width: 4px; }
-canvas { max-width: 100%; height: 180px; margin-top: 20px; }
-a { display: inline-block; margin-top: 12px; color: #2196F3; text-decoration: none; }
-a:hover { text-decoration: underline; }
-.setup-box { background: white; padding: 20px; border-radius: 10px; box-shadow: 0 4px 10px rgba(0,0,0,0.1); max-width: 500px; margin: auto; }
-.setup-box h3 { margin-top: 0; }
-.setup-box input { width: 60px; padding: 5px; margin: 5px; border: 1px solid #ccc; border-radius: 4px; }
-.setup-box button { background-color: #2196F3; color: white; border: none; padding: 8px 16px; border-radius: 6px; margin: 8px 0; cursor: pointer; transition: background-color 0.3s; }
-.setup-box button:hover { background-color: #0d47a1; }
-</style>
-</head>
-<body>
-<h2>Monitor de Baterias LiPo</h2>
-<div class='tabs'>
- <button id='tabMon' class='active'>Monitor</button>
- <button id='tabSet'>Setup</button>
-</div>
-<div id='paneMon' class='pane active'>
-  <div class='cards'>
-    <div class='card' onclick="selectCell(0)">C1<div class='battery' id='batt0'></div><span id='v0'>-</span> V | <span id='soc0'>-</span>%</div>
-    <div class='card' onclick="selectCell(1)">C2<div class='battery' id='batt1'></div><span id='v1'>-</span> V | <span id='soc1'>-</span>%</div>
-    <div class='card' onclick="selectCell(2)">C3<div class='battery' id='batt2'></div><span id='v2'>-</span> V | <span id='soc2'>-</span>%</div>
-    <div class='card' onclick="selectCell(3)">C4<div class='battery' id='batt3'></div><span id='v3'>-</span> V | <span id='soc3'>-</span>%</div>
-    <div class='card' onclick="selectCell(4)">Total<div class='battery total-battery' id='battTot'></div><span id='tot'>-</span> V</div>
-  </div>
-  <canvas id='graph'></canvas>
-  <a href='/download'>📥 Baixar CSV</a>
-</div>
-<div id='paneSet' class='pane'>
-  <div class="setup-box">
-    <h3>⚙️ Calibração kDiv</h3>
-    <p>Digite tensões medidas (V):</p>
-    <div>🔋 C1 <input id='in0'> V</div>
-    <div>🔋 C2 <input id='in1'> V</div>
-    <div>🔋 C3 <input id='in2'> V</div>
-    <div>🔋 C4 <input id='in3'> V</div>
-    <button onclick='calib()'>✅ Calibrar</button>
-    <h3>🗑️ Logs</h3>
-    <button onclick='clearLog()'>🧹 Limpar logs</button>
-  </div>
-</div>
-<script>
-const tabMon=document.getElementById('tabMon'),tabSet=document.getElementById('tabSet');
-const paneMon=document.getElementById('paneMon'),paneSet=document.getElementById('paneSet');
-function show(p){paneMon.classList.toggle('active',p==='mon');paneSet.classList.toggle('active',p==='set');tabMon.classList.toggle('active',p==='mon');tabSet.classList.toggle('active',p==='set');}
-tabMon.onclick=()=>show('mon'); tabSet.onclick=()=>show('set');
-let selectedCell = 0;
-function selectCell(c){selectedCell = c; updateGraph();}
-const ctx = graph.getContext('2d');
-const chart = new Chart(ctx, {type:'line',data:{labels:[],datasets:[{label:'Célula',data:[],borderWidth:2,borderColor:'#2196F3',backgroundColor:'rgba(33, 150, 243, 0.2)',pointRadius:2}]},options:{animation:false,scales:{x:{display:false},y:{min:3,max:4.3}}}});
-const hist=[[],[],[],[],[]]; const labels=[]; const cells=4;
-let ws=new WebSocket('ws://'+location.hostname+'/ws');
-ws.onmessage=e=>{
-    const d=JSON.parse(e.data); 
-    const now = new Date().toLocaleTimeString(); 
-    labels.push(now); 
-    if(labels.length>60) labels.shift(); 
-    d.v.forEach((mv,i)=>{
-        const v=mv/1000; 
-        document.getElementById('v'+i).textContent = v.toFixed(3); 
-        const soc = d.soc[i];
-        document.getElementById('soc'+i).textContent = soc;
-        updateBattery('batt'+i, v, soc);
-        hist[i].push(v); 
-        if(hist[i].length>60) hist[i].shift();
-    }); 
-    const total=d.tot/1000; 
-    document.getElementById('tot').textContent=total.toFixed(3); 
-    updateBattery('battTot',total, null, true);
-    hist[4].push(total); 
-    if(hist[4].length>60) hist[4].shift(); 
-    updateGraph();
+// Gerado por tools/build_ui.py a partir de ui/. Não edite: altere as fontes e rode o script.
+
+/**
+ * Arquivo do dashboard comprimido com gzip, servido direto da flash.
+ */
+struct UiAsset {
+    const char    *path;        // URL
+    const char    *type;        // Content-Type
+    const uint8_t *gz;          // Conteúdo (gzip, PROGMEM)
+    size_t         len;
+    const char    *etag;        // ETag forte (hash do conteúdo)
+    bool           immutable;   // URL versionada: cache longo sem revalidar
+};
+
+static const uint8_t ui_index_gz[] PROGMEM = {
+    0x1f,0x8b,0x08,0x00,0x00,0x00,0x00,0x00,0x02,0x03,0x95,0x56,0xdb,0x8a,0xe3,0x36,0x18,0xbe,0xdf,0xa7,
+    0x50,0x67,0x28,0x4e,0x60,0xec,0x38,0x71,0x92,0xce,0x38,0x99,0x5c,0x74,0xa6,0x85,0xc2,0x96,0x2e,0xcc,
+    0x74,0xa1,0x97,0x8a,0x25,0xc7,0xda,0x71,0x2c,0x23,0x29,0x99,0x84,0x90,0xcb,0x5e,0x97,0xd2,0x8b,0xd2,
+    0x52,0x98,0x8b,0x52,0xf6,0x09,0x0a,0xed,0xf5,0xbc,0xc9,0xbe,0x40,0xe7,0x11,0xfa,0x4b,0xf2,0x31,0xc9,
+    0x52,0x8a,0x49,0x1c,0x49,0xff,0xe1,0xfb,0x4f,0x9f,0x32,0xfd,0xe4,0xf6,0x9b,0x9b,0xfb,0xef,0xde,0x7c,
+    0x81,0x12,0xb5,0x4c,0x67,0xaf,0xa6,0xe5,0x8b,0x62,0x02,0xaf,0x25,0x55,0x18,0x45,0x09,0x16,0x92,0xaa,
+    0x6b,0x67,0xa5,0x62,0xf7,0xd2,0x29,0xb7,0x33,0xbc,0xa4,0xd7,0xce,0x9a,0xd1,0xc7,0x9c,0x0b,0xe5,0xa0,
+    0x88,0x67,0x8a,0x66,0x20,0xf6,0xc8,0x88,0x4a,0xae,0x09,0x5d,0xb3,0x88,0xba,0x66,0x71,0x81,0x58,0xc6,
+    0x14,0xc3,0xa9,0x2b,0x23,0x9c,0xd2,0xeb,0xbe,0x36,0xa2,0x98,0x4a,0xe9,0xec,0x35,0x7b,0xc3,0xd1,0xd7,
+    0x1c,0x8e,0xb9,0x98,0xf6,0xec,0xde,0xab,0xa9,0x54,0x5b,0x78,0xcf,0x39,0xd9,0xee,0x62,0x30,0xeb,0xc6,
+    0x78,0xc9,0xd2,0x6d,0xe8,0xdc,0xd1,0x05,0xa7,0xe8,0xdb,0xaf,0x9c,0x0b,0x89,0x33,0xe9,0x4a,0x2a,0x58,
+    0x3c,0x99,0xe3,0xe8,0x61,0x21,0xf8,0x2a,0x23,0xe1,0x79,0x3c,0x84,0xe7,0x6a,0xb2,0xc4,0x62,0xc1,0xb2,
+    0xd0,0x47,0x78,0xa5,0x38,0xac,0x36,0x16,0x47,0xd8,0xf7,0x7d,0x3f,0xdf,0x4c,0x72,0x4c,0x08,0xcb,0x16,
+    0xe1,0x40,0x2f,0x22,0x9e,0x72,0x11,0x9e,0x07,0x41,0xb0,0x4f,0x06,0x3b,0x45,0x37,0xca,0xc5,0x29,0x5b,
+    0x64,0x61,0x04,0xd1,0x50,0xb1,0xf7,0x14,0x9e,0xcb,0xe3,0xfd,0xc2,0x87,0x3b,0xe7,0x4a,0xf1,0xa5,0x31,
+    0x65,0x45,0xd1,0x7c,0x05,0x3b,0xd9,0xae,0x86,0xe5,0x16,0x2e,0x06,0xfd,0xab,0xf1,0x97,0xc1,0x64,0xce,
+    0x05,0xa1,0x22,0xcc,0x78,0x46,0x0b,0xe7,0x8f,0x09,0x53,0xb4,0x42,0xd5,0x07,0x53,0xc8,0x40,0xab,0xc2,
+    0x18,0xc1,0xc2,0xaa,0xb9,0x02,0x13,0xb6,0x92,0xe1,0x58,0x23,0x5f,0x09,0x09,0xda,0x39,0x67,0x06,0x90,
+    0x12,0x90,0x13,0x48,0x33,0xcf,0xc2,0x43,0xdf,0xc8,0xf7,0x02,0xd9,0x82,0x17,0x26,0x7c,0x4d,0xc5,0x09,
+    0x90,0xfd,0xd1,0x78,0x14,0xf9,0x2d,0x59,0x0f,0x47,0x8a,0xad,0xe9,0x09,0x61,0x9f,0x0c,0x3f,0xc3,0xfd,
+    0xbd,0x97,0xe3,0x8c,0xee,0x08,0x93,0x79,0x8a,0xb7,0x26,0x30,0xbb,0x55,0x2a,0x96,0x27,0xf3,0x94,0x47,
+    0x0f,0x7b,0x2f,0xc2,0x82,0xc8,0x6a,0x33,0x4e,0xe9,0x66,0xb2,0xc0,0x79,0xd8,0x1f,0x40,0x4c,0x7a,0xe5,
+    0x3e,0x0a,0x58,0xea,0xaf,0xc9,0xbb,0x95,0x54,0x2c,0xde,0xba,0x45,0x73,0x55,0x35,0xd1,0x26,0x1a,0x78,
+    0x8a,0x0c,0xb6,0x53,0xd4,0x6f,0x96,0xda,0x18,0x2f,0x9a,0x60,0xe8,0x9b,0x74,0x6e,0x5c,0x99,0x60,0xc2,
+    0x1f,0x21,0xbf,0x43,0xc8,0xf8,0x25,0x7c,0xc4,0x62,0x8e,0x3b,0xfe,0x85,0x79,0xbc,0x7e,0x77,0x72,0x5c,
+    0xf5,0x8f,0xe7,0xdc,0xfc,0x8c,0xb9,0x58,0x42,0xb2,0x07,0xd2,0x42,0x2c,0xb2,0x5c,0x1d,0x85,0xa6,0xff,
+    0x3b,0x7d,0xcf,0x1f,0x75,0xf7,0xde,0x1c,0x2b,0xb0,0xb1,0xdd,0x59,0x58,0x23,0x8d,0x2a,0xa1,0x6c,0x91,
+    0x28,0xdd,0xa7,0x55,0xc5,0xc3,0x00,0x80,0x49,0x9e,0x32,0x82,0x74,0x93,0x9e,0xe8,0x83,0x9c,0x17,0x10,
+    0x04,0x4d,0xb1,0x4e,0x78,0xd9,0x38,0x3a,0x24,0x33,0x01,0x8d,0x4c,0xa5,0x2c,0xa3,0x58,0xb8,0x0b,0xad,
+    0x0f,0x21,0x75,0x14,0x47,0x8a,0xe7,0x17,0x6b,0x2c,0x3a,0xae,0xab,0x11,0xd9,0xda,0x76,0x91,0xdd,0x49,
+    0xe9,0x9a,0xa6,0xdd,0x8b,0x73,0x42,0x48,0x6b,0xa7,0x86,0x1f,0x86,0x73,0x0a,0xb1,0xd1,0x5d,0x59,0xa3,
+    0xb3,0xb3,0x1a,0x11,0x34,0x11,0x4f,0x57,0x50,0x1a,0xf0,0x11,0xba,0xa6,0x22,0x29,0x8d,0x21,0xc0,0x51,
+    0x55,0x8e,0x41,0x23,0x6e,0x1d,0x4d,0x73,0x9c,0x8f,0xe3,0x1d,0x98,0x31,0xe3,0x0a,0xb8,0xa4,0x4c,0x5f,
+    0x21,0x60,0xad,0x0d,0xf5,0xb9,0x4e,0xbd,0x87,0x53,0x2c,0x96,0xbb,0x56,0x99,0xf5,0xa3,0xb3,0x09,0x34,
+    0x31,0x0c,0x82,0xf1,0xde,0xca,0x48,0x44,0xd8,0x7a,0xd7,0x66,0x11,0x7d,0xdc,0x1a,0xce,0x13,0x59,0x2f,
+    0x3a,0xeb,0xb2,0x39,0xa8,0x3a,0xdb,0xc8,0x84,0x79,0x4c,0x24,0x11,0xce,0xd6,0x58,0xb6,0x87,0x61,0x52,
+    0xf1,0xd2,0xa7,0x55,0xed,0x2f,0xeb,0xd1,0x77,0x75,0xda,0x0c,0xb5,0xe0,0x4a,0x8f,0x65,0xba,0x84,0xae,
+    0x55,0x6f,0x88,0x99,0x0e,0x6f,0x33,0x8d,0xc1,0x40,0x68,0xc4,0x05,0x36,0xd5,0x30,0x93,0x89,0xcb,0xa6,
+    0x3c,0x38,0x84,0xc8,0xa9,0xd0,0xa6,0xf7,0x1e,0xb0,0xfd,0x2a,0x07,0x66,0xdb,0x1c,0x8f,0x58,0x8b,0x3a,
+    0x4f,0xcc,0xdb,0xd1,0x58,0x19,0x36,0x3b,0x9c,0xab,0x9a,0x91,0x47,0x7e,0x83,0xe8,0x74,0xf6,0x1a,0xde,
+    0x51,0x12,0xec,0x1a,0x01,0xfa,0xcd,0x23,0x96,0xe5,0x2b,0x55,0x4c,0xce,0xb8,0x39,0xe8,0xa3,0xda,0x5c,
+    0xcd,0x9a,0x61,0xbf,0x9e,0xa1,0x28,0x8a,0x0e,0x80,0x9b,0x9e,0xa9,0x4d,0xff,0x17,0x7f,0x1f,0xb7,0x85,
+    0xe5,0xf2,0x46,0x43,0xa0,0xfe,0xf8,0x24,0x63,0x37,0xe6,0xd2,0xff,0xff,0xf4,0x7d,0x08,0xf1,0xa3,0x1c,
+    0x5e,0xd0,0xf2,0xb4,0x67,0xef,0xd1,0x57,0xd3,0x5e,0x71,0x9f,0xeb,0x1b,0x55,0xdf,0xee,0x83,0x59,0x71,
+    0xe5,0x22,0x42,0xd1,0xe7,0x18,0xdc,0x33,0x2c,0x91,0xbe,0x8b,0x41,0x74,0x00,0x12,0x30,0x11,0x28,0x4a,
+    0xb1,0x94,0xd7,0x8e,0xbe,0x08,0xf4,0x7d,0x6d,0x7d,0x22,0x46,0xcc,0x16,0xe8,0x3b,0xa5,0x84,0x65,0x79,
+    0x67,0x56,0x5d,0xe3,0x56,0xf4,0x48,0xe7,0x8e,0x2a,0x67,0x76,0xa7,0x83,0x68,0x88,0xf4,0xc0,0x55,0xe1,
+    0x50,0x8b,0xe9,0x6b,0xa3,0x69,0x5b,0xaf,0x51,0xe9,0xa0,0x16,0xb3,0x83,0x5b,0x23,0xb0,0xcb,0x59,0xd3,
+    0x5a,0x71,0x64,0x2e,0x1b,0xc7,0x28,0xd9,0x9f,0xc7,0xc7,0xf5,0xe9,0x3d,0x07,0x84,0xf7,0x9a,0x5d,0x9a,
+    0x32,0x05,0xd1,0xa0,0x16,0xed,0x58,0x25,0xbd,0x30,0x4a,0xd6,0xf3,0x54,0x02,0x5e,0x1b,0xae,0xde,0x74,
+    0xa1,0x02,0xb0,0x31,0x43,0x6f,0x4b,0x60,0xc5,0xcb,0x52,0x81,0x11,0x04,0x22,0xce,0x13,0xad,0x6f,0xf7,
+    0xe0,0x10,0xa3,0x44,0xd0,0xf8,0xda,0xe9,0xc1,0x10,0x65,0x29,0xc7,0xc4,0x99,0xbd,0x3c,0xfd,0xf4,0x07,
+    0xd4,0x89,0x6d,0xb0,0x40,0x37,0x77,0x60,0x0d,0x9f,0xce,0x9c,0xce,0x70,0x33,0x73,0xed,0x60,0xcf,0xaa,
+    0x06,0x3a,0xd3,0x4d,0x10,0xcc,0x3e,0xfc,0xfa,0xcb,0x3f,0x7f,0xfd,0x80,0x6e,0x80,0xa6,0xe6,0x02,0x3f,
+    0xbf,0x7f,0xfe,0x9d,0xa3,0x87,0x5b,0xb6,0x86,0x26,0x08,0x40,0x22,0x9f,0xdd,0xb2,0x05,0x74,0x39,0x02,
+    0x5a,0x97,0xcf,0x7f,0x52,0x89,0x96,0x94,0x30,0x02,0xc0,0x3b,0x6f,0xbb,0xe1,0xb4,0x97,0x37,0xbc,0x9b,
+    0x79,0x6c,0x54,0xa0,0xa8,0x3c,0xcf,0xa2,0x94,0x45,0x0f,0x3a,0xbb,0xe0,0xa3,0xd3,0x75,0x66,0x1f,0x7e,
+    0xfb,0xbe,0x74,0xd8,0xec,0x14,0x70,0xf8,0xf2,0xf4,0xf3,0x8f,0x1a,0xce,0x6b,0xbe,0x90,0x05,0x82,0x23,
+    0x2b,0x29,0xdc,0x5d,0x70,0xae,0x0d,0xbd,0x3c,0xbd,0xff,0x1b,0x5a,0x76,0x99,0x43,0x4e,0x52,0xa3,0x72,
+    0xd8,0x53,0xc5,0x4b,0x46,0x82,0xe5,0x0a,0x49,0x11,0x41,0x4e,0x71,0x9e,0x7b,0x83,0x20,0x1e,0x52,0x3a,
+    0xbc,0x8a,0x2e,0xbd,0x77,0xd0,0x1a,0x84,0xc6,0x54,0x00,0x70,0x2b,0xa7,0xf5,0x8a,0x31,0xe9,0xd9,0x3f,
+    0xc3,0xff,0x02,0xe9,0xa9,0x69,0x71,0x24,0x0b,0x00,0x00,
 };
 
-function updateBattery(id, v, soc, isTotal=false){
-    let p;
-    if (isTotal) {
-        const cells = 4;
-        const min=3.2*cells, max=4.2*cells;
-        p = Math.max(0, Math.min(1, (v-min)/(max-min)));
-    } else {
-        p = soc / 100.0;
-    }
-    const b=document.getElementById(id);
-    b.style.setProperty('--level',(p*100)+'%');
-    let c;
-    const vpc=isTotal?v/4:v;
-    if(vpc>=3.7)c='#4caf50';else if(vpc>=3.5)c='#ffc107';else c='#f44336';
-    b.style.setProperty('--batt-color',c);
-}
-function updateGraph(){chart.data.labels=[...labels];const t=selectedCell===4,n=t?'Total':'C'+(selectedCell+1);chart.data.datasets[0].label=n+' (V)';chart.data.datasets[0].data=[...hist[selectedCell]];chart.options.scales.y=t?{min:3*cells,max:4.2*cells}:{min:3,max:4.3};chart.update();}
-function calib(){const v=[0,1,2,3].map(i=>parseFloat(document.getElementById('in'+i).value)*1000||0);const p=JSON.stringify({v});fetch('/api/calibrate',{method:'POST',headers:{'Content-Type':'application/json'},body:p}).then(r=>r.text()).then(t=>alert("Resposta: "+t)).catch(e=>alert("Erro: "+e));}
-function clearLog(){fetch('/api/clear_logs',{method:'POST'});}
-</script>
-</body>
-</html>
-)rawliteral";
+static const uint8_t ui_app_gz[] PROGMEM = {
+    0x1f,0x8b,0x08,0x00,0x00,0x00,0x00,0x00,0x02,0x03,0x8d,0x59,0x4d,0x72,0xe3,0xc6,0x15,0xde,0xeb,0x14,
+    0xed,0x5f,0x00,0x43,0x08,0xfc,0x91,0x2c,0xcf,0x90,0x02,0x55,0x1a,0x79,0x1c,0xc7,0x25,0xd9,0x53,0x23,
+    0x45,0x93,0x2a,0x95,0x6a,0xa6,0x09,0x34,0xc5,0xb6,0x40,0x00,0x01,0x40,0x52,0x34,0x85,0x13,0x64,0x91,
+    0x4d,0x56,0xd9,0x24,0xa9,0x2c,0x52,0xb9,0x41,0xf6,0x73,0x93,0x5c,0x20,0x39,0x42,0xbe,0xd7,0xdd,0x00,
+    0x41,0x0d,0x25,0xbb,0x6c,0x8b,0x40,0xbf,0xd7,0xaf,0xdf,0xff,0xfb,0x1a,0x0e,0x22,0x9e,0xe7,0xec,0x4c,
+    0xc6,0xf2,0x64,0xc2,0xb3,0x82,0xad,0x76,0x82,0x24,0xce,0x8b,0x6c,0x16,0x14,0x49,0x66,0x07,0x3c,0x9e,
+    0xf3,0xdc,0x65,0xc1,0xf8,0xc6,0x01,0xa9,0x98,0xc8,0xdc,0xd3,0x6b,0xcc,0x67,0xfa,0x61,0x60,0x56,0x8b,
+    0xbb,0x7a,0xc9,0xbb,0x11,0xc5,0x49,0x12,0x17,0xe2,0xae,0xb0,0xad,0x5e,0x68,0x39,0x86,0x27,0xe4,0x05,
+    0x27,0xa6,0xf1,0x8d,0x7a,0x34,0xab,0x49,0x5a,0x48,0x1c,0x69,0x08,0xd5,0xdb,0xfd,0x3d,0x5b,0xe5,0x01,
+    0x8f,0x44,0xde,0x67,0xab,0x25,0xfe,0x2b,0xcb,0x72,0xb0,0xb3,0x90,0x71,0x98,0x2c,0x3c,0x1e,0x86,0xaf,
+    0xe6,0x22,0x2e,0x4e,0x65,0x5e,0x88,0x58,0x64,0xb6,0x95,0x89,0x5c,0xfe,0x2c,0x2c,0x97,0xd9,0x0e,0xf3,
+    0x87,0x4c,0x09,0x9e,0xa5,0x38,0x45,0xd8,0x0e,0x8e,0x2f,0x77,0xaa,0x97,0xca,0x40,0x16,0xe0,0xc0,0x86,
+    0x3d,0xb0,0x51,0x59,0x50,0x19,0xe3,0xb2,0x30,0xcd,0xf0,0x6e,0x4e,0x0c,0xc5,0x5c,0x06,0xe2,0xb5,0xbc,
+    0x13,0xd1,0x1b,0x0e,0x0d,0x49,0xbf,0xee,0xc0,0x88,0x5a,0x90,0xee,0x5e,0x10,0x49,0xa8,0xf4,0x56,0x86,
+    0xc5,0xc4,0x65,0x93,0xc6,0xd2,0x77,0x42,0xde,0x4c,0x8a,0xc1,0x8e,0x1c,0x33,0x3b,0xf0,0x16,0xc4,0xc0,
+    0x3e,0xf1,0x7d,0x76,0xc6,0x8b,0x89,0x97,0x25,0xb3,0x38,0xb4,0x17,0xec,0x19,0x9d,0xe7,0x90,0xd8,0xc0,
+    0x9b,0xa8,0x0d,0x0f,0x79,0x26,0x86,0x47,0x99,0x60,0xc4,0x6c,0x15,0x02,0xb5,0x2a,0x11,0x5b,0x05,0x90,
+    0x3b,0x60,0xa1,0x97,0x8b,0xe2,0x22,0xe3,0x71,0x3e,0x4e,0xb2,0xa9,0x0d,0x82,0xcb,0x3a,0xea,0xdf,0xfa,
+    0x91,0x24,0x81,0x2f,0x88,0x04,0xcf,0xde,0x88,0xa0,0xb0,0x35,0x7d,0x01,0xf3,0x9c,0xca,0xf6,0x30,0xaf,
+    0x9c,0x46,0x21,0x55,0x7f,0x20,0x37,0xbf,0xea,0x5c,0xbb,0x6c,0x49,0xb4,0x50,0x53,0xf0,0x56,0x31,0x9a,
+    0x10,0x7b,0x3a,0xbc,0xde,0x52,0xc5,0x1a,0xc1,0x8d,0x44,0xc1,0xa2,0x04,0x5c,0x4b,0x6f,0x2a,0x63,0x1c,
+    0x22,0xf5,0x33,0xbf,0xd3,0xbe,0x23,0x1a,0x5c,0x02,0x53,0xc4,0x58,0xc6,0x22,0xa4,0x7d,0xc4,0xd3,0x5c,
+    0x23,0xe7,0x28,0x19,0xca,0x6e,0x88,0xb1,0x3d,0xcf,0x5b,0xe6,0x50,0x57,0x49,0xd3,0xab,0xfc,0xae,0x5e,
+    0x2d,0x95,0xe4,0x4f,0x6c,0x50,0x87,0x38,0x9c,0x9c,0x4b,0x3a,0xec,0xfa,0x88,0x2e,0x09,0x6f,0xa9,0x87,
+    0xd2,0x18,0x7b,0x0a,0x11,0xfb,0xfb,0x2e,0xbb,0xc0,0x6f,0xf7,0xb9,0xcb,0xde,0xe0,0xf7,0xc0,0x65,0x2f,
+    0xf5,0x4f,0x4a,0x79,0xb0,0x60,0xbb,0x60,0xdb,0x65,0x6f,0xf0,0x4e,0xf1,0x99,0xe0,0xf9,0x02,0xff,0xbd,
+    0xd4,0xbe,0x1c,0xa3,0x2c,0xb0,0x6a,0x75,0xbb,0xe9,0x1d,0xcb,0xe1,0xfc,0xdd,0x5c,0x64,0x72,0x6c,0x69,
+    0x6a,0x04,0x13,0xde,0x9a,0xc0,0x76,0xf5,0x12,0x4a,0x31,0xb9,0x15,0xe7,0xc5,0x32,0x12,0xb4,0xef,0x33,
+    0xd1,0xa1,0x7f,0x0c,0xff,0x58,0x46,0xd1,0x9a,0x74,0x70,0x70,0x60,0xd6,0xa9,0xf2,0x8e,0x23,0x79,0x13,
+    0xd3,0x7a,0x46,0x99,0xd0,0x20,0xbc,0x44,0x80,0xe8,0x20,0xa2,0x4d,0x65,0x18,0x46,0x02,0x44,0xe4,0x00,
+    0x1c,0x8c,0x00,0x90,0x97,0x3a,0x03,0xfc,0x1c,0xc2,0x54,0xfc,0xb6,0x5a,0xeb,0x92,0x49,0x29,0x84,0x17,
+    0xac,0x45,0x96,0xed,0xd2,0x9f,0x67,0xe0,0x6b,0x83,0x4d,0xc9,0x1e,0x89,0x1b,0x19,0xbf,0x86,0x83,0x6d,
+    0x93,0x37,0xd3,0x64,0x2e,0x2e,0x12,0xfb,0x14,0x9e,0x58,0x3a,0x6b,0x03,0x69,0x89,0x64,0x2c,0x1a,0xeb,
+    0xda,0xca,0x6a,0x23,0x99,0x75,0x41,0xcd,0x83,0x42,0xde,0x62,0x14,0x9c,0x5d,0x0a,0x4e,0x75,0x9e,0xe3,
+    0x15,0xc9,0xb7,0x28,0xc5,0xd0,0xee,0x39,0xae,0xf2,0xf6,0xbe,0x91,0x55,0x7e,0x6c,0x7e,0x80,0x0a,0x14,
+    0xd9,0x23,0xf6,0x17,0x49,0xba,0xd5,0x95,0x7b,0x7b,0x7b,0xd6,0x03,0x5d,0x90,0xc7,0x11,0x1f,0x89,0x88,
+    0xb2,0xce,0xb2,0xe8,0x58,0xb2,0x01,0xea,0xf4,0x5c,0xd6,0x73,0x74,0x86,0x2e,0xc1,0x23,0xe2,0x1b,0xc4,
+    0xef,0x10,0x6b,0x2c,0x13,0xc5,0x2c,0x8b,0x8d,0x85,0x7c,0x5e,0xdb,0xf7,0x91,0xa7,0x32,0x2a,0x2e,0xf8,
+    0xe9,0xc2,0xd5,0x6e,0x99,0xd4,0x95,0x27,0x53,0xbb,0x2e,0xb5,0x9c,0xfa,0x93,0x3a,0xb2,0x71,0xd0,0x2e,
+    0xeb,0xc2,0x07,0x39,0x45,0x06,0x01,0x69,0xaf,0x9d,0xb5,0xe5,0x28,0xec,0x42,0x9c,0x5f,0xf1,0x60,0x62,
+    0xdb,0x73,0x97,0x49,0xd5,0x2a,0xeb,0xe0,0x92,0x74,0x32,0x4a,0xc2,0xcd,0xf9,0x9d,0xfb,0x20,0xda,0xf6,
+    0xbc,0x8e,0x41,0xbe,0xd4,0xd6,0x62,0x7f,0x23,0xa6,0xe9,0x9d,0x8e,0x01,0x13,0x51,0x2e,0x58,0x23,0xfe,
+    0x15,0x61,0xa7,0x74,0xb6,0xa5,0x34,0xfc,0x3a,0x4a,0xb2,0x50,0x64,0x27,0x49,0x84,0x24,0x24,0xef,0x7e,
+    0xd6,0xeb,0xbe,0x38,0xf8,0x76,0x6f,0x4b,0x51,0xd4,0xcc,0x7a,0x01,0xcc,0xbd,0x35,0xd3,0xf7,0x89,0xd4,
+    0x09,0x4f,0xdd,0xce,0xda,0x96,0x58,0x98,0x12,0x98,0x6a,0xea,0xb5,0xdc,0xa9,0x8a,0xba,0xe0,0xa3,0xb3,
+    0x24,0xf6,0xc3,0x24,0x98,0x4d,0x91,0x2b,0x34,0xbc,0x5e,0x45,0x82,0x1e,0x5f,0x2e,0x7f,0x1b,0xda,0x96,
+    0xa6,0x5b,0x8e,0x8b,0x87,0x73,0x51,0x3c,0xc9,0x08,0xba,0x55,0xc7,0x2b,0xe5,0xb1,0x78,0x52,0xb2,0x61,
+    0x80,0x68,0x7a,0x7a,0x52,0xb6,0x61,0x20,0xe1,0xe3,0x59,0x1c,0x50,0x03,0x65,0xf9,0x24,0x59,0xd8,0xa9,
+    0xb3,0x32,0x62,0x90,0x2d,0x18,0xe5,0x34,0x12,0x51,0x1e,0x37,0x37,0x91,0xb0,0x2d,0x0e,0xc6,0x39,0xa6,
+    0x62,0x8a,0x1e,0x69,0x4d,0xe9,0xa4,0x81,0x11,0xf4,0x4b,0xcc,0xb9,0x3a,0x4b,0x9b,0xfe,0xeb,0x04,0x6b,
+    0xeb,0x7f,0x9d,0xdc,0x72,0xc7,0x48,0x4e,0x62,0xa4,0x78,0x70,0xeb,0xdb,0x8e,0x3f,0x54,0xe6,0x18,0x61,
+    0xcc,0x48,0xfb,0x98,0xae,0x05,0xa8,0x59,0x81,0x32,0x46,0xdd,0x88,0xf0,0x44,0x44,0x91,0xea,0x5a,0x0d,
+    0xd7,0x28,0x12,0x11,0xec,0xc0,0x59,0x3d,0x60,0x0c,0x06,0x4c,0xa3,0x81,0xdf,0x64,0x3c,0xa5,0xc2,0x28,
+    0x95,0xb8,0x00,0xd4,0xdc,0xef,0xd0,0xdc,0xc9,0x0b,0xff,0xea,0xba,0x21,0x6e,0x34,0x93,0x51,0x68,0xc7,
+    0xce,0x0a,0x79,0x6f,0xc7,0xb0,0x43,0xf1,0x36,0x0a,0x5c,0x6d,0x8d,0x07,0x7a,0xeb,0x71,0x96,0xf1,0xa5,
+    0x37,0xce,0x92,0xa9,0xbd,0xd2,0x55,0xda,0x8f,0x5b,0xdd,0xd2,0x25,0x23,0xae,0xae,0x61,0x9c,0xea,0x23,
+    0x55,0x05,0xfb,0xe8,0xb6,0x4d,0x05,0xf1,0x5e,0x21,0x14,0x9e,0x85,0xf9,0xe3,0x29,0xa1,0xc8,0xc8,0x1d,
+    0x56,0x24,0xc5,0xd3,0x5c,0x17,0x89,0xce,0x4a,0xda,0xe0,0xfd,0x61,0x26,0xb2,0xe5,0xb9,0x3a,0x30,0xc9,
+    0x8e,0xe1,0x20,0xcb,0x23,0xf5,0x2d,0xa7,0xee,0x0d,0xc2,0x1f,0x0a,0x94,0x0a,0x95,0xaf,0x02,0x4f,0x6a,
+    0x2c,0xc4,0xa9,0x6f,0xe9,0x39,0xa1,0xc7,0x04,0xd4,0x94,0x87,0xf1,0x80,0xe6,0x43,0x8d,0xa8,0xd6,0x5a,
+    0x04,0x99,0x80,0x7f,0x8d,0x22,0xb6,0x15,0xca,0xb9,0x52,0x40,0x67,0xc7,0x0f,0x7c,0x2a,0x7c,0xa5,0x98,
+    0xf2,0xb9,0x35,0x00,0xe4,0xd9,0x08,0xf4,0x3a,0x78,0x52,0xed,0x92,0x31,0x30,0xde,0x77,0x17,0x67,0xa7,
+    0xfe,0xfb,0x93,0xcf,0x57,0x12,0xbe,0x3c,0x84,0x44,0xa6,0x84,0xf9,0xd6,0x88,0x17,0x68,0xf0,0x4b,0x8b,
+    0xc9,0x50,0xbf,0x80,0xa5,0xb4,0x86,0x87,0x6d,0xf0,0x0c,0x0f,0x73,0x24,0xbc,0xa2,0xcc,0xf5,0xf2,0xee,
+    0x61,0x9b,0x96,0x86,0xec,0x92,0xdd,0xb3,0x35,0x35,0x4f,0x82,0x4d,0xfa,0x17,0xef,0x2b,0x87,0xc9,0x18,
+    0x23,0xba,0x78,0x29,0xc6,0xd4,0x39,0x02,0x17,0xde,0xa6,0x6e,0x1f,0xa7,0x2d,0xff,0x3d,0xa9,0x31,0xfc,
+    0xdf,0x5f,0xff,0xfc,0x47,0x66,0xf4,0x62,0x87,0x20,0xcc,0x0a,0x25,0x52,0xc6,0x5a,0x22,0xbb,0xd4,0xaa,
+    0xbc,0xa7,0xa6,0x83,0xdd,0x8f,0xd9,0x1a,0x43,0xec,0xa3,0x61,0x54,0x62,0x11,0xed,0x86,0x2f,0xb0,0x34,
+    0xd8,0xc9,0x04,0x90,0x0f,0xc2,0xc8,0xb3,0x69,0xae,0xdb,0x9a,0x8e,0xc5,0xf1,0xe9,0xf1,0x9b,0xb3,0x77,
+    0x3f,0x1c,0x9f,0xbd,0x3a,0xf7,0x57,0xe4,0xe5,0x77,0x04,0x91,0xb2,0xbe,0x75,0x3e,0x1b,0x01,0x32,0xe7,
+    0x1f,0xfe,0x91,0x58,0xae,0x5a,0x47,0x94,0x69,0x39,0x19,0x21,0x99,0x2b,0x82,0x9c,0x8e,0x78,0xc4,0xe3,
+    0x40,0xf4,0xad,0x6f,0x44,0x6e,0x9e,0x39,0x69,0x03,0x62,0x38,0x0f,0x8b,0xbe,0x75,0xc9,0x33,0xc9,0x3f,
+    0xfc,0x13,0xec,0x2c,0xfb,0xf0,0xf7,0x54,0x86,0x1c,0x15,0xce,0x83,0xdb,0xea,0x9c,0xd7,0x78,0x66,0x23,
+    0x2e,0xef,0x12,0xb3,0xae,0xcf,0x51,0xcb,0x3c,0x82,0x9c,0xb2,0x4a,0x73,0xae,0x94,0xf7,0x63,0xb1,0x00,
+    0x3c,0x53,0xe3,0xae,0xae,0x3b,0x45,0x52,0x48,0xdf,0xe6,0x75,0x9a,0xdd,0x8a,0xa5,0xcf,0xbd,0x5b,0xe0,
+    0x72,0x74,0x77,0x5c,0x59,0xf2,0xb7,0x12,0xe3,0xcd,0x52,0xc6,0x58,0xce,0x91,0x26,0xb5,0xb8,0xca,0xea,
+    0xbe,0x7e,0xa3,0x79,0x65,0x73,0x4f,0x77,0x22,0xc7,0x9c,0x48,0xf8,0xd7,0x86,0x30,0x97,0x57,0x43,0xcb,
+    0xac,0x87,0x88,0x09,0xae,0x0a,0x20,0x39,0xdb,0x1c,0x5c,0x6b,0xb7,0x49,0xaa,0xd4,0x8b,0x54,0xf7,0x00,
+    0xbe,0x34,0xd2,0xe6,0x3c,0x9a,0x09,0xd0,0xaf,0x9f,0x88,0xae,0x66,0xdd,0x88,0x2e,0x89,0x01,0x52,0x4d,
+    0x6d,0xee,0x0f,0x77,0x74,0xa2,0xfd,0xe7,0x2f,0x7f,0xfb,0xef,0xbf,0xff,0xc4,0x3e,0x5f,0x35,0x82,0x7b,
+    0xa5,0x0d,0xbc,0xbe,0xbf,0xd7,0x0f,0xe5,0xe7,0x2b,0x6d,0x39,0x9a,0x54,0x0d,0x8a,0x8f,0x2c,0xab,0x6f,
+    0xb1,0x13,0xab,0x65,0x6b,0x5a,0xab,0xeb,0x94,0x7d,0x46,0x9c,0x4a,0xb9,0x52,0x3d,0xd2,0x6e,0xea,0xd0,
+    0x14,0x5e,0xeb,0xc8,0x9a,0x5e,0xb6,0x73,0xec,0x9a,0x5e,0x5a,0x25,0x0b,0x45,0x1e,0x0a,0x30,0x51,0x88,
+    0xbe,0xa1,0x5b,0x14,0xf7,0x0a,0xc2,0x60,0xa7,0x09,0x21,0xf8,0x0b,0x39,0xc5,0x30,0xcf,0x64,0x7c,0x63,
+    0x3b,0xa5,0x49,0x75,0xc7,0xfb,0x09,0xc3,0xd8,0xb6,0xac,0x66,0x4e,0x6f,0xeb,0x3c,0xa8,0xb0,0x87,0xed,
+    0x07,0x35,0x26,0x51,0x19,0xc1,0xb6,0x51,0x42,0x7e,0xb2,0x5c,0xe5,0x9b,0x3c,0x99,0x0a,0x72,0xce,0xe3,
+    0xa9,0xf0,0xe5,0x97,0xb5,0x2b,0xa4,0xe3,0x34,0x8a,0x23,0x50,0x37,0x5d,0x9f,0xa9,0x94,0xab,0x6e,0xbe,
+    0xf6,0xa3,0xd1,0xb9,0xa1,0x31,0x41,0x8d,0x76,0x45,0x17,0x99,0xfe,0x4a,0xb7,0xef,0xfe,0xd5,0xb5,0x5b,
+    0xdd,0x76,0xfa,0x57,0x7a,0xb1,0x6f,0x9d,0x7c,0xf8,0x57,0x34,0x8b,0x50,0x0b,0x8a,0x15,0x2c,0x0d,0xb8,
+    0xd2,0xef,0xb9,0x0d,0xa4,0xd3,0xaf,0x61,0x4e,0x79,0x5d,0xba,0xe6,0x4e,0xd4,0xaf,0xee,0xbc,0xb8,0xf2,
+    0xae,0x70,0x7b,0xe9,0xef,0xb9,0xb8,0xad,0xf4,0xf7,0xbd,0x3d,0x5c,0x7f,0xcb,0x1a,0x59,0x68,0x0d,0x68,
+    0x46,0x31,0xbd,0x70,0x76,0xfc,0xfb,0x77,0xaf,0x2f,0xce,0xfd,0x83,0x4e,0x47,0xf7,0xeb,0x85,0x2e,0xa8,
+    0xb7,0x62,0x74,0x9e,0x04,0xb7,0x48,0x74,0x6b,0x91,0xf7,0xdb,0x6d,0xab,0x15,0x21,0x66,0x74,0x94,0x37,
+    0x49,0xf2,0x22,0x46,0x4d,0xb7,0xac,0xf6,0x22,0xa7,0x38,0x2d,0x80,0xad,0x64,0xcc,0xb3,0xe5,0xc5,0x32,
+    0x45,0x7f,0xe6,0x34,0xc5,0x46,0xb3,0xf1,0x58,0x81,0x67,0x10,0x93,0x38,0x49,0x45,0xac,0xba,0xd6,0x8a,
+    0xde,0x73,0xa4,0xbf,0xfd,0xfd,0xf9,0x8f,0x3f,0x10,0xc8,0x42,0xf4,0xe5,0x78,0x69,0xaf,0xc6,0x53,0xf4,
+    0x06,0x88,0xb1,0xdc,0xc9,0xcf,0xfd,0x4e,0x49,0x5e,0x1f,0x8b,0x02,0x51,0xb5,0xda,0x3c,0x95,0x6d,0x9d,
+    0xe8,0x47,0xb1,0xdf,0x41,0xc0,0x8b,0x89,0x88,0xed,0xcc,0x1f,0x66,0xde,0x4f,0x79,0x12,0x63,0xd4,0xe8,
+    0x95,0x10,0xf2,0x4d,0xed,0xa8,0x9b,0x27,0xaa,0x2e,0x34,0xa5,0x5b,0xe7,0xc8,0xba,0x31,0x38,0x83,0x07,
+    0x15,0x5a,0x3a,0xc8,0x2a,0x3a,0x51,0x29,0x4a,0x3e,0x2b,0x9b,0x1d,0x25,0x0c,0xcf,0xf9,0x34,0x45,0x32,
+    0x4d,0x73,0x77,0x3a,0x77,0xd1,0xf7,0x55,0x47,0xc7,0xad,0x51,0x0f,0xe5,0x74,0x96,0x4f,0xec,0x3a,0xd1,
+    0xa7,0xf9,0xf6,0x3c,0x57,0x78,0xdf,0xde,0x98,0xe3,0x43,0x13,0x03,0xa7,0x1a,0xef,0xf9,0x44,0x8e,0x0b,
+    0x6a,0x19,0xd3,0xf9,0x3a,0xb7,0xa7,0x2a,0xb7,0xab,0x5e,0x31,0xf7,0xa7,0xed,0x6e,0x87,0x62,0xf6,0x68,
+    0xf2,0xcd,0xad,0x96,0x74,0xd4,0xbd,0x45,0x7d,0x51,0x51,0xb7,0xc7,0x79,0x7d,0xff,0xd9,0x7b,0x6a,0x66,
+    0xc0,0xb6,0x2d,0x9b,0xb1,0x7a,0x25,0xd1,0x8c,0x34,0x04,0x7a,0xa9,0x87,0xa7,0xad,0x06,0x27,0xb8,0x5d,
+    0x86,0x8b,0x81,0x66,0x51,0x77,0xe6,0xbc,0xc0,0x93,0x76,0xca,0x5c,0x1b,0x5d,0xad,0x3d,0xb4,0xba,0x5a,
+    0xaf,0xcd,0x5e,0xa7,0x2b,0x1c,0xcc,0x23,0x1f,0x7f,0x7f,0xc9,0xd8,0x82,0x80,0x4a,0x53,0x5f,0x5f,0x6d,
+    0xdd,0x30,0x77,0x8b,0xde,0x84,0x6f,0x5c,0xc5,0xe9,0xb2,0x78,0x16,0xe1,0x6f,0x91,0xcd,0x44,0xa5,0xbf,
+    0x02,0x67,0xc6,0x06,0xc5,0xd4,0xb0,0xc3,0xd0,0xb6,0xda,0x62,0x68,0x6b,0x7b,0x74,0x11,0x4c,0x45,0x9e,
+    0xf3,0x1b,0xe1,0x0b,0x0a,0x23,0xe4,0x14,0xa8,0x96,0x64,0xcc,0x84,0xfa,0xca,0xa1,0x20,0xae,0xca,0x11,
+    0xab,0x1e,0x08,0xa1,0xaf,0x8a,0x24,0xe5,0x59,0x2e,0x6c,0xcd,0xa6,0x35,0x08,0x3d,0xda,0x4b,0x5b,0x74,
+    0x5f,0x73,0x56,0xcd,0x81,0x17,0x62,0x2a,0x19,0x7c,0xc9,0xca,0x1d,0x8d,0x40,0x43,0x6f,0x6e,0x74,0x85,
+    0x84,0x75,0x2a,0x53,0xaa,0x7a,0x31,0xd0,0x31,0x7a,0x14,0x58,0xe8,0x0f,0xe5,0x35,0x7e,0x34,0x58,0x29,
+    0xf5,0x78,0xab,0x15,0x9a,0xfb,0x26,0xc1,0xf9,0xa5,0x14,0x8b,0x4a,0x27,0x97,0x00,0xdc,0x9c,0x62,0xf2,
+    0x3b,0x19,0x17,0xcf,0x6d,0xba,0x57,0xc6,0x8d,0x95,0xee,0x81,0xdd,0x73,0x95,0x63,0x71,0x75,0x0c,0xef,
+    0xd4,0x8c,0x53,0x50,0x17,0x10,0xdb,0xc3,0xb0,0xd4,0x33,0x4e,0x2b,0x1a,0x18,0x0b,0x1b,0xe2,0x3a,0x0e,
+    0x2c,0xed,0xc1,0xc6,0x8f,0xd0,0x2f,0x79,0xbb,0xae,0x90,0x89,0x3f,0x9c,0xd4,0x34,0x87,0x4c,0xaf,0x20,
+    0xe7,0x2d,0xb0,0x79,0xe2,0xef,0x0f,0x6e,0x01,0x3b,0x6f,0x5b,0x2d,0x37,0x69,0xf9,0xdd,0x5e,0x6b,0xef,
+    0x59,0x50,0x7b,0x1a,0x28,0x62,0x7d,0xe2,0x5e,0xcf,0x4e,0xb4,0xba,0xad,0xcd,0xc5,0xd6,0xbe,0x5e,0x7e,
+    0xb6,0xdf,0x7b,0xb1,0xff,0xe2,0xe0,0xeb,0xde,0x8b,0x83,0x2a,0x51,0xa7,0x73,0x1f,0x96,0xa9,0xb1,0x2b,
+    0xfd,0xe1,0x86,0xe9,0x49,0xeb,0x79,0xab,0xf7,0x4c,0xea,0xad,0xeb,0x2b,0x79,0x12,0x6c,0xdf,0xf1,0xdc,
+    0x6c,0x08,0x50,0x80,0x1b,0xb1,0x42,0xdb,0xc1,0x31,0xaa,0xc6,0x10,0xa0,0x87,0x27,0xc0,0x9a,0xfa,0x84,
+    0xb2,0xfe,0x6a,0x59,0xdd,0x53,0x36,0x3a,0xd9,0x66,0x1d,0xc8,0xb0,0xaa,0x5c,0x04,0x27,0xbf,0x50,0x05,
+    0x37,0xe6,0x88,0x3a,0x75,0x36,0x38,0x2f,0x35,0x57,0x76,0x4d,0x5a,0x7f,0xd2,0xc1,0x8c,0xf1,0xf7,0x3c,
+    0xe8,0x49,0xc9,0x0e,0xcd,0xf8,0x9d,0xbf,0x5f,0xbd,0x0e,0x76,0xd2,0xe6,0x27,0x33,0xdc,0x8c,0xea,0x8f,
+    0x6a,0x5d,0x97,0xd9,0xf3,0x5d,0x3c,0x39,0x6d,0x1b,0x34,0xf5,0xe4,0x34,0x33,0x2d,0xd5,0x9d,0x86,0xb5,
+    0x19,0x4a,0xde,0xeb,0xac,0x67,0xef,0xe8,0xd1,0xab,0x8a,0x44,0xc6,0xef,0x8c,0x30,0x4c,0x96,0x91,0x20,
+    0x6c,0xf6,0x3a,0xc3,0xbc,0xc9,0x0a,0xd4,0xf8,0xee,0x6e,0x24,0xe6,0x22,0xb2,0x5c,0x3b,0x7d,0x06,0x71,
+    0x4e,0xcb,0xfa,0xa2,0xba,0x03,0x06,0x55,0x24,0xe6,0x29,0x22,0xa1,0xad,0x3b,0x9a,0xb7,0x95,0xfe,0xfd,
+    0xb9,0x4a,0x42,0x50,0x86,0xb0,0xf1,0x6b,0x27,0xf0,0xad,0xcf,0xf6,0x03,0x3e,0xfe,0xaa,0x63,0x0d,0x94,
+    0x9a,0x6b,0xe2,0x57,0x8a,0x38,0x1e,0x07,0xdd,0xce,0xd7,0x86,0xa8,0x16,0xf6,0xf7,0xf7,0xf6,0xe8,0xa3,
+    0xda,0x23,0x6a,0x51,0xf3,0xd9,0x0d,0x68,0x9a,0x03,0x4c,0x6f,0x82,0xc3,0x8d,0xc8,0xad,0x14,0xe2,0xd0,
+    0x5f,0x48,0xab,0xd9,0x8d,0xea,0xd1,0x8f,0xd7,0x03,0xd3,0x25,0xfd,0x8d,0x6b,0xa0,0xb9,0x64,0xba,0xb1,
+    0x5f,0x1c,0x59,0xca,0x2e,0xc0,0x31,0xc2,0x70,0x4d,0x2e,0x20,0xb9,0x41,0x43,0x76,0xe3,0xeb,0xab,0x16,
+    0xee,0xc7,0x2d,0x8b,0xd9,0x97,0x8e,0xf5,0x18,0x97,0x6a,0x5a,0xa4,0x8b,0x6a,0x79,0x4d,0xd1,0xd7,0xd7,
+    0x66,0xcf,0xc3,0xcf,0xb5,0xd0,0x47,0x43,0x13,0x93,0x34,0x1a,0xa0,0x98,0x9c,0x29,0x1f,0xc2,0x16,0x23,
+    0xa4,0xfa,0xfc,0x3e,0x68,0xb8,0x08,0xf2,0xe4,0x88,0x9c,0x63,0x66,0x61,0xa3,0xa1,0xa8,0xeb,0x75,0xd5,
+    0x54,0xaa,0xea,0x52,0x1d,0xf4,0xdb,0x28,0xe1,0x4f,0x60,0x35,0x20,0x0f,0x1a,0x79,0x0a,0xd7,0x3a,0x94,
+    0x2c,0x9d,0xfb,0x7b,0xb4,0x11,0xf3,0x41,0xc6,0x7f,0x08,0x57,0xe6,0x65,0x45,0x0b,0x93,0x58,0xf8,0x0a,
+    0x8c,0xa8,0xff,0x6d,0x61,0xb0,0x48,0x01,0x7c,0x19,0x21,0xda,0xf6,0xa7,0x6f,0x44,0x9e,0x02,0x31,0xf1,
+    0x3e,0xfb,0xb4,0x55,0x38,0xb5,0xc4,0x04,0x91,0x22,0xa0,0xd1,0x04,0x39,0xca,0xae,0x0c,0xe6,0x6e,0x60,
+    0x1c,0xec,0x2d,0x66,0x39,0xf5,0xc0,0x4e,0xef,0x88,0xfa,0x2f,0x12,0x69,0x2a,0x31,0x12,0x92,0x5b,0xba,
+    0x06,0x16,0x04,0x2f,0x92,0x59,0x81,0x57,0xf7,0x2b,0xe4,0xb8,0xd9,0x4a,0x07,0x38,0x7d,0x52,0xce,0xce,
+    0x70,0xea,0xf6,0x63,0xdc,0xd5,0x54,0x14,0x93,0x24,0xc4,0xf5,0xea,0xc7,0xf3,0x0b,0x40,0x2f,0xc1,0x81,
+    0x88,0x00,0x22,0x2d,0x33,0x46,0x77,0x09,0xd2,0x21,0x7d,0x78,0x9a,0xe2,0xe6,0xa9,0xf0,0x5f,0x9b,0x30,
+    0x97,0x55,0x02,0x91,0x86,0xcb,0x7e,0x5a,0x3e,0xaa,0x29,0x29,0x60,0xaf,0x35,0x30,0xd8,0x4a,0xd4,0x7e,
+    0x79,0x95,0x65,0x09,0xf9,0x84,0x5a,0x56,0x33,0xb6,0x84,0xdc,0x4e,0x13,0x40,0xa5,0xd5,0x86,0xce,0xb4,
+    0xfc,0x2e,0x4a,0x6e,0xf2,0x87,0x4a,0x97,0xb4,0xfd,0xff,0xcf,0xf8,0xd6,0x72,0x8d,0x1a,0x00,0x00,
+};
+
+static const UiAsset UI_ASSETS[] = {
+    {"/", "text/html", ui_index_gz, sizeof(ui_index_gz), "\"4c9164079b2fb32c\"", false},
+    {"/app.23f4ee49c8.js", "application/javascript", ui_app_gz, sizeof(ui_app_gz), "\"23f4ee49c8b646dc\"", true},
+};
@@ -0,0 +1,32 @@
+#include "ws_frame.h"
+
+void WSF_putHeader(uint8_t *out, uint8_t type, uint16_t count) {
+    WsFrameHeader h = {type, PACK_CELLS, count};
+    memcpy(out, &h, sizeof(h));
+}
+
+size_t WSF_putSamples(uint8_t *out, const CellSample *s, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        WsSample w;
+        w.epochMs = s[i].epochMs;
+        memcpy(w.mv, s[i].mv, sizeof(w.mv));
+        memcpy(w.soc, s[i].soc, sizeof(w.soc));
+        w.total = s[i].total;
+        w.flags = s[i].flags;
+        w.reserved = 0;
+        memcpy(out + i * sizeof(w), &w, sizeof(w));
+    }
+    return n * sizeof(WsSample);
+}
+
+size_t WSF_json(char *out, size_t cap, const CellSample &s) {
+    time_t secs = (time_t)(s.epochMs / 1000);
+    struct tm tm;
+    localtime_r(&secs, &tm);
+    int n = snprintf(out, cap, "{\"t\":\"%02d:%02d:%02d\",\"v\":[", tm.tm_hour, tm.tm_min, tm.tm_sec);
+    for (uint8_t i = 0; i < PACK_CELLS; i++) n += snprintf(out + n, cap - n, i ? ",%u" : "%u", s.mv[i]);
+    n += snprintf(out + n, cap - n, "],\"soc\":[");
+    for (uint8_t i = 0; i < PACK_CELLS; i++) n += snprintf(out + n, cap - n, i ? ",%u" : "%u", s.soc[i]);
+    n += snprintf(out + n, cap - n, "],\"tot\":%u}", s.total);
+    return (size_t)n < cap ? (size_t)n : cap - 1;
+}
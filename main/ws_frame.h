@@ -0,0 +1,67 @@
+#pragma once
+#include "ads_driver.h"
+
+/**
+ * Quadros do WebSocket do dashboard, montados em buffers do chamador.
+ *
+ * Binário (little-endian): WsFrameHeader seguido de 'count' WsSample.
+ * JSON: {"t":"HH:MM:SS","v":[mV...],"soc":[%...],"tot":mV}, o formato
+ * original do dashboard.
+ *
+ * Não depende do servidor web, então a montagem dos quadros roda também na
+ * bancada de host.
+ */
+
+static constexpr uint8_t WS_FRAME_LIVE = 1;       // Amostras novas desde o último quadro
+static constexpr uint8_t WS_FRAME_BACKFILL = 2;   // Anel de amostras recentes, enviado quando o cliente pede binário
+
+struct __attribute__((packed)) WsFrameHeader {
+    uint8_t  type;     // WS_FRAME_*
+    uint8_t  cells;    // Células por amostra
+    uint16_t count;    // Amostras no quadro
+};
+
+// 12 + 3 x células bytes (24 com 4 células); o cliente tira o passo de 'cells'.
+struct __attribute__((packed)) WsSample {
+    uint64_t epochMs;
+    uint16_t mv[PACK_CELLS];
+    uint8_t  soc[PACK_CELLS];
+    uint16_t total;
+    uint8_t  flags;
+    uint8_t  reserved;
+};
+static_assert(sizeof(WsSample) == 12 + 3 * PACK_CELLS, "WsSample sem preenchimento");
+
+// Maior mensagem JSON: hora + 5 dígitos de mV e 3 de SoC por célula + total.
+static constexpr size_t WS_JSON_MAX = 48 + 10 * PACK_CELLS;
+
+/** Tamanho de um quadro binário com 'count' amostras. */
+constexpr size_t WSF_binarySize(uint16_t count) {
+    return sizeof(WsFrameHeader) + (size_t)count * sizeof(WsSample);
+}
+
+/**
+ * Escreve o cabeçalho de um quadro binário.
+ * @param out Início do quadro (sizeof(WsFrameHeader) bytes).
+ * @param type WS_FRAME_*.
+ * @param count Amostras que seguem o cabeçalho.
+ */
+void WSF_putHeader(uint8_t *out, uint8_t type, uint16_t count);
+
+/**
+ * Empacota amostras no formato WsSample.
+ * @param out Destino (n x sizeof(WsSample) bytes).
+ * @param s Amostras.
+ * @param n Quantas.
+ * @return Bytes escritos.
+ */
+size_t WSF_putSamples(uint8_t *out, const CellSample *s, size_t n);
+
+/**
+ * Mensagem JSON de uma amostra (hora local do timestamp).
+ * @param out Destino.
+ * @param cap Capacidade (WS_JSON_MAX basta).
+ * @param s Amostra.
+ * @return Tamanho da mensagem, sem o terminador.
+ */
+size_t WSF_json(char *out, size_t cap, const CellSample &s);
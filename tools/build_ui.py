@@ -0,0 +1,109 @@
+#!/usr/bin/env python3
+"""Gera main/web_ui.h a partir das fontes do dashboard em ui/.
+
+A página (ui/index.html, com o CSS embutido) e o script (ui/chart.js +
+ui/app.js, concatenados) são minificados de forma conservadora, comprimidos
+com gzip e gravados como arrays em PROGMEM, cada um com o ETag forte tirado
+do hash do conteúdo. O script vai para /app.<hash>.js: o nome muda a cada
+versão, então ele pode ficar em cache por um ano; a página em "/" é sempre
+revalidada (304 enquanto o firmware não mudar).
+
+Rode depois de editar qualquer arquivo de ui/ e versione o web_ui.h gerado
+(a IDE do Arduino não executa etapas de build):
+
+    python3 tools/build_ui.py
+"""
+import gzip
+import hashlib
+import pathlib
+import re
+import sys
+
+ROOT = pathlib.Path(__file__).resolve().parent.parent
+UI = ROOT / "ui"
+OUT = ROOT / "main" / "web_ui.h"
+SCRIPTS = ["chart.js", "app.js"]   # Ordem de concatenação do /app.<hash>.js
+
+
+def minify_js(src):
+    # Só remove o que é seguro sem um parser: indentação, linhas em branco e
+    # linhas inteiras de comentário. As quebras de linha ficam (ASI).
+    out = []
+    for line in src.splitlines():
+        line = line.strip()
+        if not line or line.startswith("//"):
+            continue
+        out.append(line)
+    return "\n".join(out) + "\n"
+
+
+def minify_css(src):
+    src = re.sub(r"/\*.*?\*/", "", src, flags=re.S)
+    src = re.sub(r"\s+", " ", src)
+    src = re.sub(r"\s*([{};:,>])\s*", r"\1", src)
+    return src.replace(";}", "}").strip()
+
+
+def minify_html(src):
+    src = re.sub(r"<!--.*?-->", "", src, flags=re.S)
+    src = re.sub(r"<style>(.*?)</style>",
+                 lambda m: "<style>" + minify_css(m.group(1)) + "</style>", src, flags=re.S)
+    return "\n".join(l.strip() for l in src.splitlines() if l.strip()) + "\n"
+
+
+def c_array(name, data):
+    rows = []
+    for i in range(0, len(data), 20):
+        rows.append("    " + ",".join("0x%02x" % b for b in data[i:i + 20]) + ",")
+    return "static const uint8_t %s[] PROGMEM = {\n%s\n};\n" % (name, "\n".join(rows))
+
+
+def asset(text):
+    raw = text.encode("utf-8")
+    # mtime=0: a mesma fonte gera sempre os mesmos bytes (diffs limpos no web_ui.h).
+    gz = gzip.compress(raw, compresslevel=9, mtime=0)
+    return raw, gz, hashlib.sha256(raw).hexdigest()
+
+
+def main():
+    js = "".join(minify_js((UI / f).read_text(encoding="utf-8")) for f in SCRIPTS)
+    js_raw, js_gz, js_hash = asset(js)
+    js_path = "/app.%s.js" % js_hash[:10]
+
+    page = (UI / "index.html").read_text(encoding="utf-8")
+    if "src='app.js'" not in page:
+        sys.exit("ui/index.html deve carregar o script com <script src='app.js' defer>")
+    page = minify_html(page.replace("src='app.js'", "src='%s'" % js_path))
+    html_raw, html_gz, html_hash = asset(page)
+
+    OUT.write_text(
+        "#pragma once\n"
+        "#include <Arduino.h>\n\n"
+        "// Gerado por tools/build_ui.py a partir de ui/. Não edite: altere as fontes e rode o script.\n\n"
+        "/**\n"
+        " * Arquivo do dashboard comprimido com gzip, servido direto da flash.\n"
+        " */\n"
+        "struct UiAsset {\n"
+        "    const char    *path;        // URL\n"
+        "    const char    *type;        // Content-Type\n"
+        "    const uint8_t *gz;          // Conteúdo (gzip, PROGMEM)\n"
+        "    size_t         len;\n"
+        "    const char    *etag;        // ETag forte (hash do conteúdo)\n"
+        "    bool           immutable;   // URL versionada: cache longo sem revalidar\n"
+        "};\n\n"
+        + c_array("ui_index_gz", html_gz) + "\n"
+        + c_array("ui_app_gz", js_gz) + "\n"
+        "static const UiAsset UI_ASSETS[] = {\n"
+        '    {"/", "text/html", ui_index_gz, sizeof(ui_index_gz), "\\"%s\\"", false},\n'
+        '    {"%s", "application/javascript", ui_app_gz, sizeof(ui_app_gz), "\\"%s\\"", true},\n'
+        "};\n" % (html_hash[:16], js_path, js_hash[:16]),
+        encoding="utf-8")
+
+    src_len = sum(len((UI / f).read_bytes()) for f in SCRIPTS + ["index.html"])
+    print("%s: fontes %d B, minificado %d B, gzip %d B (página %d + script %d)" % (
+        OUT.relative_to(ROOT), src_len, len(html_raw) + len(js_raw),
+        len(html_gz) + len(js_gz), len(html_gz), len(js_gz)))
+
+
+if __name__ == "__main__":
+    main()
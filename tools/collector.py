@@ -0,0 +1,273 @@
+#!/usr/bin/env python3
+"""Coletor de referência para o envio do log (main/uplink.h).
+
+Recebe os lotes do dispositivo por HTTP (POST em qualquer caminho) e/ou UDP
+(responde com o ACK de 16 bytes), descarta o que já recebeu, decodifica os
+blocos do log (main/logfmt.h) e grava, por dispositivo (MAC):
+
+    <out>/<mac>/log.bin      blocos crus, em ordem de endereço (mesmo formato do /download?format=bin)
+    <out>/<mac>/samples.csv  epoch_ms,c1_mv,...,total_mv,flags
+    <out>/<mac>/state.json   próximo endereço esperado, último lote e lacunas
+
+Os timestamps saem como gravados: amostras com a flag 0x10 (provisório,
+antes do NTP) ainda precisam das correções de /api/time do dispositivo.
+
+Só usa a biblioteca padrão. Para testar sem o ESP32 ou simular uma rede
+ruim, --drop descarta uma fração dos lotes e dos ACKs:
+
+    python3 tools/collector.py --http 8089 --udp 8089 --out coletor --drop 0.2
+"""
+import argparse
+import json
+import pathlib
+import random
+import socketserver
+import struct
+import sys
+import threading
+import zlib
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+
+UPL_MAGIC = 0x314C5055       # "UPL1"
+UPL_ACK_MAGIC = 0x4B415055   # "UPAK"
+UPL_VERSION = 1
+UPL_HEADER = struct.Struct("<IBBHQI6s6x")   # UplinkHeader, 32 bytes
+UPL_ACK = struct.Struct("<IIQ")             # UplinkAck, 16 bytes
+
+LOG_BLOCK_SIZE = 512
+LOG_BLOCK_MAGIC = 0x424C
+LOG_VERSION = 1
+LOG_HEADER = struct.Struct("<HBBHHQII")     # LogBlockHeader, 24 bytes
+RICE_MAX_Q = 12
+
+
+# --- Decodificador de um bloco (mesma lógica do LogBlockReader) ---
+
+class Bits:
+    def __init__(self, data):
+        self.value = int.from_bytes(data, "big")
+        self.cap = len(data) * 8
+        self.pos = 0
+
+    def get(self, n):
+        if self.pos + n > self.cap:
+            raise ValueError("payload truncado")
+        self.pos += n
+        return (self.value >> (self.cap - self.pos)) & ((1 << n) - 1)
+
+
+def zigzag(d):
+    return ((d << 1) ^ (d >> 31)) & 0xFFFFFFFF
+
+
+def unzigzag(z):
+    return (z >> 1) ^ -(z & 1)
+
+
+def rice_k(avg):
+    k = 0
+    while k < 15 and (1 << (k + 4)) <= avg:
+        k += 1
+    return k
+
+
+def rice_adapt(avg, z):
+    zq = 0xFFFF if z > 0x0FFF else z << 4
+    return (avg + ((zq - avg) >> 2)) & 0xFFFF
+
+
+def get_rice(bits, avg, raw_bits):
+    k = rice_k(avg)
+    q = 0
+    while q < RICE_MAX_Q and bits.get(1):
+        q += 1
+    if q == RICE_MAX_Q:
+        return bits.get(raw_bits), True
+    return (q << k) | bits.get(k), False
+
+
+def decode_block(block, cells):
+    """Registros (epoch_ms, [mv...], total, flags) de um bloco; [] se inválido."""
+    magic, version, bcells, count, plen, t0, span, crc = LOG_HEADER.unpack_from(block)
+    if magic != LOG_BLOCK_MAGIC or version != LOG_VERSION or plen > LOG_BLOCK_SIZE - LOG_HEADER.size:
+        return []
+    if (bcells or 4) != cells:
+        return []
+    payload = block[LOG_HEADER.size:LOG_HEADER.size + plen]
+    if zlib.crc32(payload) != crc:
+        return []
+
+    bits = Bits(payload)
+    adapt = [0] * (cells + 1)
+    out = []
+    t, dt, mv, flags = t0, 0, [0] * cells, 0
+    try:
+        for i in range(count):
+            if i == 0:
+                mv = [bits.get(16) for _ in range(cells)]
+            else:
+                z, _ = get_rice(bits, adapt[0], 32)
+                adapt[0] = rice_adapt(adapt[0], z)
+                dt += unzigzag(z)
+                t += dt
+                cur = []
+                for c in range(cells):
+                    v, escaped = get_rice(bits, adapt[c + 1], 16)
+                    n = v if escaped else (mv[c] + unzigzag(v)) & 0xFFFF
+                    adapt[c + 1] = rice_adapt(adapt[c + 1], zigzag(n - mv[c]))
+                    cur.append(n)
+                mv = cur
+            total = bits.get(16) if bits.get(1) else sum(mv) & 0xFFFF
+            if bits.get(1):
+                flags = bits.get(8)
+            out.append((t, mv, total, flags))
+    except ValueError:
+        pass   # Bloco corrompido depois do CRC: fica o que foi decodificado
+    return out
+
+
+# --- Armazenamento por dispositivo ---
+
+class Device:
+    def __init__(self, root, mac, cells):
+        self.dir = root / mac
+        self.dir.mkdir(parents=True, exist_ok=True)
+        self.cells = cells
+        self.state_path = self.dir / "state.json"
+        self.state = {"next": None, "seq": None, "gaps": 0, "lostBlocks": 0, "records": 0}
+        if self.state_path.exists():
+            self.state.update(json.loads(self.state_path.read_text()))
+        csv = self.dir / "samples.csv"
+        if not csv.exists():
+            cols = ["epoch_ms"] + ["c%d_mv" % (i + 1) for i in range(cells)] + ["total_mv", "flags"]
+            csv.write_text(",".join(cols) + "\n")
+
+    def ingest(self, addr, seq, data):
+        """Grava os blocos ainda não recebidos. Retorna (novos, registros)."""
+        blocks = len(data) // LOG_BLOCK_SIZE
+        end = addr + blocks * LOG_BLOCK_SIZE
+        nxt = self.state["next"]
+        if nxt is not None and end <= nxt:
+            return 0, 0   # Retransmissão (o ACK anterior se perdeu)
+        skip = 0
+        if nxt is not None and addr < nxt:
+            skip = (nxt - addr) // LOG_BLOCK_SIZE
+        elif nxt is not None and addr > nxt:
+            # O anel do dispositivo sobrescreveu blocos antes do envio.
+            lost = (addr - nxt) // LOG_BLOCK_SIZE
+            self.state["gaps"] += 1
+            self.state["lostBlocks"] += lost
+            print("  lacuna: %d blocos perdidos antes do endereço %d" % (lost, addr))
+
+        rows = []
+        with open(self.dir / "log.bin", "ab") as raw:
+            for b in range(skip, blocks):
+                block = data[b * LOG_BLOCK_SIZE:(b + 1) * LOG_BLOCK_SIZE]
+                raw.write(block)
+                for t, mv, total, flags in decode_block(block, self.cells):
+                    rows.append("%d,%s,%d,%d\n" % (t, ",".join(map(str, mv)), total, flags))
+        with open(self.dir / "samples.csv", "a") as csv:
+            csv.writelines(rows)
+
+        self.state.update(next=end, seq=seq, records=self.state["records"] + len(rows))
+        self.state_path.write_text(json.dumps(self.state))
+        return blocks - skip, len(rows)
+
+
+class Collector:
+    def __init__(self, root, drop):
+        self.root = pathlib.Path(root)
+        self.drop = drop
+        self.devices = {}
+        self.lock = threading.Lock()
+
+    def dropped(self):
+        return self.drop > 0 and random.random() < self.drop
+
+    def handle(self, body, via):
+        """Processa um lote. Retorna o ACK (bytes), None se inválido ou False se descartado."""
+        if len(body) < UPL_HEADER.size:
+            return None
+        magic, version, cells, blocks, addr, seq, mac = UPL_HEADER.unpack_from(body)
+        data = body[UPL_HEADER.size:]
+        if magic != UPL_MAGIC or version != UPL_VERSION or len(data) != blocks * LOG_BLOCK_SIZE:
+            print("lote inválido via %s (%d bytes)" % (via, len(body)), file=sys.stderr)
+            return None
+        if self.dropped():
+            print("lote %d descartado (--drop)" % seq)
+            return False
+        name = mac.hex(":")
+        with self.lock:
+            dev = self.devices.get(name)
+            if dev is None:
+                dev = self.devices[name] = Device(self.root, name.replace(":", ""), cells)
+            if cells != dev.cells:
+                print("%s: lote com %d células, esperado %d" % (name, cells, dev.cells), file=sys.stderr)
+                return None
+            new, rows = dev.ingest(addr, seq, data)
+        print("%s lote %d @%d via %s: %d blocos, %d novos, %d registros" % (
+            name, seq, addr, via, blocks, new, rows))
+        return UPL_ACK.pack(UPL_ACK_MAGIC, seq, addr + blocks * LOG_BLOCK_SIZE)
+
+
+def serve_http(collector, port):
+    class Handler(BaseHTTPRequestHandler):
+        def do_POST(self):
+            body = self.rfile.read(int(self.headers.get("Content-Length", 0)))
+            ack = collector.handle(body, "http")
+            if not ack or collector.dropped():
+                self.send_response(400 if ack is None else 503)
+                self.end_headers()
+                return
+            self.send_response(200)
+            self.send_header("Content-Type", "application/octet-stream")
+            self.send_header("Content-Length", str(len(ack)))
+            self.end_headers()
+            self.wfile.write(ack)
+
+        def log_message(self, *args):
+            pass
+
+    ThreadingHTTPServer(("", port), Handler).serve_forever()
+
+
+def serve_udp(collector, port):
+    class Handler(socketserver.BaseRequestHandler):
+        def handle(self):
+            body, sock = self.request
+            ack = collector.handle(body, "udp")
+            if ack and not collector.dropped():
+                sock.sendto(ack, self.client_address)
+
+    socketserver.UDPServer.max_packet_size = 65535
+    socketserver.UDPServer(("", port), Handler).serve_forever()
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("--http", type=int, default=8089, help="porta HTTP (0 = desligado)")
+    ap.add_argument("--udp", type=int, default=8089, help="porta UDP (0 = desligado)")
+    ap.add_argument("--out", default="coletor", help="diretório de saída")
+    ap.add_argument("--drop", type=float, default=0.0, help="fração de lotes e ACKs descartados (teste)")
+    args = ap.parse_args()
+
+    collector = Collector(args.out, args.drop)
+    threads = []
+    if args.http:
+        threads.append(threading.Thread(target=serve_http, args=(collector, args.http), daemon=True))
+    if args.udp:
+        threads.append(threading.Thread(target=serve_udp, args=(collector, args.udp), daemon=True))
+    if not threads:
+        sys.exit("nada a servir: use --http e/ou --udp")
+    for t in threads:
+        t.start()
+    print("coletor: http=%s udp=%s saída=%s" % (args.http or "-", args.udp or "-", args.out))
+    try:
+        for t in threads:
+            t.join()
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,701 @@
+/**
+ * logtool: análise dos logs do monitor no PC.
+ *
+ * Lê o CSV do download ("AAAA-MM-DD HH:MM:SS.mmm,c1_mv,c1_soc,...,total_mv"),
+ * o CSV antigo (hora "HH:MM:SS" sem data, com as voltas entre log_old.csv e
+ * log.csv) e os blocos binários do log (/download?format=bin ou o log.bin do
+ * tools/collector.py), e reconstrói uma linha do tempo contínua: a hora do
+ * CSV antigo ganha a data de --date e um dia a cada virada de meia-noite, e
+ * um X_old.csv vem antes do X.csv. Usa as mesmas definições do firmware
+ * (LogRecord e blocos de logfmt.h, curva OCV de ocv_table.h), então precisa
+ * ser compilado com o mesmo número de células do pack:
+ *
+ *     g++ -std=c++17 -O2 -pthread -DPACK_CELL_COUNT=4 tools/logtool.cpp main/logfmt.cpp -o logtool
+ *
+ * Os arquivos são mapeados em memória e divididos em trechos (quebrados em
+ * fim de linha, ou em blocos de 512 bytes no binário) processados em
+ * paralelo; o parser não aloca por linha, só o vetor de registros de cada
+ * trecho. A costura da linha do tempo é sequencial e só mexe nos timestamps.
+ *
+ * Comandos:
+ *     stats     linhas, período, lacunas e mín/máx/média/desvio por célula
+ *     timeline  trechos por arquivo, viradas de dia e lacunas
+ *     hist      histograma do desbalanceamento (maior - menor célula)
+ *     soc       curva de SoC por célula, média por intervalo (CSV)
+ *     convert   -o saida.bin (blocos do log) ou -o saida.csv (formato do download)
+ *     bench     só a leitura, repetida, com 1 e com -j threads
+ */
+#include "../main/logfmt.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+static constexpr uint64_t DAY_MS = 24 * 3600000ULL;
+static constexpr uint32_t DUP_STEP_MS = 500;          // Como RPL_DUP_STEP_MS: linhas repetidas no mesmo segundo
+static constexpr size_t CHUNK_BYTES = 4 << 20;        // Trecho de trabalho de cada thread
+static constexpr uint8_t ROW_DATELESS = 0x80;         // Só no logtool: linha "HH:MM:SS" sem data, até a costura
+static constexpr OcvTable<OcvActive> ocv{};
+
+// --- Datas (calendário civil, sem fuso: o CSV já vem na hora local do dispositivo) ---
+
+static int64_t daysFromCivil(int64_t y, unsigned m, unsigned d) {
+    y -= m <= 2;
+    const int64_t era = (y >= 0 ? y : y - 399) / 400;
+    const unsigned yoe = (unsigned)(y - era * 400);
+    const unsigned doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + (int64_t)doe - 719468;
+}
+
+static void civilFromDays(int64_t z, int &y, unsigned &m, unsigned &d) {
+    z += 719468;
+    const int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    const unsigned doe = (unsigned)(z - era * 146097);
+    const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const unsigned mp = (5 * doy + 2) / 153;
+    d = doy - (153 * mp + 2) / 5 + 1;
+    m = mp < 10 ? mp + 3 : mp - 9;
+    y = (int)(yoe + era * 400 + (m <= 2));
+}
+
+// "AAAA-MM-DD HH:MM:SS.mmm".
+static void formatTime(uint64_t ms, char (&out)[48]) {
+    int y;
+    unsigned mo, d;
+    civilFromDays((int64_t)(ms / DAY_MS), y, mo, d);
+    uint32_t t = (uint32_t)(ms % DAY_MS);
+    snprintf(out, sizeof(out), "%04d-%02u-%02u %02u:%02u:%02u.%03u", y, mo, d,
+        t / 3600000, t / 60000 % 60, t / 1000 % 60, t % 1000);
+}
+
+// --- Arquivos mapeados e trechos de trabalho ---
+
+enum InputKind : uint8_t { IN_CSV, IN_BIN };
+
+struct Input {
+    std::string path;
+    InputKind   kind = IN_CSV;
+    const char *data = nullptr;
+    size_t      len = 0;
+};
+
+struct Chunk {
+    uint32_t  input;
+    size_t    begin, end;
+    std::vector<LogRecord> rows;
+    uint32_t  bad = 0;   // Linhas inválidas (CSV) ou blocos inválidos/vazios (binário)
+};
+
+static bool mapInput(Input &in) {
+    int fd = open(in.path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return false;
+    }
+    in.len = (size_t)st.st_size;
+    if (in.len) {
+        void *p = mmap(nullptr, in.len, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) {
+            close(fd);
+            return false;
+        }
+        madvise(p, in.len, MADV_SEQUENTIAL);
+        in.data = (const char *)p;
+    }
+    close(fd);   // O mapeamento continua válido
+    size_t n = in.path.size();
+    in.kind = n > 4 && in.path.compare(n - 4, 4, ".bin") == 0 ? IN_BIN : IN_CSV;
+    return true;
+}
+
+// Divide um arquivo em trechos de ~CHUNK_BYTES que começam no início de uma linha (ou bloco).
+static void splitInput(const Input &in, uint32_t idx, std::vector<Chunk> &out) {
+    size_t pos = 0;
+    while (pos < in.len) {
+        size_t end = pos + CHUNK_BYTES;
+        if (end >= in.len) {
+            end = in.len;
+        } else if (in.kind == IN_BIN) {
+            end -= end % LOG_BLOCK_SIZE;
+        } else {
+            const char *nl = (const char *)memchr(in.data + end, '\n', in.len - end);
+            end = nl ? (size_t)(nl - in.data) + 1 : in.len;
+        }
+        Chunk c;
+        c.input = idx;
+        c.begin = pos;
+        c.end = end;
+        out.push_back(std::move(c));
+        pos = end;
+    }
+}
+
+// Um CSV de outro pack teria todas as linhas rejeitadas: avisa pelo cabeçalho.
+static void checkColumns(const Input &in) {
+    if (in.kind != IN_CSV || !in.len) return;
+    const char *nl = (const char *)memchr(in.data, '\n', in.len);
+    const char *end = nl ? nl : in.data + in.len;
+    unsigned cols = 1;
+    for (const char *p = in.data; p < end; p++) cols += *p == ',';
+    if (cols != 2u * PACK_CELLS + 2) {
+        fprintf(stderr, "%s: %u colunas, esperadas %u (logtool compilado para %u células, veja -DPACK_CELL_COUNT)\n",
+            in.path.c_str(), cols, 2u * PACK_CELLS + 2, (unsigned)PACK_CELLS);
+    }
+}
+
+// --- Parser do CSV (sem alocação: só ponteiros sobre o arquivo mapeado) ---
+
+static inline bool number(const char *&p, const char *end, uint32_t &v) {
+    if (p >= end || (unsigned)(*p - '0') > 9) return false;
+    v = 0;
+    while (p < end && (unsigned)(*p - '0') <= 9) v = v * 10 + (uint32_t)(*p++ - '0');
+    return true;
+}
+
+static inline bool expect(const char *&p, const char *end, char c) {
+    if (p >= end || *p != c) return false;
+    p++;
+    return true;
+}
+
+// Hora da linha: "HH:MM:SS" vira a hora do dia em ms e 'dateless' fica
+// ligado; com a data na frente, o timestamp completo (mesmo em 1970-01-01).
+static inline bool parseTime(const char *&p, const char *end, uint64_t &ms, bool &dateless) {
+    uint32_t a, mo, d, h, mi, s, frac = 0;
+    int64_t days = -1;
+    if (!number(p, end, a)) return false;
+    if (p < end && *p == '-') {
+        if (!expect(p, end, '-') || !number(p, end, mo) || !expect(p, end, '-') || !number(p, end, d) ||
+            !expect(p, end, ' ') || !number(p, end, h) || mo < 1 || mo > 12 || d < 1 || d > 31) return false;
+        days = daysFromCivil(a, mo, d);
+    } else {
+        h = a;
+    }
+    if (!expect(p, end, ':') || !number(p, end, mi) || !expect(p, end, ':') || !number(p, end, s)) return false;
+    if (p < end && *p == '.') {
+        p++;
+        if (!number(p, end, frac)) return false;
+    }
+    if (h > 23 || mi > 59 || s > 60 || frac > 999) return false;
+    ms = ((uint64_t)h * 3600 + mi * 60 + s) * 1000 + frac;
+    dateless = days < 0;
+    if (!dateless) ms += (uint64_t)days * DAY_MS;
+    return true;
+}
+
+// Uma linha "hora,c1_mv,c1_soc,...,cN_mv,cN_soc,total_mv". O SoC do arquivo
+// é ignorado: sai da mesma curva do firmware quando preciso.
+static inline bool parseRow(const char *p, const char *end, LogRecord &r) {
+    uint32_t v, soc;
+    bool dateless;
+    if (!parseTime(p, end, r.epochMs, dateless)) return false;
+    for (uint8_t i = 0; i < PACK_CELLS; i++) {
+        if (!expect(p, end, ',') || !number(p, end, v) || v > UINT16_MAX) return false;
+        if (!expect(p, end, ',') || !number(p, end, soc)) return false;
+        r.mv[i] = (uint16_t)v;
+    }
+    if (!expect(p, end, ',') || !number(p, end, v) || v > UINT16_MAX) return false;
+    r.total = (uint16_t)v;
+    r.flags = dateless ? ROW_DATELESS : 0;
+    return p == end;
+}
+
+static void parseCsv(const Input &in, Chunk &c) {
+    const char *p = in.data + c.begin, *end = in.data + c.end;
+    c.rows.reserve((c.end - c.begin) / (24 + 8 * PACK_CELLS));
+    LogRecord r;
+    while (p < end) {
+        const char *nl = (const char *)memchr(p, '\n', end - p);
+        const char *eol = nl ? nl : end;
+        const char *line = p;
+        p = nl ? nl + 1 : end;
+        if (eol > line && eol[-1] == '\r') eol--;
+        if (eol == line) continue;
+        if (parseRow(line, eol, r)) c.rows.push_back(r);
+        else if (!(c.begin == 0 && line == in.data)) c.bad++;   // A primeira linha do arquivo é o cabeçalho
+    }
+}
+
+static void parseBin(const Input &in, Chunk &c) {
+    c.rows.reserve((c.end - c.begin) / LOG_BLOCK_SIZE * 160);
+    LogBlockReader reader;
+    LogRecord r;
+    for (size_t off = c.begin; off + LOG_BLOCK_SIZE <= c.end; off += LOG_BLOCK_SIZE) {
+        if (!reader.open((const uint8_t *)in.data + off)) {
+            c.bad++;   // Apagado/sobrescrito (zeros), corrompido ou de outro pack
+            continue;
+        }
+        while (reader.next(r)) {
+            r.flags &= (uint8_t)~ROW_DATELESS;   // O binário sempre tem data (provisória desde 0 no 1º boot)
+            c.rows.push_back(r);
+        }
+    }
+    if ((c.end - c.begin) % LOG_BLOCK_SIZE) c.bad++;   // Bloco incompleto no fim
+}
+
+// Processa os trechos em 'threads' threads; cada uma pega o próximo trecho livre.
+static void parseAll(const std::vector<Input> &inputs, std::vector<Chunk> &chunks, unsigned threads) {
+    std::atomic<size_t> next{0};
+    auto work = [&]() {
+        for (size_t i; (i = next.fetch_add(1)) < chunks.size();) {
+            Chunk &c = chunks[i];
+            c.rows.clear();
+            c.bad = 0;
+            const Input &in = inputs[c.input];
+            if (in.kind == IN_BIN) parseBin(in, c);
+            else parseCsv(in, c);
+        }
+    };
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < threads; t++) pool.emplace_back(work);
+    work();
+    for (std::thread &t : pool) t.join();
+}
+
+// --- Linha do tempo ---
+
+struct Segment {           // Um arquivo na linha do tempo
+    uint32_t input;
+    size_t   first, count; // Faixa em Timeline::rows
+    uint32_t bad;
+    uint32_t midnights;    // Viradas de dia reconstruídas (CSV antigo)
+};
+
+struct Timeline {
+    std::vector<LogRecord> rows;
+    std::vector<Segment>   segs;
+    uint32_t backwards = 0;   // Timestamps que recuaram (blocos de outro boot, arquivos fora de ordem)
+};
+
+// Junta os trechos em ordem e resolve a hora sem data do CSV antigo (linhas
+// com ROW_DATELESS) com as regras da reprodução (replay.cpp): volta de mais
+// de 12 h = meia-noite, linhas repetidas no mesmo segundo espaçadas de
+// DUP_STEP_MS.
+static void stitch(std::vector<Chunk> &chunks, uint64_t baseMs, Timeline &tl) {
+    size_t total = 0;
+    for (const Chunk &c : chunks) total += c.rows.size();
+    tl.rows.clear();
+    tl.rows.reserve(total);
+    tl.segs.clear();
+
+    uint64_t dayOffset = baseMs, prevTod = 0, last = 0;
+    bool haveTod = false, haveLast = false;
+    for (Chunk &c : chunks) {
+        if (tl.segs.empty() || tl.segs.back().input != c.input)
+            tl.segs.push_back(Segment{c.input, tl.rows.size(), 0, 0, 0});
+        Segment &seg = tl.segs.back();
+        seg.bad += c.bad;
+        for (LogRecord r : c.rows) {
+            if (r.flags & ROW_DATELESS) {
+                r.flags &= (uint8_t)~ROW_DATELESS;
+                uint64_t tod = r.epochMs;
+                if (haveTod && tod + DAY_MS / 2 < prevTod) {
+                    dayOffset += DAY_MS;
+                    seg.midnights++;
+                }
+                prevTod = tod;
+                haveTod = true;
+                r.epochMs = dayOffset + tod;
+                if (haveLast && r.epochMs <= last && r.epochMs + 1000 > last) r.epochMs = last + DUP_STEP_MS;
+            }
+            if (haveLast && r.epochMs < last) tl.backwards++;
+            last = r.epochMs;
+            haveLast = true;
+            tl.rows.push_back(r);
+        }
+        seg.count = tl.rows.size() - seg.first;
+        std::vector<LogRecord>().swap(c.rows);   // Libera o trecho já copiado
+    }
+}
+
+// X_old.csv (ou .bin) vem antes de X.csv: o firmware antigo girava log.csv em log_old.csv.
+static void orderRotated(std::vector<std::string> &paths) {
+    for (size_t i = 0; i < paths.size(); i++) {
+        const std::string &p = paths[i];
+        size_t dot = p.rfind('.');
+        if (dot == std::string::npos || dot < 4 || p.compare(dot - 4, 4, "_old") != 0) continue;
+        std::string sibling = p.substr(0, dot - 4) + p.substr(dot);
+        for (size_t j = 0; j < i; j++) {
+            if (paths[j] != sibling) continue;
+            std::string old = p;
+            paths.erase(paths.begin() + i);
+            paths.insert(paths.begin() + j, old);
+            break;
+        }
+    }
+}
+
+// --- Comandos ---
+
+struct Options {
+    std::string cmd, out;
+    std::vector<std::string> paths;
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    uint64_t baseMs = 0;      // --date: dia do CSV sem data
+    uint32_t gapSec = 10;     // --gap: intervalo que conta como lacuna
+    uint32_t binMv = 5;       // --bin: largura do balde do histograma
+    uint32_t stepSec = 60;    // --step: intervalo da curva de SoC
+    uint32_t repeat = 5;      // --repeat: passadas do bench
+};
+
+struct Cell {   // Acumulador de Welford
+    uint16_t min = UINT16_MAX, max = 0;
+    double   mean = 0, m2 = 0;
+    void add(uint16_t v, uint64_t n) {
+        if (v < min) min = v;
+        if (v > max) max = v;
+        double d = v - mean;
+        mean += d / (double)n;
+        m2 += d * (v - mean);
+    }
+};
+
+static void imbalance(const LogRecord &r, uint16_t &lo, uint16_t &hi, uint8_t &loCell) {
+    lo = hi = r.mv[0];
+    loCell = 0;
+    for (uint8_t i = 1; i < PACK_CELLS; i++) {
+        if (r.mv[i] < lo) { lo = r.mv[i]; loCell = i; }
+        if (r.mv[i] > hi) hi = r.mv[i];
+    }
+}
+
+static void printDuration(uint64_t ms) {
+    uint64_t s = ms / 1000;
+    if (s >= 86400) printf("%llu d ", (unsigned long long)(s / 86400));
+    if (s >= 3600) printf("%llu h ", (unsigned long long)(s / 3600 % 24));
+    printf("%llu min %llu s", (unsigned long long)(s / 60 % 60), (unsigned long long)(s % 60));
+}
+
+static int cmdStats(const Options &o, const Timeline &tl) {
+    const std::vector<LogRecord> &rows = tl.rows;
+    uint32_t bad = 0, midnights = 0;
+    for (const Segment &s : tl.segs) {
+        bad += s.bad;
+        midnights += s.midnights;
+    }
+    printf("linhas: %zu (%u inválidas) de %zu arquivo(s)\n", rows.size(), bad, tl.segs.size());
+    if (rows.empty()) return 1;
+
+    Cell cell[PACK_CELLS], total, imb;
+    uint64_t n = 0, gaps = 0, maxGap = 0, prov = 0, replay = 0, range = 0, partial = 0;
+    for (size_t k = 0; k < rows.size(); k++) {
+        const LogRecord &r = rows[k];
+        n++;
+        for (uint8_t i = 0; i < PACK_CELLS; i++) cell[i].add(r.mv[i], n);
+        total.add(r.total, n);
+        uint16_t lo, hi;
+        uint8_t loCell;
+        imbalance(r, lo, hi, loCell);
+        imb.add(hi - lo, n);
+        if (k && r.epochMs > rows[k - 1].epochMs) {
+            uint64_t dt = r.epochMs - rows[k - 1].epochMs;
+            if (dt > maxGap) maxGap = dt;
+            if (dt > (uint64_t)o.gapSec * 1000) gaps++;
+        }
+        prov += (r.flags & SAMPLE_FLAG_PROVISIONAL) != 0;
+        replay += (r.flags & SAMPLE_FLAG_REPLAY) != 0;
+        range += (r.flags & SAMPLE_FLAG_RANGE) != 0;
+        partial += (r.flags & SAMPLE_FLAG_PARTIAL) != 0;
+    }
+
+    char a[48], b[48];
+    const uint64_t t0 = rows.front().epochMs, t1 = rows.back().epochMs;
+    formatTime(t0, a);
+    formatTime(t1, b);
+    printf("período: %s -> %s (", a, b);
+    printDuration(t1 - t0);
+    printf(")\n");
+    printf("taxa média: %.2f amostras/s; lacunas > %u s: %llu (maior %.1f s); viradas de dia: %u; recuos: %u\n",
+        t1 > t0 ? (rows.size() - 1) * 1000.0 / (double)(t1 - t0) : 0.0, o.gapSec,
+        (unsigned long long)gaps, maxGap / 1000.0, midnights, tl.backwards);
+    printf("\n             mín     máx     média   desvio  SoC ini  SoC fim\n");
+    for (uint8_t i = 0; i < PACK_CELLS; i++) {
+        char name[8];
+        snprintf(name, sizeof(name), "c%u", (unsigned)(i + 1));
+        printf("%-8s %7u %7u %9.1f %8.1f %7u%% %7u%%\n", name, cell[i].min, cell[i].max, cell[i].mean,
+            sqrt(cell[i].m2 / (double)n), ocv.soc(rows.front().mv[i]), ocv.soc(rows.back().mv[i]));
+    }
+    printf("%-8s %7u %7u %9.1f %8.1f\n", "total", total.min, total.max, total.mean, sqrt(total.m2 / (double)n));
+    printf("%-8s %7u %7u %9.1f %8.1f\n", "desbal.", imb.min, imb.max, imb.mean, sqrt(imb.m2 / (double)n));
+    if (prov || replay || range || partial) {
+        printf("\nflags: provisório %llu, reprodução %llu, fora de faixa %llu, parcial %llu\n",
+            (unsigned long long)prov, (unsigned long long)replay, (unsigned long long)range,
+            (unsigned long long)partial);
+    }
+    return 0;
+}
+
+static int cmdTimeline(const Options &o, const std::vector<Input> &inputs, const Timeline &tl) {
+    const std::vector<LogRecord> &rows = tl.rows;
+    char a[48], b[48];
+    for (const Segment &s : tl.segs) {
+        printf("%s: %zu linhas", inputs[s.input].path.c_str(), s.count);
+        if (s.bad) printf(", %u %s", s.bad, inputs[s.input].kind == IN_BIN ? "blocos inválidos" : "linhas inválidas");
+        if (s.count) {
+            formatTime(rows[s.first].epochMs, a);
+            formatTime(rows[s.first + s.count - 1].epochMs, b);
+            printf(", %s -> %s", a, b);
+        }
+        if (s.midnights) printf(", %u virada(s) de dia", s.midnights);
+        printf("\n");
+    }
+    uint32_t shown = 0, gaps = 0;
+    for (size_t k = 1; k < rows.size(); k++) {
+        if (rows[k].epochMs <= rows[k - 1].epochMs + (uint64_t)o.gapSec * 1000) continue;
+        gaps++;
+        if (shown++ >= 20) continue;
+        formatTime(rows[k - 1].epochMs, a);
+        printf("  lacuna de ");
+        printDuration(rows[k].epochMs - rows[k - 1].epochMs);
+        printf(" após %s\n", a);
+    }
+    if (shown > 20) printf("  ... e mais %u lacunas\n", shown - 20);
+    printf("%zu linhas, %u lacunas > %u s, %u recuos\n", rows.size(), gaps, o.gapSec, tl.backwards);
+    return 0;
+}
+
+static int cmdHist(const Options &o, const Timeline &tl) {
+    if (tl.rows.empty()) return 1;
+    const uint32_t width = o.binMv ? o.binMv : 1;
+    std::vector<uint64_t> bins;
+    uint64_t lowest[PACK_CELLS] = {0};
+    for (const LogRecord &r : tl.rows) {
+        uint16_t lo, hi;
+        uint8_t loCell;
+        imbalance(r, lo, hi, loCell);
+        size_t b = (hi - lo) / width;
+        if (b >= bins.size()) bins.resize(b + 1, 0);
+        bins[b]++;
+        lowest[loCell]++;
+    }
+    const double n = (double)tl.rows.size();
+    uint64_t peak = *std::max_element(bins.begin(), bins.end());
+    printf("desbalanceamento (maior - menor célula), baldes de %u mV:\n", width);
+    for (size_t b = 0; b < bins.size(); b++) {
+        if (!bins[b]) continue;
+        printf("%5zu-%-5zu mV %10llu %6.2f%% ", b * width, (b + 1) * width - 1, (unsigned long long)bins[b],
+            100.0 * bins[b] / n);
+        for (uint64_t k = 0; k < bins[b] * 40 / peak; k++) fputs("#", stdout);
+        printf("\n");
+    }
+    const double q[] = {0.5, 0.95, 0.99};
+    uint64_t acc = 0;
+    size_t qi = 0, b = 0;
+    printf("percentis:");
+    for (; b < bins.size() && qi < 3; b++) {
+        acc += bins[b];
+        while (qi < 3 && acc >= q[qi] * n) printf(" p%g < %zu mV", q[qi++] * 100, (b + 1) * width);
+    }
+    printf("\ncélula mais baixa:");
+    for (uint8_t i = 0; i < PACK_CELLS; i++) printf(" c%u %.1f%%", (unsigned)(i + 1), 100.0 * lowest[i] / n);
+    printf("\n");
+    return 0;
+}
+
+static int cmdSoc(const Options &o, const Timeline &tl) {
+    const uint64_t step = (uint64_t)(o.stepSec ? o.stepSec : 1) * 1000;
+    printf("hora");
+    for (uint8_t i = 0; i < PACK_CELLS; i++) printf(",c%u_soc", (unsigned)(i + 1));
+    printf(",pack_soc\n");
+    uint64_t sum[PACK_CELLS] = {0}, count = 0, bucket = 0;
+    auto flush = [&]() {
+        if (!count) return;
+        char t[48];
+        formatTime(bucket, t);
+        printf("%s", t);
+        uint8_t pack = 100;
+        for (uint8_t i = 0; i < PACK_CELLS; i++) {
+            uint8_t soc = ocv.soc((uint16_t)((sum[i] + count / 2) / count));
+            if (soc < pack) pack = soc;   // O pack acaba quando a célula mais fraca acaba
+            printf(",%u", soc);
+            sum[i] = 0;
+        }
+        printf(",%u\n", pack);
+        count = 0;
+    };
+    for (const LogRecord &r : tl.rows) {
+        uint64_t b = r.epochMs - r.epochMs % step;
+        if (count && b != bucket) flush();
+        bucket = b;
+        for (uint8_t i = 0; i < PACK_CELLS; i++) sum[i] += r.mv[i];
+        count++;
+    }
+    flush();
+    return 0;
+}
+
+static int writeBin(FILE *f, const Timeline &tl) {
+    LogBlockWriter w;
+    w.reset();
+    uint8_t block[LOG_BLOCK_SIZE];
+    size_t blocks = 0;
+    for (const LogRecord &r : tl.rows) {
+        if (w.append(r)) continue;
+        // Bloco cheio (ou timestamp que recuou): fecha e começa outro.
+        if (!w.empty()) {
+            w.finish(block);
+            fwrite(block, 1, sizeof(block), f);
+            blocks++;
+        }
+        w.reset();
+        w.append(r);
+    }
+    if (!w.empty()) {
+        w.finish(block);
+        fwrite(block, 1, sizeof(block), f);
+        blocks++;
+    }
+    fprintf(stderr, "%zu registros em %zu blocos (%.2f bytes/registro)\n", tl.rows.size(), blocks,
+        tl.rows.empty() ? 0.0 : blocks * (double)LOG_BLOCK_SIZE / tl.rows.size());
+    return 0;
+}
+
+static int writeCsv(FILE *f, const Timeline &tl) {
+    fprintf(f, "hora");
+    for (uint8_t i = 0; i < PACK_CELLS; i++) fprintf(f, ",c%u_mv,c%u_soc", (unsigned)(i + 1), (unsigned)(i + 1));
+    fprintf(f, ",total_mv\n");
+    char t[48];
+    for (const LogRecord &r : tl.rows) {
+        formatTime(r.epochMs, t);
+        fputs(t, f);
+        for (uint8_t i = 0; i < PACK_CELLS; i++) fprintf(f, ",%u,%u", r.mv[i], ocv.soc(r.mv[i]));
+        fprintf(f, ",%u\n", r.total);
+    }
+    return 0;
+}
+
+static int cmdConvert(const Options &o, const Timeline &tl) {
+    if (o.out.empty()) {
+        fprintf(stderr, "convert: informe a saída com -o arquivo.bin ou -o arquivo.csv\n");
+        return 2;
+    }
+    FILE *f = fopen(o.out.c_str(), "wb");
+    if (!f) {
+        perror(o.out.c_str());
+        return 1;
+    }
+    static char buf[1 << 20];
+    setvbuf(f, buf, _IOFBF, sizeof(buf));
+    bool bin = o.out.size() > 4 && o.out.compare(o.out.size() - 4, 4, ".bin") == 0;
+    int rc = bin ? writeBin(f, tl) : writeCsv(f, tl);
+    if (fclose(f) != 0) {
+        perror(o.out.c_str());
+        return 1;
+    }
+    return rc;
+}
+
+// Tempo de leitura (parse) de todos os arquivos, em ms.
+static double timeParse(const std::vector<Input> &inputs, std::vector<Chunk> &chunks, unsigned threads) {
+    auto t0 = std::chrono::steady_clock::now();
+    parseAll(inputs, chunks, threads);
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+}
+
+static int cmdBench(const Options &o, const std::vector<Input> &inputs, std::vector<Chunk> &chunks) {
+    size_t bytes = 0;
+    for (const Input &in : inputs) bytes += in.len;
+    std::vector<unsigned> counts = {1};
+    if (o.threads > 1) counts.push_back(o.threads);
+    for (unsigned t : counts) {
+        double best = 1e300;
+        size_t rows = 0;
+        for (uint32_t k = 0; k < (o.repeat ? o.repeat : 1); k++) {
+            best = std::min(best, timeParse(inputs, chunks, t));
+        }
+        for (const Chunk &c : chunks) rows += c.rows.size();
+        printf("%2u thread(s): %zu linhas em %.2f ms (melhor de %u) = %.2f M linhas/s, %.0f MB/s\n", t, rows,
+            best, o.repeat, rows / best / 1000.0, bytes / best / 1000.0);
+    }
+    return 0;
+}
+
+static void usage() {
+    fprintf(stderr,
+        "uso: logtool <stats|timeline|hist|soc|convert|bench> [opções] arquivos...\n"
+        "  -j N           threads (padrão: núcleos da máquina)\n"
+        "  --date AAAA-MM-DD  dia da primeira linha do CSV sem data (padrão 1970-01-01)\n"
+        "  --gap S        lacuna mínima em segundos (stats/timeline, padrão 10)\n"
+        "  --bin MV       largura do balde do histograma (hist, padrão 5)\n"
+        "  --step S       intervalo da curva de SoC (soc, padrão 60)\n"
+        "  -o ARQ         saída do convert (.bin = blocos do log, senão CSV do download)\n"
+        "  --repeat N     passadas do bench (padrão 5)\n"
+        "Compilado para %u células (-DPACK_CELL_COUNT).\n", (unsigned)PACK_CELLS);
+}
+
+static bool parseArgs(int argc, char **argv, Options &o) {
+    if (argc < 2) return false;
+    o.cmd = argv[1];
+    static const char *const cmds[] = {"stats", "timeline", "hist", "soc", "convert", "bench"};
+    if (std::none_of(std::begin(cmds), std::end(cmds), [&](const char *c) { return o.cmd == c; })) return false;
+    for (int i = 2; i < argc; i++) {
+        std::string a = argv[i];
+        auto value = [&]() -> const char * { return i + 1 < argc ? argv[++i] : nullptr; };
+        const char *v = nullptr;
+        if (a == "-j" && (v = value())) o.threads = std::max(1, atoi(v));
+        else if (a == "--gap" && (v = value())) o.gapSec = (uint32_t)atoi(v);
+        else if (a == "--bin" && (v = value())) o.binMv = (uint32_t)atoi(v);
+        else if (a == "--step" && (v = value())) o.stepSec = (uint32_t)atoi(v);
+        else if (a == "--repeat" && (v = value())) o.repeat = (uint32_t)atoi(v);
+        else if (a == "-o" && (v = value())) o.out = v;
+        else if (a == "--date" && (v = value())) {
+            unsigned y, m, d;
+            if (sscanf(v, "%u-%u-%u", &y, &m, &d) != 3) return false;
+            o.baseMs = (uint64_t)daysFromCivil(y, m, d) * DAY_MS;
+        } else if (a.size() > 1 && a[0] == '-') {
+            return false;
+        } else {
+            o.paths.push_back(a);
+        }
+    }
+    return !o.paths.empty();
+}
+
+int main(int argc, char **argv) {
+    Options o;
+    if (!parseArgs(argc, argv, o)) {
+        usage();
+        return 2;
+    }
+    orderRotated(o.paths);
+
+    std::vector<Input> inputs(o.paths.size());
+    std::vector<Chunk> chunks;
+    for (size_t i = 0; i < o.paths.size(); i++) {
+        inputs[i].path = o.paths[i];
+        if (!mapInput(inputs[i])) {
+            perror(o.paths[i].c_str());
+            return 1;
+        }
+        splitInput(inputs[i], (uint32_t)i, chunks);
+        checkColumns(inputs[i]);
+    }
+
+    if (o.cmd == "bench") return cmdBench(o, inputs, chunks);
+
+    double ms = timeParse(inputs, chunks, o.threads);
+    Timeline tl;
+    stitch(chunks, o.baseMs, tl);
+    fprintf(stderr, "%zu linhas de %zu arquivo(s) em %.1f ms (%.2f M linhas/s, %u threads)\n",
+        tl.rows.size(), inputs.size(), ms, tl.rows.size() / ms / 1000.0, o.threads);
+
+    if (o.cmd == "stats") return cmdStats(o, tl);
+    if (o.cmd == "timeline") return cmdTimeline(o, inputs, tl);
+    if (o.cmd == "hist") return cmdHist(o, tl);
+    if (o.cmd == "soc") return cmdSoc(o, tl);
+    return cmdConvert(o, tl);   // parseArgs só aceita os comandos acima
+}
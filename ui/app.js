@@ -0,0 +1,108 @@
+const tabMon=document.getElementById('tabMon'),tabSet=document.getElementById('tabSet');
+const paneMon=document.getElementById('paneMon'),paneSet=document.getElementById('paneSet');
+function show(p){paneMon.classList.toggle('active',p==='mon');paneSet.classList.toggle('active',p==='set');tabMon.classList.toggle('active',p==='mon');tabSet.classList.toggle('active',p==='set');}
+tabMon.onclick=()=>show('mon'); tabSet.onclick=()=>show('set');
+let selectedCell = 0;
+function selectCell(c){selectedCell = c; updateGraph();}
+// Cartões e campos de calibração seguem o número de células do dispositivo
+// (campo 'cells' do quadro binário ou tamanho de 'v' no JSON).
+let cells=0, hist=[];
+function build(n){
+    if(n===cells) return;
+    cells=n; hist=Array.from({length:n+1},()=>[]); labels.length=0; selectedCell=0;
+    const cards=document.getElementById('cards'), tot=document.getElementById('cardTot');
+    cards.querySelectorAll('.cell').forEach(e=>e.remove());
+    let inp='';
+    for(let i=0;i<n;i++){
+        const c=document.createElement('div');
+        c.className='card cell'; c.onclick=()=>selectCell(i);
+        c.innerHTML=`C${i+1}<div class='battery' id='batt${i}'></div><span id='v${i}'>-</span> V | <span id='soc${i}'>-</span>%`;
+        cards.insertBefore(c,tot);
+        inp+=`<div>🔋 C${i+1} <input id='in${i}'> V</div>`;
+    }
+    tot.onclick=()=>selectCell(n);
+    document.getElementById('inputs').innerHTML=inp;
+    renderAlarms();
+}
+// Alarmes ativos: lidos de /api/alarms na conexão e atualizados pelos eventos
+// {"type":"alarm"} do WebSocket. O dV/dt informa a célula que mais variou,
+// mas é um alarme só; os de célula têm um por célula.
+const ALARM_NAMES={cell_under:'Subtensão',cell_over:'Sobretensão',imbalance:'Desbalanceamento',dvdt:'Variação rápida',pack_under:'Pack baixo',pack_over:'Pack alto'};
+const alarms=new Map();
+function alarmEvent(a){
+    const key=a.kind.startsWith('cell_')?a.kind+a.cell:a.kind;
+    if(a.active) alarms.set(key,a); else alarms.delete(key);
+    renderAlarms();
+}
+function renderAlarms(){
+    const list=[...alarms.values()];
+    document.getElementById('alarms').innerHTML=list.map(a=>
+        `<div>⚠️ ${ALARM_NAMES[a.kind]||a.kind}${a.cell===undefined?'':' C'+(a.cell+1)}: ${a.value} ${a.kind==='dvdt'?'mV/s':'mV'} desde ${new Date(a.t).toLocaleTimeString()}</div>`).join('');
+    document.querySelectorAll('.card.cell').forEach((c,i)=>c.classList.toggle('alarm',list.some(a=>a.kind.startsWith('cell_')&&a.cell===i)));
+}
+const chart = new MiniChart(document.getElementById('graph'), {data:{labels:[],datasets:[{label:'Célula',data:[],borderWidth:2,borderColor:'#2196F3'}]},options:{scales:{y:{min:3,max:4.3}}}});
+const labels=[]; const MAX_PTS=600;
+let ws=new WebSocket('ws://'+location.hostname+'/ws');
+ws.binaryType='arraybuffer';
+ws.onopen=()=>{
+    ws.send(JSON.stringify({fmt:'bin',hz:0}));
+    fetch('/api/alarms?n=0').then(r=>r.json()).then(d=>{alarms.clear();d.active.forEach(alarmEvent);renderAlarms();}).catch(()=>{});
+};
+function addSample(ms,mv,soc,tot){
+    labels.push(new Date(ms).toLocaleTimeString());
+    if(labels.length>MAX_PTS) labels.shift();
+    mv.forEach((m,i)=>{
+        const v=m/1000;
+        document.getElementById('v'+i).textContent = v.toFixed(3);
+        document.getElementById('soc'+i).textContent = soc[i];
+        updateBattery('batt'+i, v, soc[i]);
+        hist[i].push(v);
+        if(hist[i].length>MAX_PTS) hist[i].shift();
+    });
+    const total=tot/1000;
+    document.getElementById('tot').textContent=total.toFixed(3);
+    updateBattery('battTot',total, null, true);
+    hist[cells].push(total);
+    if(hist[cells].length>MAX_PTS) hist[cells].shift();
+}
+// Quadro binário: [tipo u8, células u8, n u16] + n x (12 + 3 x células) bytes
+// (t u64, mv u16[células], soc u8[células], total u16, flags, 0)
+// Tipo 1 = amostras novas; tipo 2 = histórico recente, enviado ao pedir binário.
+ws.onmessage=e=>{
+    if(typeof e.data==='string'){
+        const d=JSON.parse(e.data);
+        if(d.type==='alarm'){ alarmEvent(d); return; }
+        build(d.v.length);
+        addSample(Date.now(), d.v, d.soc, d.tot);
+    } else {
+        const dv=new DataView(e.data), c=dv.getUint8(1), n=dv.getUint16(2,true), idx=[...Array(c).keys()];
+        build(c);
+        if(dv.getUint8(0)===2){ labels.length=0; hist.forEach(h=>h.length=0); }
+        for(let k=0,o=4;k<n;k++,o+=12+3*c){
+            const ms=dv.getUint32(o,true)+dv.getUint32(o+4,true)*4294967296;
+            const mv=idx.map(i=>dv.getUint16(o+8+2*i,true));
+            const soc=idx.map(i=>dv.getUint8(o+8+2*c+i));
+            addSample(ms, mv, soc, dv.getUint16(o+8+3*c,true));
+        }
+    }
+    updateGraph();
+};
+
+function updateBattery(id, v, soc, isTotal=false){
+    let p;
+    if (isTotal) {
+        const min=3.2*cells, max=4.2*cells;
+        p = Math.max(0, Math.min(1, (v-min)/(max-min)));
+    } else {
+        p = soc / 100.0;
+    }
+    const b=document.getElementById(id);
+    b.style.setProperty('--level',(p*100)+'%');
+    let c;
+    const vpc=isTotal?v/cells:v;
+    if(vpc>=3.7)c='#4caf50';else if(vpc>=3.5)c='#ffc107';else c='#f44336';
+    b.style.setProperty('--batt-color',c);
+}
+function updateGraph(){chart.data.labels=[...labels];const t=selectedCell===cells,n=t?'Total':'C'+(selectedCell+1);chart.data.datasets[0].label=n+' (V)';chart.data.datasets[0].data=[...hist[selectedCell]];chart.options.scales.y=t?{min:3*cells,max:4.2*cells}:{min:3,max:4.3};chart.update();}
+function calib(){const v=[...Array(cells).keys()].map(i=>parseFloat(document.getElementById('in'+i).value)*1000||0);const p=JSON.stringify({v});const done=r=>r.text().then(t=>alert("Resposta: "+t));const poll=()=>fetch('/api/calibrate').then(r=>r.status===202?new Promise(ok=>setTimeout(ok,500)).then(poll):done(r));fetch('/api/calibrate',{method:'POST',headers:{'Content-Type':'application/json'},body:p}).then(r=>r.status===202?poll():done(r)).catch(e=>alert("Erro: "+e));}
+function clearLog(){fetch('/api/clear_logs',{method:'POST'});}
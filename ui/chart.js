@@ -0,0 +1,71 @@
+// Gráfico de linha mínimo em canvas 2D, no lugar do Chart.js da CDN (a página
+// precisa funcionar numa rede sem internet). Cobre só o que o dashboard usa:
+// uma série, eixo y com faixa fixa, sem animação, e a mesma forma de uso:
+// chart.data.datasets[0].{label,data}, chart.options.scales.y.{min,max} e
+// chart.update().
+class MiniChart {
+    constructor(canvas, cfg) {
+        this.canvas = canvas;
+        this.ctx = canvas.getContext('2d');
+        this.data = cfg.data;
+        this.options = cfg.options || {scales: {y: {}}};
+        window.addEventListener('resize', () => this.update());
+    }
+
+    update() {
+        const c = this.canvas, ctx = this.ctx, dpr = window.devicePixelRatio || 1;
+        const w = c.clientWidth, h = c.clientHeight;
+        if (c.width !== Math.round(w * dpr) || c.height !== Math.round(h * dpr)) {
+            c.width = Math.round(w * dpr);
+            c.height = Math.round(h * dpr);
+        }
+        ctx.setTransform(dpr, 0, 0, dpr, 0, 0);
+        ctx.clearRect(0, 0, w, h);
+
+        const ds = this.data.datasets[0], ys = ds.data, y = this.options.scales.y || {};
+        let lo = y.min, hi = y.max;
+        if (lo === undefined || hi === undefined) {
+            lo = Math.min(...ys);
+            hi = Math.max(...ys);
+        }
+        if (!(hi > lo)) { lo -= 1; hi += 1; }
+
+        // Área do gráfico: margem à esquerda para a escala, em cima para a legenda.
+        const L = 44, T = 18, R = 6, B = 6, pw = w - L - R, ph = h - T - B;
+        ctx.font = '11px sans-serif';
+        ctx.lineWidth = 1;
+        ctx.strokeStyle = '#e0e0e0';
+        ctx.fillStyle = '#666';
+        ctx.textAlign = 'right';
+        ctx.textBaseline = 'middle';
+        for (let i = 0; i <= 4; i++) {
+            const py = T + ph - ph * i / 4;
+            ctx.beginPath();
+            ctx.moveTo(L, py);
+            ctx.lineTo(L + pw, py);
+            ctx.stroke();
+            ctx.fillText((lo + (hi - lo) * i / 4).toFixed(2), L - 4, py);
+        }
+        ctx.textAlign = 'center';
+        ctx.textBaseline = 'top';
+        ctx.fillStyle = '#333';
+        ctx.fillText(ds.label || '', L + pw / 2, 2);
+        if (ys.length < 2) return;
+
+        ctx.save();
+        ctx.beginPath();
+        ctx.rect(L, T, pw, ph);
+        ctx.clip();
+        const sx = pw / (ys.length - 1), sy = ph / (hi - lo);
+        ctx.beginPath();
+        ys.forEach((v, i) => {
+            const px = L + i * sx, py = T + ph - (v - lo) * sy;
+            if (i) ctx.lineTo(px, py); else ctx.moveTo(px, py);
+        });
+        ctx.strokeStyle = ds.borderColor || '#2196F3';
+        ctx.lineWidth = ds.borderWidth || 2;
+        ctx.lineJoin = 'round';
+        ctx.stroke();
+        ctx.restore();
+    }
+}